@@ -0,0 +1,80 @@
+#pragma once
+
+//vendor
+#include <SDL3/SDL.h>
+#include <glad/glad/gl.h>
+
+
+struct BenchmarkSettings
+{
+    unsigned int warmupFrameCount = 60;
+    unsigned int frameCount = 600;
+    unsigned int spriteCount = 10000;
+    unsigned int instanceCount = 50000;
+    unsigned int shaderProgramCount = 32;
+    unsigned int drawCount = 10000;
+    unsigned int entityCount = 100000;
+
+#ifdef _WIN32
+    const char* fontPath = "C:/Windows/Fonts/segoeui.ttf";
+    const char* cjkFontPath = "C:/Windows/Fonts/msyh.ttc";
+#else
+    const char* fontPath = "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf";
+    const char* cjkFontPath = "/usr/share/fonts/opentype/noto/NotoSansCJK-Regular.ttc";
+#endif
+};
+
+struct BenchmarkResult
+{
+    const char* name;
+    double averageFrameMs;
+    double averageUploadMs;
+};
+
+namespace BenchmarkFunctions
+{
+    static GLuint CompileShader(GLenum p_type, const char* p_source)
+    {
+        GLuint shader = glCreateShader(p_type);
+        glShaderSource(shader, 1, &p_source, nullptr);
+        glCompileShader(shader);
+
+        GLint status = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+
+        if (status == GL_FALSE)
+        {
+            char log[1024];
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            SDL_Log("Benchmark shader failed to compile : %s", log);
+        }
+
+        return shader;
+    }
+
+    static GLuint CreateProgram(const char* p_vertexSource, const char* p_fragmentSource)
+    {
+        GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, p_vertexSource);
+        GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, p_fragmentSource);
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        glLinkProgram(program);
+
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        return program;
+    }
+
+    static double NanosecondsToMilliseconds(Uint64 p_nanoseconds)
+    {
+        return static_cast<double>(p_nanoseconds) / 1000000.0;
+    }
+
+    static void LogResult(const BenchmarkResult& p_result)
+    {
+        SDL_Log("%-24s frame %8.3f ms   upload %8.3f ms", p_result.name, p_result.averageFrameMs, p_result.averageUploadMs);
+    }
+}
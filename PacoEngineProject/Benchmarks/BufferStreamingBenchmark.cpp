@@ -0,0 +1,226 @@
+#include "BufferStreamingBenchmark.h"
+
+//std
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+//engine
+#include "Rendering/RenderComponent.h"
+#include "Rendering/StreamingRenderComponent.h"
+
+
+namespace
+{
+    enum class StreamingMode
+    {
+        SubData,
+        Orphaning,
+        PersistentRing
+    };
+
+    struct StreamedSpriteVertex
+    {
+        float x, y;
+        float r, g, b, a;
+
+        static const std::array<VertexAttribute, 2> attributes;
+    };
+
+    constexpr std::array<VertexAttribute, 2> StreamedSpriteVertex::attributes =
+    {{
+        { 0, 2, GL_FLOAT, GL_FALSE, offsetof(StreamedSpriteVertex, x) },
+        { 1, 4, GL_FLOAT, GL_FALSE, offsetof(StreamedSpriteVertex, r) },
+    }};
+
+    const char* streamedSpriteVertexShader = R"(
+        #version 450 core
+        layout(location = 0) in vec2 a_position;
+        layout(location = 1) in vec4 a_color;
+        out vec4 v_color;
+        void main()
+        {
+            v_color = a_color;
+            gl_Position = vec4(a_position, 0.0, 1.0);
+        }
+    )";
+
+    const char* streamedSpriteFragmentShader = R"(
+        #version 450 core
+        in vec4 v_color;
+        out vec4 o_color;
+        void main()
+        {
+            o_color = v_color;
+        }
+    )";
+
+    //Moves every sprite a little each frame so the driver cannot skip any upload
+    void FillSprites(std::vector<StreamedSpriteVertex>& p_vertices, std::vector<unsigned int>& p_indices, unsigned int p_spriteCount, unsigned int p_frame)
+    {
+        const float spriteSize = 0.01f;
+
+        for (unsigned int sprite = 0; sprite < p_spriteCount; sprite++)
+        {
+            float phase = static_cast<float>(sprite) * 0.37f + static_cast<float>(p_frame) * 0.05f;
+            float x = std::sin(phase) * 0.9f;
+            float y = std::cos(phase * 1.3f) * 0.9f;
+            float shade = static_cast<float>(sprite % 255) / 255.0f;
+
+            StreamedSpriteVertex* vertex = &p_vertices[sprite * 4];
+            vertex[0] = { x,              y,              shade, 0.5f, 1.0f - shade, 1.0f };
+            vertex[1] = { x + spriteSize, y,              shade, 0.5f, 1.0f - shade, 1.0f };
+            vertex[2] = { x + spriteSize, y + spriteSize, shade, 0.5f, 1.0f - shade, 1.0f };
+            vertex[3] = { x,              y + spriteSize, shade, 0.5f, 1.0f - shade, 1.0f };
+
+            unsigned int firstVertex = sprite * 4;
+            unsigned int* index = &p_indices[sprite * 6];
+            index[0] = firstVertex;
+            index[1] = firstVertex + 1;
+            index[2] = firstVertex + 2;
+            index[3] = firstVertex + 2;
+            index[4] = firstVertex + 3;
+            index[5] = firstVertex;
+        }
+    }
+
+    BenchmarkResult RunMode(SDL_Window* p_window, const BenchmarkSettings& p_settings, StreamingMode p_mode, GLuint p_program)
+    {
+        const unsigned int vertexCount = p_settings.spriteCount * 4;
+        const unsigned int indexCount = p_settings.spriteCount * 6;
+        const GLsizeiptr vertexBytes = sizeof(StreamedSpriteVertex) * vertexCount;
+
+        std::vector<StreamedSpriteVertex> vertices(vertexCount);
+        std::vector<unsigned int> indices(indexCount);
+
+        RenderComponent renderComponent = {};
+        StreamingRenderComponent streamingComponent = {};
+
+        if (p_mode == StreamingMode::PersistentRing)
+        {
+            StreamingRenderComponentFunctions::Create<StreamedSpriteVertex>(streamingComponent, vertexCount, indexCount);
+            RenderComponentFunctions::SetAttributeFormats<StreamedSpriteVertex>(streamingComponent.renderComponent);
+        }
+        else
+        {
+            RenderComponentFunctions::Create(renderComponent);
+
+            if (p_mode == StreamingMode::SubData)
+            {
+                RenderComponentFunctions::PreallocateBuffersMemory<StreamedSpriteVertex>(renderComponent, vertexCount, indexCount);
+            }
+            else
+            {
+                glNamedBufferData(renderComponent.vbo, vertexBytes, nullptr, GL_STREAM_DRAW);
+                glNamedBufferData(renderComponent.ebo, sizeof(unsigned int) * indexCount, nullptr, GL_STREAM_DRAW);
+            }
+
+            RenderComponentFunctions::SetAttributeFormats<StreamedSpriteVertex>(renderComponent);
+            RenderComponentFunctions::LinkBuffers<StreamedSpriteVertex>(renderComponent, vertexCount);
+        }
+
+        GLStateCache stateCache;
+        GLStateCacheFunctions::Create(stateCache);
+
+        GLStateCacheFunctions::UseProgram(stateCache, p_program);
+        glFinish();
+
+        Uint64 totalFrameNs = 0;
+        Uint64 totalUploadNs = 0;
+
+        const unsigned int totalFrames = p_settings.warmupFrameCount + p_settings.frameCount;
+
+        for (unsigned int frame = 0; frame < totalFrames; frame++)
+        {
+            SDL_PumpEvents();
+
+            FillSprites(vertices, indices, p_settings.spriteCount, frame);
+
+            Uint64 frameStart = SDL_GetTicksNS();
+
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            GLintptr indexOffset = 0;
+
+            if (p_mode == StreamingMode::PersistentRing)
+            {
+                StreamingRenderComponentFunctions::BeginFrame(streamingComponent);
+                StreamingRenderComponentFunctions::UpdateVertexBufferData<StreamedSpriteVertex>(streamingComponent, vertices.data(), vertexCount);
+                indexOffset = StreamingRenderComponentFunctions::UpdateIndexBufferData(streamingComponent, indices.data(), indexCount);
+            }
+            else
+            {
+                if (p_mode == StreamingMode::Orphaning)
+                {
+                    glNamedBufferData(renderComponent.vbo, vertexBytes, nullptr, GL_STREAM_DRAW);
+                    glNamedBufferData(renderComponent.ebo, sizeof(unsigned int) * indexCount, nullptr, GL_STREAM_DRAW);
+                }
+
+                RenderComponentFunctions::UpdateVertexBufferData<StreamedSpriteVertex>(renderComponent, vertices.data(), vertexCount);
+                RenderComponentFunctions::UpdateIndexBufferData(renderComponent, indices.data(), indexCount);
+            }
+
+            Uint64 uploadEnd = SDL_GetTicksNS();
+
+            RenderComponent& drawnComponent = p_mode == StreamingMode::PersistentRing ? streamingComponent.renderComponent : renderComponent;
+
+            RenderComponentFunctions::Bind(drawnComponent, stateCache);
+            glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, reinterpret_cast<const void*>(indexOffset));
+
+            if (p_mode == StreamingMode::PersistentRing)
+            {
+                StreamingRenderComponentFunctions::EndFrame(streamingComponent);
+            }
+
+            SDL_GL_SwapWindow(p_window);
+
+            Uint64 frameEnd = SDL_GetTicksNS();
+
+            if (frame >= p_settings.warmupFrameCount)
+            {
+                totalFrameNs += frameEnd - frameStart;
+                totalUploadNs += uploadEnd - frameStart;
+            }
+        }
+
+        glFinish();
+
+        BenchmarkResult result = {};
+        result.averageFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalFrameNs) / p_settings.frameCount;
+        result.averageUploadMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalUploadNs) / p_settings.frameCount;
+
+        if (p_mode == StreamingMode::PersistentRing)
+        {
+            SDL_Log("Persistent ring stalled on a fence %u times", streamingComponent.vertexStream.stallCount + streamingComponent.indexStream.stallCount);
+            StreamingRenderComponentFunctions::Delete(streamingComponent);
+        }
+        else
+        {
+            RenderComponentFunctions::Delete(renderComponent);
+        }
+
+        return result;
+    }
+}
+
+void RunBufferStreamingBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Buffer streaming benchmark : %u sprites, %u frames", p_settings.spriteCount, p_settings.frameCount);
+
+    GLuint program = BenchmarkFunctions::CreateProgram(streamedSpriteVertexShader, streamedSpriteFragmentShader);
+
+    BenchmarkResult subData = RunMode(p_window, p_settings, StreamingMode::SubData, program);
+    subData.name = "glNamedBufferSubData";
+    BenchmarkFunctions::LogResult(subData);
+
+    BenchmarkResult orphaning = RunMode(p_window, p_settings, StreamingMode::Orphaning, program);
+    orphaning.name = "Orphaning";
+    BenchmarkFunctions::LogResult(orphaning);
+
+    BenchmarkResult persistentRing = RunMode(p_window, p_settings, StreamingMode::PersistentRing, program);
+    persistentRing.name = "Persistent ring";
+    BenchmarkFunctions::LogResult(persistentRing);
+
+    glDeleteProgram(program);
+}
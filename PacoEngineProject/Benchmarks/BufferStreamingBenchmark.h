@@ -0,0 +1,9 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Streams p_settings.spriteCount quads every frame through glNamedBufferSubData, buffer orphaning
+//and the persistently mapped StreamingRenderComponent, then logs the average cost of each path
+void RunBufferStreamingBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings);
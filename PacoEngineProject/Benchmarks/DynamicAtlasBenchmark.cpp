@@ -0,0 +1,184 @@
+#include "DynamicAtlasBenchmark.h"
+
+//std
+#include <vector>
+
+//engine
+#include "Rendering/DynamicAtlas.h"
+#include "Rendering/TextureArrayAtlas.h"
+
+
+namespace
+{
+    const unsigned int iconCount = 4096;
+    const unsigned int visibleIconCount = 384;
+    const GLsizei pageSize = 1024;
+    const unsigned int pageCount = 2;
+
+    struct Icon
+    {
+        GLsizei width;
+        GLsizei height;
+        std::vector<uint8_t> pixels;
+    };
+
+    struct DynamicAtlasResult
+    {
+        const char* name;
+        double averageFrameMs;
+        double worstFrameMs;
+    };
+
+    std::vector<Icon> CreateIcons()
+    {
+        std::vector<Icon> icons(iconCount);
+        uint32_t noise = 0x9E3779B9u;
+
+        for (unsigned int icon = 0; icon < iconCount; icon++)
+        {
+            noise = noise * 1664525u + 1013904223u;
+            icons[icon].width = 16 + static_cast<GLsizei>((noise >> 8) % 49);
+            icons[icon].height = 16 + static_cast<GLsizei>((noise >> 16) % 49);
+            icons[icon].pixels.assign(static_cast<size_t>(icons[icon].width) * icons[icon].height * 4, static_cast<uint8_t>(icon));
+        }
+
+        return icons;
+    }
+
+    //The visible window moves by a few icons every frame and jumps back to the start at the end of the list
+    unsigned int GetFirstVisibleIcon(unsigned int p_frame)
+    {
+        return (p_frame * 3) % (iconCount - visibleIconCount);
+    }
+
+    DynamicAtlasResult RunRebuild(SDL_Window* p_window, const BenchmarkSettings& p_settings, const std::vector<Icon>& p_icons)
+    {
+        DynamicAtlasResult result = { "Rebuild TextureArrayAtlas", 0.0, 0.0 };
+
+        TextureArrayAtlas atlas;
+        unsigned int builtFirstIcon = UINT32_MAX;
+        Uint64 totalNs = 0;
+        Uint64 worstNs = 0;
+
+        for (unsigned int frame = 0; frame < p_settings.warmupFrameCount + p_settings.frameCount; frame++)
+        {
+            SDL_PumpEvents();
+
+            Uint64 frameStart = SDL_GetTicksNS();
+
+            unsigned int firstIcon = GetFirstVisibleIcon(frame);
+
+            if (firstIcon != builtFirstIcon)
+            {
+                TextureArrayAtlasFunctions::Delete(atlas);
+                TextureArrayAtlasFunctions::Create(atlas, pageSize, pageSize, static_cast<GLsizei>(pageCount));
+
+                TextureAtlasRegion region;
+
+                for (unsigned int icon = firstIcon; icon < firstIcon + visibleIconCount; icon++)
+                {
+                    TextureArrayAtlasFunctions::Add(atlas, p_icons[icon].pixels.data(), p_icons[icon].width, p_icons[icon].height, region);
+                }
+
+                builtFirstIcon = firstIcon;
+            }
+
+            glClear(GL_COLOR_BUFFER_BIT);
+            SDL_GL_SwapWindow(p_window);
+
+            Uint64 frameNs = SDL_GetTicksNS() - frameStart;
+
+            if (frame >= p_settings.warmupFrameCount)
+            {
+                totalNs += frameNs;
+                worstNs = frameNs > worstNs ? frameNs : worstNs;
+            }
+        }
+
+        glFinish();
+        TextureArrayAtlasFunctions::Delete(atlas);
+
+        result.averageFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalNs) / p_settings.frameCount;
+        result.worstFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(worstNs);
+
+        return result;
+    }
+
+    DynamicAtlasResult RunDynamic(SDL_Window* p_window, const BenchmarkSettings& p_settings, const std::vector<Icon>& p_icons)
+    {
+        DynamicAtlasResult result = { "DynamicAtlas", 0.0, 0.0 };
+
+        DynamicAtlas atlas;
+
+        if (!DynamicAtlasFunctions::Create(atlas, pageSize, pageCount))
+        {
+            return result;
+        }
+
+        std::vector<DynamicAtlasHandle> handles(iconCount);
+        unsigned int missingCount = 0;
+        Uint64 totalNs = 0;
+        Uint64 worstNs = 0;
+
+        for (unsigned int frame = 0; frame < p_settings.warmupFrameCount + p_settings.frameCount; frame++)
+        {
+            SDL_PumpEvents();
+
+            Uint64 frameStart = SDL_GetTicksNS();
+
+            DynamicAtlasFunctions::Update(atlas);
+
+            unsigned int firstIcon = GetFirstVisibleIcon(frame);
+            TextureAtlasRegion region;
+
+            for (unsigned int icon = firstIcon; icon < firstIcon + visibleIconCount; icon++)
+            {
+                if (!DynamicAtlasFunctions::GetRegion(atlas, handles[icon], region)
+                    && !DynamicAtlasFunctions::Insert(atlas, p_icons[icon].pixels.data(), p_icons[icon].width, p_icons[icon].height, handles[icon]))
+                {
+                    missingCount++;
+                }
+            }
+
+            glClear(GL_COLOR_BUFFER_BIT);
+            SDL_GL_SwapWindow(p_window);
+
+            Uint64 frameNs = SDL_GetTicksNS() - frameStart;
+
+            if (frame >= p_settings.warmupFrameCount)
+            {
+                totalNs += frameNs;
+                worstNs = frameNs > worstNs ? frameNs : worstNs;
+            }
+        }
+
+        glFinish();
+
+        DynamicAtlasStats stats = DynamicAtlasFunctions::GetStats(atlas);
+        SDL_Log("%u regions, %u inserts, %u failed, %u evicted, %u repacks, %u icons missing a frame, %.1f%% live %.1f%% dead",
+            stats.regionCount, stats.insertCount, stats.failedInsertCount, stats.evictedCount, stats.repackCount, missingCount,
+            100.0 * static_cast<double>(stats.liveArea) / static_cast<double>(stats.totalArea), 100.0 * static_cast<double>(stats.deadArea) / static_cast<double>(stats.totalArea));
+
+        DynamicAtlasFunctions::Delete(atlas);
+
+        result.averageFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalNs) / p_settings.frameCount;
+        result.worstFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(worstNs);
+
+        return result;
+    }
+
+    void LogResult(const DynamicAtlasResult& p_result)
+    {
+        SDL_Log("%-26s frame %8.3f ms   worst frame %8.3f ms", p_result.name, p_result.averageFrameMs, p_result.worstFrameMs);
+    }
+}
+
+void RunDynamicAtlasBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Dynamic atlas benchmark : %u of %u icons visible, %u pages of %d", visibleIconCount, iconCount, pageCount, pageSize);
+
+    std::vector<Icon> icons = CreateIcons();
+
+    LogResult(RunRebuild(p_window, p_settings, icons));
+    LogResult(RunDynamic(p_window, p_settings, icons));
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Scrolls through a list of icons of varied sizes, only the visible ones being in an atlas, once rebuilding a
+//TextureArrayAtlas whenever the visible set changes and once keeping a DynamicAtlas up to date, and logs the
+//average and worst frame for both along with the DynamicAtlas evictions and repacks
+void RunDynamicAtlasBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings);
@@ -0,0 +1,68 @@
+#include "FontAtlasBenchmark.h"
+
+//std
+#include <string>
+#include <thread>
+
+//engine
+#include "Text/FontAtlas.h"
+
+
+namespace
+{
+    //Latin-1, what a UI needs before any on-demand glyph
+    FontAtlasSettings CreateSettings()
+    {
+        FontAtlasSettings settings;
+        settings.lastCodepoint = 255;
+
+        return settings;
+    }
+
+    bool RunLoad(const char* p_name, const char* p_fontPath, const char* p_cacheDirectory, unsigned int p_threadCount)
+    {
+        FontAtlas atlas;
+
+        if (!FontAtlasFunctions::Load(atlas, p_fontPath, CreateSettings(), p_cacheDirectory, p_threadCount))
+        {
+            return false;
+        }
+
+        SDL_Log("%-24s %8.3f ms   %zu glyphs %zu kerning pairs in %dx%d%s", p_name, BenchmarkFunctions::NanosecondsToMilliseconds(atlas.loadNs),
+            atlas.glyphs.size(), atlas.kernings.size(), atlas.width, atlas.height, atlas.isLoadedFromCache ? ", from cache" : "");
+
+        FontAtlasFunctions::Delete(atlas);
+
+        return true;
+    }
+}
+
+void RunFontAtlasBenchmark(const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Font atlas benchmark : %s", p_settings.fontPath);
+
+    MappedFile fontFile;
+
+    if (!MappedFileFunctions::Open(fontFile, p_settings.fontPath))
+    {
+        SDL_Log("Font %s not found, pass one with --font", p_settings.fontPath);
+        return;
+    }
+
+    char* prefPath = SDL_GetPrefPath("PacoEngine", "Benchmarks");
+    std::string cacheDirectory = std::string(prefPath != nullptr ? prefPath : "") + "Fonts";
+    SDL_free(prefPath);
+
+    //The cold run must bake
+    SDL_RemovePath(FontAtlasFunctions::GetCachePath(cacheDirectory.c_str(), FontAtlasFunctions::ComputeKey(fontFile.data, fontFile.size, CreateSettings())).c_str());
+    MappedFileFunctions::Close(fontFile);
+
+    std::string parallelName = "Bake on " + std::to_string(std::thread::hardware_concurrency()) + " threads";
+
+    if (RunLoad("Bake on 1 thread", p_settings.fontPath, nullptr, 1))
+    {
+        RunLoad(parallelName.c_str(), p_settings.fontPath, nullptr, 0);
+        RunLoad("Cold cache", p_settings.fontPath, cacheDirectory.c_str(), 0);
+        RunLoad("Warm cache", p_settings.fontPath, cacheDirectory.c_str(), 0);
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Bakes the MSDF atlas of p_settings.fontPath on one thread and on every core, then loads it through the
+//disk cache once cold and once warm, and logs the time each took
+void RunFontAtlasBenchmark(const BenchmarkSettings& p_settings);
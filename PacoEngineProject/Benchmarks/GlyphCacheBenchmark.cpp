@@ -0,0 +1,219 @@
+#include "GlyphCacheBenchmark.h"
+
+//std
+#include <algorithm>
+#include <string>
+#include <vector>
+
+//engine
+#include "Text/GlyphCache.h"
+
+
+namespace
+{
+    const unsigned int stringsPerFrame = 40;
+    const unsigned int charactersPerString = 16;
+    const unsigned int estimateGlyphCount = 200;
+    const Uint64 frameBudgetNs = 16666666;
+
+    //Ideographs of the font, or every codepoint of the Basic Multilingual Plane it maps when it has too few of them
+    std::vector<uint32_t> FindCodepoints(const stbtt_fontinfo& p_font)
+    {
+        std::vector<uint32_t> codepoints;
+
+        for (uint32_t codepoint = 0x4E00; codepoint <= 0x9FFF; codepoint++)
+        {
+            if (stbtt_FindGlyphIndex(&p_font, static_cast<int>(codepoint)) != 0)
+            {
+                codepoints.push_back(codepoint);
+            }
+        }
+
+        if (codepoints.size() < 1000)
+        {
+            codepoints.clear();
+
+            for (uint32_t codepoint = 0x21; codepoint <= 0xFFFF; codepoint++)
+            {
+                if (stbtt_FindGlyphIndex(&p_font, static_cast<int>(codepoint)) != 0)
+                {
+                    codepoints.push_back(codepoint);
+                }
+            }
+        }
+
+        return codepoints;
+    }
+
+    void AppendUtf8(std::string& p_text, uint32_t p_codepoint)
+    {
+        if (p_codepoint < 0x80)
+        {
+            p_text += static_cast<char>(p_codepoint);
+        }
+        else if (p_codepoint < 0x800)
+        {
+            p_text += static_cast<char>(0xC0 | (p_codepoint >> 6));
+            p_text += static_cast<char>(0x80 | (p_codepoint & 0x3F));
+        }
+        else
+        {
+            p_text += static_cast<char>(0xE0 | (p_codepoint >> 12));
+            p_text += static_cast<char>(0x80 | ((p_codepoint >> 6) & 0x3F));
+            p_text += static_cast<char>(0x80 | (p_codepoint & 0x3F));
+        }
+    }
+
+    //Characters follow a Zipf distribution like words of real text, a few thousand cover almost everything drawn
+    struct ZipfSampler
+    {
+        std::vector<double> cumulativeWeights;
+        uint32_t noise = 0x9E3779B9u;
+    };
+
+    void CreateSampler(ZipfSampler& p_sampler, size_t p_count)
+    {
+        double total = 0.0;
+
+        for (size_t rank = 0; rank < p_count; rank++)
+        {
+            total += 1.0 / static_cast<double>(rank + 1);
+            p_sampler.cumulativeWeights.push_back(total);
+        }
+    }
+
+    size_t Sample(ZipfSampler& p_sampler)
+    {
+        p_sampler.noise = p_sampler.noise * 1664525u + 1013904223u;
+        double value = static_cast<double>(p_sampler.noise) / 4294967296.0 * p_sampler.cumulativeWeights.back();
+
+        auto found = std::upper_bound(p_sampler.cumulativeWeights.begin(), p_sampler.cumulativeWeights.end(), value);
+
+        return std::min(static_cast<size_t>(found - p_sampler.cumulativeWeights.begin()), p_sampler.cumulativeWeights.size() - 1);
+    }
+
+    void EstimateBakeAll(const stbtt_fontinfo& p_font, const std::vector<uint32_t>& p_codepoints)
+    {
+        FontAtlasSettings fontSettings;
+        FontBakedGlyph bakedGlyph;
+        unsigned int bakedCount = std::min(estimateGlyphCount, static_cast<unsigned int>(p_codepoints.size()));
+
+        Uint64 start = SDL_GetTicksNS();
+
+        for (unsigned int glyph = 0; glyph < bakedCount; glyph++)
+        {
+            FontAtlasFunctions::BakeGlyph(p_font, p_codepoints[glyph * p_codepoints.size() / bakedCount], fontSettings, bakedGlyph);
+        }
+
+        double glyphMs = BenchmarkFunctions::NanosecondsToMilliseconds(SDL_GetTicksNS() - start) / bakedCount;
+
+        SDL_Log("%-24s %8.3f s    %zu glyphs on one thread, %.3f ms each", "Bake all up front", glyphMs * p_codepoints.size() / 1000.0, p_codepoints.size(), glyphMs);
+    }
+
+    void RunCache(const char* p_name, const BenchmarkSettings& p_settings, const std::vector<uint32_t>& p_codepoints, size_t p_budgetBytes)
+    {
+        GlyphCache cache;
+
+        if (!GlyphCacheFunctions::Create(cache, p_settings.cjkFontPath, FontAtlasSettings{}, p_budgetBytes, 256, 4))
+        {
+            return;
+        }
+
+        ZipfSampler sampler;
+        CreateSampler(sampler, p_codepoints.size());
+
+        std::vector<std::string> strings(stringsPerFrame);
+        Uint64 totalNs = 0;
+        Uint64 worstFrameNs = 0;
+        unsigned long long hitCount = 0;
+        unsigned long long lookupCount = 0;
+        unsigned int completeFrame = 0;
+        bool isComplete = false;
+
+        for (unsigned int frame = 0; frame < p_settings.frameCount; frame++)
+        {
+            //A quarter of the strings change every frame, the others stay on screen
+            for (unsigned int string = frame == 0 ? 0 : frame % 4; string < stringsPerFrame; string += frame == 0 ? 1 : 4)
+            {
+                strings[string].clear();
+
+                for (unsigned int character = 0; character < charactersPerString; character++)
+                {
+                    AppendUtf8(strings[string], p_codepoints[Sample(sampler)]);
+                }
+            }
+
+            Uint64 frameStart = SDL_GetTicksNS();
+
+            GlyphCacheFunctions::Update(cache);
+
+            for (const std::string& string : strings)
+            {
+                GlyphCacheFunctions::RequestText(cache, string);
+            }
+
+            Uint64 frameNs = SDL_GetTicksNS() - frameStart;
+
+            //Update closes the stats of the previous frame
+            const GlyphCacheStats& stats = GlyphCacheFunctions::GetStats(cache);
+            hitCount += stats.hitCount;
+            lookupCount += stats.hitCount + stats.missCount;
+
+            if (frame > 0 && !isComplete && stats.missCount == 0)
+            {
+                completeFrame = frame - 1;
+                isComplete = true;
+            }
+
+            totalNs += frameNs;
+            worstFrameNs = std::max(worstFrameNs, frameNs);
+
+            //Workers get the rest of a 60 Hz frame, as they would while the render thread waits on the GPU
+            if (frameNs < frameBudgetNs)
+            {
+                SDL_DelayNS(frameBudgetNs - frameNs);
+            }
+        }
+
+        GlyphCacheFunctions::Update(cache);
+        const GlyphCacheStats& stats = GlyphCacheFunctions::GetStats(cache);
+
+        SDL_Log("%-24s frame %8.3f ms   worst %8.3f ms   hit rate %5.1f%%   first complete frame %u", p_name,
+            BenchmarkFunctions::NanosecondsToMilliseconds(totalNs) / std::max(p_settings.frameCount, 1u), BenchmarkFunctions::NanosecondsToMilliseconds(worstFrameNs),
+            lookupCount > 0 ? 100.0 * hitCount / lookupCount : 100.0, completeFrame);
+        SDL_Log("%-24s latency %8.3f ms   max %8.3f ms   %u rasterized   %u resident   %u failed   %u pages evicted", "",
+            BenchmarkFunctions::NanosecondsToMilliseconds(stats.averageLatencyNs), BenchmarkFunctions::NanosecondsToMilliseconds(stats.maxLatencyNs),
+            stats.rasterizedCount, stats.residentGlyphCount, stats.failedGlyphCount, stats.evictedPageCount);
+
+        GlyphCacheFunctions::Destroy(cache);
+    }
+}
+
+void RunGlyphCacheBenchmark(const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Glyph cache benchmark : %s", p_settings.cjkFontPath);
+
+    MappedFile fontFile;
+    stbtt_fontinfo font = {};
+
+    if (!MappedFileFunctions::Open(fontFile, p_settings.cjkFontPath))
+    {
+        SDL_Log("Font %s not found, pass one with --cjk-font", p_settings.cjkFontPath);
+        return;
+    }
+
+    if (!stbtt_InitFont(&font, fontFile.data, stbtt_GetFontOffsetForIndex(fontFile.data, 0)))
+    {
+        SDL_Log("Failed to parse font %s", p_settings.cjkFontPath);
+        MappedFileFunctions::Close(fontFile);
+        return;
+    }
+
+    std::vector<uint32_t> codepoints = FindCodepoints(font);
+
+    EstimateBakeAll(font, codepoints);
+    MappedFileFunctions::Close(fontFile);
+
+    RunCache("Cache of 16 MB", p_settings, codepoints, 16 * 1024 * 1024);
+    RunCache("Cache of 2 MB", p_settings, codepoints, 2 * 1024 * 1024);
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Estimates baking every CJK ideograph of p_settings.cjkFontPath up front, then draws text with characters of skewed
+//frequency through a GlyphCache with a large and a small budget at 60 frames per second, and logs the render thread
+//cost per frame, the hit rate, the frames until the text is complete, the rasterization latency and the evictions
+void RunGlyphCacheBenchmark(const BenchmarkSettings& p_settings);
@@ -0,0 +1,172 @@
+#include "InstancingBenchmark.h"
+
+//std
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//engine
+#include "Rendering/GLStateCache.h"
+#include "Rendering/InstancedRenderComponent.h"
+#include "Rendering/RenderComponent.h"
+
+
+namespace
+{
+    struct QuadVertex
+    {
+        float x, y;
+
+        static const std::array<VertexAttribute, 1> attributes;
+    };
+
+    constexpr std::array<VertexAttribute, 1> QuadVertex::attributes =
+    {{
+        { 0, 2, GL_FLOAT, GL_FALSE, offsetof(QuadVertex, x) },
+    }};
+
+    const QuadVertex quadVertices[4] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+    const uint16_t quadIndices[6] = { 0, 1, 2, 2, 3, 0 };
+
+    //Both paths share the shader, the per-draw path feeds the instance attributes as constant vertex attributes
+    const char* instanceVertexShader = R"(
+        #version 450 core
+        layout(location = 0) in vec2 a_position;
+        layout(location = 4) in vec4 a_positionScale;
+        layout(location = 5) in float a_rotation;
+        layout(location = 6) in vec4 a_color;
+        out vec4 v_color;
+        void main()
+        {
+            float s = sin(a_rotation);
+            float c = cos(a_rotation);
+            vec2 local = a_position * a_positionScale.zw;
+            v_color = a_color;
+            gl_Position = vec4(a_positionScale.xy + vec2(local.x * c - local.y * s, local.x * s + local.y * c), 0.0, 1.0);
+        }
+    )";
+
+    const char* instanceFragmentShader = R"(
+        #version 450 core
+        in vec4 v_color;
+        out vec4 o_color;
+        void main()
+        {
+            o_color = v_color;
+        }
+    )";
+
+    void FillInstances(std::vector<QuadInstance>& p_instances, unsigned int p_frame)
+    {
+        const float quadSize = 0.005f;
+
+        for (unsigned int instance = 0; instance < p_instances.size(); instance++)
+        {
+            float phase = static_cast<float>(instance) * 0.37f + static_cast<float>(p_frame) * 0.05f;
+            float shade = static_cast<float>(instance % 255) / 255.0f;
+
+            p_instances[instance] = { std::sin(phase) * 0.9f, std::cos(phase * 1.3f) * 0.9f, quadSize, quadSize, phase, shade, 0.5f, 1.0f - shade, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f };
+        }
+    }
+
+    BenchmarkResult RunMode(SDL_Window* p_window, const BenchmarkSettings& p_settings, bool p_isInstanced, GLuint p_program)
+    {
+        std::vector<QuadInstance> instances(p_settings.instanceCount);
+
+        InstancedRenderComponent instancedComponent;
+        InstancedRenderComponentFunctions::Create<QuadVertex, QuadInstance>(instancedComponent, quadVertices, 4, quadIndices, 6, p_settings.instanceCount);
+
+        GLStateCache stateCache;
+        GLStateCacheFunctions::Create(stateCache);
+        GLStateCacheFunctions::UseProgram(stateCache, p_program);
+
+        RenderComponent& renderComponent = instancedComponent.renderComponent;
+
+        //The per-draw path reads the instance attributes from glVertexAttrib, not from the instance buffer
+        if (!p_isInstanced)
+        {
+            for (const VertexAttribute& attribute : QuadInstance::attributes)
+            {
+                glDisableVertexArrayAttrib(renderComponent.vao, attribute.index);
+            }
+        }
+
+        glFinish();
+
+        Uint64 totalFrameNs = 0;
+        Uint64 totalSubmitNs = 0;
+
+        const unsigned int totalFrames = p_settings.warmupFrameCount + p_settings.frameCount;
+
+        for (unsigned int frame = 0; frame < totalFrames; frame++)
+        {
+            SDL_PumpEvents();
+
+            FillInstances(instances, frame);
+
+            Uint64 frameStart = SDL_GetTicksNS();
+
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            if (p_isInstanced)
+            {
+                InstancedRenderComponentFunctions::UpdateInstances(instancedComponent, instances.data(), p_settings.instanceCount);
+                InstancedRenderComponentFunctions::Draw(instancedComponent, stateCache, 6);
+            }
+            else
+            {
+                RenderComponentFunctions::Bind(renderComponent, stateCache);
+
+                for (const QuadInstance& instance : instances)
+                {
+                    glVertexAttrib4f(4, instance.x, instance.y, instance.scaleX, instance.scaleY);
+                    glVertexAttrib1f(5, instance.rotation);
+                    glVertexAttrib4f(6, instance.r, instance.g, instance.b, instance.a);
+                    RenderComponentFunctions::DrawElements(renderComponent, 6);
+                }
+            }
+
+            Uint64 submitEnd = SDL_GetTicksNS();
+
+            SDL_GL_SwapWindow(p_window);
+
+            Uint64 frameEnd = SDL_GetTicksNS();
+
+            if (frame >= p_settings.warmupFrameCount)
+            {
+                totalFrameNs += frameEnd - frameStart;
+                totalSubmitNs += submitEnd - frameStart;
+            }
+        }
+
+        glFinish();
+
+        BenchmarkResult result = {};
+        result.averageFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalFrameNs) / p_settings.frameCount;
+        result.averageUploadMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalSubmitNs) / p_settings.frameCount;
+
+        RenderComponentFunctions::Unbind(stateCache);
+        InstancedRenderComponentFunctions::Delete(instancedComponent);
+
+        return result;
+    }
+}
+
+void RunInstancingBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Instancing benchmark : %u instances, %u frames", p_settings.instanceCount, p_settings.frameCount);
+
+    GLuint program = BenchmarkFunctions::CreateProgram(instanceVertexShader, instanceFragmentShader);
+
+    BenchmarkResult perDraw = RunMode(p_window, p_settings, false, program);
+    perDraw.name = "One draw per instance";
+    BenchmarkFunctions::LogResult(perDraw);
+
+    BenchmarkResult instanced = RunMode(p_window, p_settings, true, program);
+    instanced.name = "glDrawElementsInstanced";
+    BenchmarkFunctions::LogResult(instanced);
+
+    glDeleteProgram(program);
+}
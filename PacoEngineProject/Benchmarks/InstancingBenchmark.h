@@ -0,0 +1,9 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Draws p_settings.instanceCount copies of a quad, once with one draw call per copy and once with
+//a single instanced draw, and logs the CPU cost of a frame for both
+void RunInstancingBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings);
@@ -0,0 +1,260 @@
+#include "MeshDrawBenchmark.h"
+
+//std
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//engine
+#include "Rendering/GLStateCache.h"
+#include "Rendering/GeometryPool.h"
+#include "Rendering/IndexType.h"
+#include "Rendering/RenderComponent.h"
+#include "Rendering/VertexArrayCache.h"
+
+
+namespace
+{
+    struct MeshVertex
+    {
+        float x, y;
+
+        static const std::array<VertexAttribute, 1> attributes;
+    };
+
+    constexpr std::array<VertexAttribute, 1> MeshVertex::attributes =
+    {{
+        { 0, 2, GL_FLOAT, GL_FALSE, offsetof(MeshVertex, x) },
+    }};
+
+    struct MeshData
+    {
+        std::vector<MeshVertex> vertices;
+        std::vector<uint32_t> indices;
+    };
+
+    enum class MeshDrawMode
+    {
+        ComponentPerMesh,
+        SharedVertexArray,
+        SharedPool,
+    };
+
+    const char* meshVertexShader = R"(
+        #version 450 core
+        layout(location = 0) in vec2 a_position;
+        void main()
+        {
+            gl_Position = vec4(a_position, 0.0, 1.0);
+        }
+    )";
+
+    const char* meshFragmentShader = R"(
+        #version 450 core
+        out vec4 o_color;
+        void main()
+        {
+            o_color = vec4(0.9, 0.6, 0.2, 1.0);
+        }
+    )";
+
+    //Fans of 6 to 29 triangles scattered over the screen, each small enough for 16 bit indices
+    std::vector<MeshData> CreateMeshes(unsigned int p_meshCount)
+    {
+        const float radius = 0.01f;
+
+        std::vector<MeshData> meshes(p_meshCount);
+
+        for (unsigned int mesh = 0; mesh < p_meshCount; mesh++)
+        {
+            MeshData& data = meshes[mesh];
+
+            const unsigned int sideCount = 6 + mesh % 24;
+            const float phase = static_cast<float>(mesh) * 0.37f;
+            const float centerX = std::sin(phase) * 0.9f;
+            const float centerY = std::cos(phase * 1.3f) * 0.9f;
+
+            data.vertices.push_back({ centerX, centerY });
+
+            for (unsigned int side = 0; side < sideCount; side++)
+            {
+                const float angle = 6.2831853f * static_cast<float>(side) / static_cast<float>(sideCount);
+                data.vertices.push_back({ centerX + std::cos(angle) * radius, centerY + std::sin(angle) * radius });
+
+                data.indices.push_back(0);
+                data.indices.push_back(1 + side);
+                data.indices.push_back(1 + (side + 1) % sideCount);
+            }
+        }
+
+        return meshes;
+    }
+
+    BenchmarkResult RunMode(SDL_Window* p_window, const BenchmarkSettings& p_settings, const std::vector<MeshData>& p_meshes, MeshDrawMode p_mode, GLuint p_program)
+    {
+        std::vector<RenderComponent> components;
+        VertexArrayCache vertexArrayCache;
+        GeometryPool geometryPool;
+        std::vector<MeshAllocation> allocations;
+
+        if (p_mode == MeshDrawMode::ComponentPerMesh)
+        {
+            components.resize(p_meshes.size());
+
+            for (size_t mesh = 0; mesh < p_meshes.size(); mesh++)
+            {
+                const MeshData& data = p_meshes[mesh];
+                RenderComponentFunctions::Create<MeshVertex>(components[mesh], data.vertices.data(), static_cast<unsigned int>(data.vertices.size()),
+                    data.indices.data(), static_cast<unsigned int>(data.indices.size()));
+            }
+        }
+        else if (p_mode == MeshDrawMode::SharedVertexArray)
+        {
+            components.resize(p_meshes.size());
+
+            for (size_t mesh = 0; mesh < p_meshes.size(); mesh++)
+            {
+                const MeshData& data = p_meshes[mesh];
+                RenderComponentFunctions::Create<MeshVertex>(components[mesh], vertexArrayCache, data.vertices.data(), static_cast<unsigned int>(data.vertices.size()),
+                    data.indices.data(), static_cast<unsigned int>(data.indices.size()));
+            }
+
+            SDL_Log("VertexArrayCache : %u hits, %u vertex arrays", vertexArrayCache.hitCount, vertexArrayCache.missCount);
+        }
+        else
+        {
+            unsigned int vertexCapacity = 0;
+            unsigned int indexCapacity = 0;
+
+            for (const MeshData& data : p_meshes)
+            {
+                vertexCapacity += static_cast<unsigned int>(data.vertices.size());
+                indexCapacity += static_cast<unsigned int>(data.indices.size());
+            }
+
+            GeometryPoolFunctions::Create<MeshVertex, uint16_t>(geometryPool, vertexCapacity, indexCapacity);
+
+            allocations.resize(p_meshes.size());
+            std::vector<uint16_t> narrowIndices;
+
+            for (size_t mesh = 0; mesh < p_meshes.size(); mesh++)
+            {
+                const MeshData& data = p_meshes[mesh];
+                const unsigned int indexCount = static_cast<unsigned int>(data.indices.size());
+
+                narrowIndices.resize(indexCount);
+                IndexTypeFunctions::Narrow(data.indices.data(), indexCount, narrowIndices.data());
+
+                GeometryPoolFunctions::AllocateMesh<MeshVertex, uint16_t>(geometryPool, data.vertices.data(), static_cast<unsigned int>(data.vertices.size()),
+                    narrowIndices.data(), indexCount, allocations[mesh]);
+            }
+
+            GeometryPoolStats poolStats = GeometryPoolFunctions::GetStats(geometryPool);
+            SDL_Log("GeometryPool : %u meshes, vertices %.1f%% used, indices %.1f%% used, fragmentation %.2f", poolStats.vertexStats.allocationCount,
+                poolStats.vertexStats.utilization * 100.0f, poolStats.indexStats.utilization * 100.0f, poolStats.vertexStats.fragmentation);
+        }
+
+        GLStateCache stateCache;
+        GLStateCacheFunctions::Create(stateCache);
+        GLStateCacheFunctions::UseProgram(stateCache, p_program);
+
+        glFinish();
+
+        Uint64 totalFrameNs = 0;
+        Uint64 totalSubmitNs = 0;
+
+        const unsigned int totalFrames = p_settings.warmupFrameCount + p_settings.frameCount;
+
+        for (unsigned int frame = 0; frame < totalFrames; frame++)
+        {
+            SDL_PumpEvents();
+
+            Uint64 frameStart = SDL_GetTicksNS();
+
+            GLStateCacheFunctions::BeginFrame(stateCache);
+
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            if (p_mode != MeshDrawMode::SharedPool)
+            {
+                for (size_t mesh = 0; mesh < components.size(); mesh++)
+                {
+                    RenderComponentFunctions::Bind(components[mesh], stateCache);
+                    RenderComponentFunctions::DrawElements(components[mesh], static_cast<GLsizei>(p_meshes[mesh].indices.size()));
+                }
+            }
+            else
+            {
+                GeometryPoolFunctions::Bind(geometryPool, stateCache);
+
+                for (const MeshAllocation& allocation : allocations)
+                {
+                    GeometryPoolFunctions::DrawMesh(geometryPool, allocation);
+                }
+            }
+
+            GLStateCacheFunctions::EndFrame(stateCache);
+
+            Uint64 submitEnd = SDL_GetTicksNS();
+
+            SDL_GL_SwapWindow(p_window);
+
+            Uint64 frameEnd = SDL_GetTicksNS();
+
+            if (frame >= p_settings.warmupFrameCount)
+            {
+                totalFrameNs += frameEnd - frameStart;
+                totalSubmitNs += submitEnd - frameStart;
+            }
+        }
+
+        glFinish();
+
+        BenchmarkResult result = {};
+        result.averageFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalFrameNs) / p_settings.frameCount;
+        result.averageUploadMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalSubmitNs) / p_settings.frameCount;
+
+        const GLStateCounters& stateCounters = GLStateCacheFunctions::GetCounters(stateCache);
+        SDL_Log("%u GL state changes issued/frame, %u skipped", stateCounters.issuedCount, stateCounters.skippedCount);
+
+        RenderComponentFunctions::Unbind(stateCache);
+
+        for (RenderComponent& component : components)
+        {
+            RenderComponentFunctions::Delete(component);
+        }
+
+        VertexArrayCacheFunctions::Delete(vertexArrayCache);
+
+        if (p_mode == MeshDrawMode::SharedPool)
+        {
+            GeometryPoolFunctions::Delete(geometryPool);
+        }
+
+        return result;
+    }
+}
+
+void RunMeshDrawBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Mesh draw benchmark : %u meshes, %u frames", p_settings.drawCount, p_settings.frameCount);
+
+    GLuint program = BenchmarkFunctions::CreateProgram(meshVertexShader, meshFragmentShader);
+    std::vector<MeshData> meshes = CreateMeshes(p_settings.drawCount);
+
+    BenchmarkResult perMesh = RunMode(p_window, p_settings, meshes, MeshDrawMode::ComponentPerMesh, program);
+    perMesh.name = "RenderComponent per mesh";
+    BenchmarkFunctions::LogResult(perMesh);
+
+    BenchmarkResult sharedVertexArray = RunMode(p_window, p_settings, meshes, MeshDrawMode::SharedVertexArray, program);
+    sharedVertexArray.name = "Shared VAO per layout";
+    BenchmarkFunctions::LogResult(sharedVertexArray);
+
+    BenchmarkResult pool = RunMode(p_window, p_settings, meshes, MeshDrawMode::SharedPool, program);
+    pool.name = "GeometryPool base vertex";
+    BenchmarkFunctions::LogResult(pool);
+
+    glDeleteProgram(program);
+}
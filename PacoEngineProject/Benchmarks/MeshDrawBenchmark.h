@@ -0,0 +1,9 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Draws p_settings.drawCount small meshes from one RenderComponent per mesh, from RenderComponents sharing
+//a cached VAO and from a single GeometryPool with base vertex draws, and logs the CPU cost of a frame for each
+void RunMeshDrawBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings);
@@ -0,0 +1,18 @@
+//msdfgen core sources used by Text/FontAtlas.h are compiled once, here.
+//The prebuilt msdfgen-core.lib is release only, a Debug build would not link against it.
+
+#define MSDFGEN_PUBLIC
+
+#include <core/Contour.cpp>
+#include <core/DistanceMapping.cpp>
+#include <core/EdgeHolder.cpp>
+#include <core/MSDFErrorCorrection.cpp>
+#include <core/Projection.cpp>
+#include <core/Scanline.cpp>
+#include <core/Shape.cpp>
+#include <core/contour-combiners.cpp>
+#include <core/edge-coloring.cpp>
+#include <core/edge-segments.cpp>
+#include <core/edge-selectors.cpp>
+#include <core/equation-solver.cpp>
+#include <core/msdf-error-correction.cpp>
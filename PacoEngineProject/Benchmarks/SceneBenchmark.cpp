@@ -0,0 +1,109 @@
+#include "SceneBenchmark.h"
+
+//std
+#include <vector>
+
+//engine
+#include "Scene/Scene.h"
+
+
+namespace
+{
+    const unsigned int extractionCount = 100;
+
+    //What extraction costs without groups : every registered component is visited and tested
+    void ExtractWithViews(Scene& p_scene, SceneRenderData& p_outData)
+    {
+        p_outData.sprites.clear();
+        p_outData.meshes.clear();
+
+        const auto& visibleStorage = p_scene.registry.storage<VisibleComponent>();
+
+        for (auto [entity, spriteComponent, transform] : p_scene.registry.view<SpriteComponent, TransformComponent>().each())
+        {
+            if (visibleStorage.contains(entity))
+            {
+                Sprite sprite = {};
+                sprite.x = transform.world[3].x;
+                sprite.y = transform.world[3].y;
+                sprite.width = spriteComponent.width;
+                sprite.height = spriteComponent.height;
+                sprite.texture = spriteComponent.texture;
+                sprite.program = spriteComponent.program;
+                p_outData.sprites.push_back(sprite);
+            }
+        }
+
+        for (auto [entity, meshComponent, transform] : p_scene.registry.view<MeshComponent, TransformComponent>().each())
+        {
+            if (visibleStorage.contains(entity))
+            {
+                p_outData.meshes.push_back({ transform.world, meshComponent });
+            }
+        }
+    }
+
+    template<typename TExtract>
+    double MeasureExtraction(Scene& p_scene, SceneRenderData& p_data, TExtract p_extract)
+    {
+        Uint64 start = SDL_GetTicksNS();
+
+        for (unsigned int extraction = 0; extraction < extractionCount; extraction++)
+        {
+            p_extract(p_scene, p_data);
+        }
+
+        return BenchmarkFunctions::NanosecondsToMilliseconds(SDL_GetTicksNS() - start) / extractionCount;
+    }
+}
+
+void RunSceneBenchmark(const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Scene benchmark : %u entities", p_settings.entityCount);
+
+    Scene scene;
+    SceneFunctions::Create(scene);
+
+    std::vector<entt::entity> entities;
+    entities.reserve(p_settings.entityCount);
+
+    for (unsigned int index = 0; index < p_settings.entityCount; index++)
+    {
+        TransformComponent transform;
+        transform.position = glm::vec3(static_cast<float>(index % 1000), static_cast<float>(index / 1000), 0.0f);
+
+        entt::entity entity = SceneFunctions::CreateEntity(scene, transform);
+        entities.push_back(entity);
+
+        if (index % 2 == 0)
+        {
+            scene.registry.emplace<SpriteComponent>(entity, SpriteComponent{ 16.0f, 16.0f });
+        }
+        else
+        {
+            scene.registry.emplace<MeshComponent>(entity);
+        }
+    }
+
+    SceneFunctions::UpdateWorldMatrices(scene);
+
+    SceneRenderData data;
+    const unsigned int visiblePercents[] = { 1, 10, 100 };
+
+    for (unsigned int visiblePercent : visiblePercents)
+    {
+        //Sprite and mesh pairs are shown spread over the whole storage
+        for (unsigned int index = 0; index < p_settings.entityCount; index++)
+        {
+            SceneFunctions::SetVisible(scene, entities[index], index / 2 * 37 % 100 < visiblePercent);
+        }
+
+        double groupMs = MeasureExtraction(scene, data, SceneFunctions::Extract);
+        double viewMs = MeasureExtraction(scene, data, ExtractWithViews);
+
+        SDL_Log("%3u%% visible : %6zu sprites %6zu meshes   groups %8.3f ms   views %8.3f ms", visiblePercent,
+            data.sprites.size(), data.meshes.size(), groupMs, viewMs);
+    }
+
+    SceneFunctions::Destroy(scene);
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Registers p_settings.entityCount entities, half sprites and half meshes, and extracts their render data with 1%, 10%
+//and every entity visible, once through the owning groups of the Scene and once with a view over every render component
+//testing each entity for VisibleComponent, and logs the time per extraction of both
+void RunSceneBenchmark(const BenchmarkSettings& p_settings);
@@ -0,0 +1,127 @@
+#include "ShaderCacheBenchmark.h"
+
+//std
+#include <string>
+#include <vector>
+
+//engine
+#include "Rendering/ShaderProgram.h"
+
+
+namespace
+{
+    const char* variantVertexShader = R"(
+        #version 450 core
+        layout(location = 0) in vec2 a_position;
+        out vec2 v_uv;
+        void main()
+        {
+            v_uv = a_position * 0.5 + 0.5;
+            gl_Position = vec4(a_position, 0.0, 1.0);
+        }
+    )";
+
+    //Every variant differs by its constant so neither the cache nor the driver can share work between them
+    std::string MakeVariantFragmentShader(unsigned int p_variant)
+    {
+        return "#version 450 core\n"
+            "const float variant = " + std::to_string(p_variant) + ".0;\n" + R"(
+            in vec2 v_uv;
+            out vec4 o_color;
+            vec3 Palette(float t)
+            {
+                return 0.5 + 0.5 * cos(6.28318 * (vec3(1.0, 0.7, 0.4) * t + vec3(0.0, 0.15, 0.2) * variant));
+            }
+            void main()
+            {
+                vec2 z = (v_uv - 0.5) * 3.0;
+                float iterations = 0.0;
+                for (int i = 0; i < 64; i++)
+                {
+                    z = vec2(z.x * z.x - z.y * z.y, 2.0 * z.x * z.y) + vec2(-0.8, 0.156 + variant * 0.001);
+                    if (dot(z, z) > 4.0)
+                    {
+                        break;
+                    }
+                    iterations += 1.0;
+                }
+                o_color = vec4(Palette(iterations / 64.0), 1.0);
+            }
+        )";
+    }
+
+    //Builds every variant, returns the wall time in nanoseconds
+    Uint64 BuildAll(ShaderProgramCache& p_cache, const std::vector<std::string>& p_fragmentSources, std::vector<ShaderProgram>& p_outPrograms)
+    {
+        Uint64 start = SDL_GetTicksNS();
+
+        for (const std::string& fragmentSource : p_fragmentSources)
+        {
+            const ShaderStage stages[2] = { { GL_VERTEX_SHADER, variantVertexShader }, { GL_FRAGMENT_SHADER, fragmentSource.c_str() } };
+
+            ShaderProgram shaderProgram;
+            ShaderProgramFunctions::Create(shaderProgram, stages, &p_cache);
+            p_outPrograms.push_back(shaderProgram);
+        }
+
+        return SDL_GetTicksNS() - start;
+    }
+}
+
+void RunShaderCacheBenchmark(const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Shader cache benchmark : %u programs", p_settings.shaderProgramCount);
+
+    char* prefPath = SDL_GetPrefPath("PacoEngine", "Benchmarks");
+    std::string cacheDirectory = std::string(prefPath != nullptr ? prefPath : "") + "ShaderCache";
+    SDL_free(prefPath);
+
+    ShaderProgramCache cache;
+
+    if (!ShaderProgramFunctions::CreateCache(cache, cacheDirectory.c_str()))
+    {
+        SDL_Log("Shader cache unavailable, skipping the benchmark");
+        return;
+    }
+
+    std::vector<std::string> fragmentSources;
+
+    for (unsigned int variant = 0; variant < p_settings.shaderProgramCount; variant++)
+    {
+        fragmentSources.push_back(MakeVariantFragmentShader(variant));
+    }
+
+    //Cold start : binaries left by a previous run are removed first.
+    //Drivers with their own shader disk cache still make this faster than a first launch ever is.
+    for (const std::string& fragmentSource : fragmentSources)
+    {
+        const ShaderStage stages[2] = { { GL_VERTEX_SHADER, variantVertexShader }, { GL_FRAGMENT_SHADER, fragmentSource.c_str() } };
+        SDL_RemovePath(ShaderProgramFunctions::GetBinaryPath(cache, ShaderProgramFunctions::ComputeSourceHash(stages)).c_str());
+    }
+
+    std::vector<ShaderProgram> programs;
+    Uint64 coldNs = BuildAll(cache, fragmentSources, programs);
+
+    for (ShaderProgram& shaderProgram : programs)
+    {
+        ShaderProgramFunctions::Delete(shaderProgram);
+    }
+
+    programs.clear();
+
+    ShaderProgramCacheStats coldStats = ShaderProgramFunctions::GetStats(cache);
+    cache.stats = ShaderProgramCacheStats{};
+
+    Uint64 warmNs = BuildAll(cache, fragmentSources, programs);
+    ShaderProgramCacheStats warmStats = ShaderProgramFunctions::GetStats(cache);
+
+    for (ShaderProgram& shaderProgram : programs)
+    {
+        ShaderProgramFunctions::Delete(shaderProgram);
+    }
+
+    SDL_Log("%-24s total %8.3f ms   %u from source, %u from binary", "Cold (from source)", BenchmarkFunctions::NanosecondsToMilliseconds(coldNs),
+        coldStats.sourceBuildCount, coldStats.binaryLoadCount);
+    SDL_Log("%-24s total %8.3f ms   %u from source, %u from binary, %u rejected", "Warm (program binary)", BenchmarkFunctions::NanosecondsToMilliseconds(warmNs),
+        warmStats.sourceBuildCount, warmStats.binaryLoadCount, warmStats.rejectedBinaryCount);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Builds p_settings.shaderProgramCount program variants with an empty binary cache, then again from the binaries
+//it stored, and logs the startup cost of both
+void RunShaderCacheBenchmark(const BenchmarkSettings& p_settings);
@@ -0,0 +1,200 @@
+#include "ShaderPermutationBenchmark.h"
+
+//std
+#include <cstring>
+#include <iterator>
+#include <string>
+
+//engine
+#include "Rendering/GLStateCache.h"
+#include "Rendering/ShaderCompiler.h"
+#include "Rendering/ShaderPermutations.h"
+
+
+namespace
+{
+    const char* permutationFeatures[4] = { "LIT", "SKINNED", "ALPHA_TEST", "INSTANCED" };
+
+    const char* permutationInclude = R"(
+        vec3 Lighting(vec3 p_normal)
+        {
+            return vec3(0.2) + max(dot(p_normal, normalize(vec3(0.3, 1.0, 0.5))), 0.0) * vec3(0.8);
+        }
+    )";
+
+    //Fullscreen triangle from gl_VertexID, no vertex buffer needed. INSTANCED is never tested by the sources,
+    //its variants dedupe to the ones without it.
+    const char* permutationVertexShader = R"(#version 450 core
+#inject
+out vec3 v_normal;
+out vec2 v_uv;
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    v_uv = position;
+    v_normal = vec3(0.0, 0.0, 1.0);
+#ifdef SKINNED
+    float weight = 0.5 + 0.5 * sin(position.x * 12.0);
+    v_normal = normalize(mix(v_normal, vec3(position - 0.5, 1.0), weight));
+    position += vec2(weight * 0.001);
+#endif
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+    const char* permutationFragmentShader = R"(#version 450 core
+#inject
+#include "PermutationCommon.glsl"
+in vec3 v_normal;
+in vec2 v_uv;
+out vec4 o_color;
+void main()
+{
+    vec4 color = vec4(v_uv, 0.5, 1.0);
+#ifdef ALPHA_TEST
+    if (fract(v_uv.x * 8.0) < 0.1)
+    {
+        discard;
+    }
+#endif
+#ifdef LIT
+    color.rgb *= Lighting(v_normal);
+#endif
+    o_color = color;
+}
+)";
+
+    struct PermutationResult
+    {
+        double worstFrameMs;
+        double readyMs;
+        unsigned int readyFrame;
+    };
+
+    //p_salt is appended to the sources so the driver cannot reuse programs built by the previous mode
+    PermutationResult RunMode(SDL_Window* p_window, ShaderCompileMode p_mode, const std::string& p_includeDirectory, unsigned int p_salt, ShaderCompileMode& p_outMode)
+    {
+        PermutationResult result = {};
+
+        ShaderCompiler compiler;
+        ShaderCompilerFunctions::Create(compiler, p_window, p_mode);
+        p_outMode = compiler.mode;
+
+        std::string vertexSource = std::string(permutationVertexShader) + "//" + std::to_string(p_salt) + "\n";
+        std::string fragmentSource = std::string(permutationFragmentShader) + "//" + std::to_string(p_salt) + "\n";
+        const ShaderStage stages[2] = { { GL_VERTEX_SHADER, vertexSource.c_str() }, { GL_FRAGMENT_SHADER, fragmentSource.c_str() } };
+
+        ShaderPermutations permutations;
+
+        if (!ShaderPermutationFunctions::Create(permutations, compiler, stages, permutationFeatures, p_includeDirectory.c_str()))
+        {
+            ShaderCompilerFunctions::Destroy(compiler);
+            ShaderPermutationFunctions::Delete(permutations);
+            return result;
+        }
+
+        GLStateCache stateCache;
+        GLStateCacheFunctions::Create(stateCache);
+
+        GLuint vertexArray = 0;
+        glCreateVertexArrays(1, &vertexArray);
+        GLStateCacheFunctions::BindVertexArray(stateCache, vertexArray);
+
+        const uint32_t variantCount = 1u << 4;
+        Uint64 start = SDL_GetTicksNS();
+        Uint64 worstFrameNs = 0;
+
+        //Every variant is first used on frame 0, the benchmark runs until none is left compiling
+        for (unsigned int frame = 0; frame < 100000; frame++)
+        {
+            SDL_PumpEvents();
+
+            Uint64 frameStart = SDL_GetTicksNS();
+
+            ShaderCompilerFunctions::Update(compiler);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            for (uint32_t featureMask = 0; featureMask < variantCount; featureMask++)
+            {
+                GLStateCacheFunctions::UseProgram(stateCache, ShaderPermutationFunctions::GetProgram(permutations, compiler, featureMask));
+                glDrawArrays(GL_TRIANGLES, 0, 3);
+            }
+
+            SDL_GL_SwapWindow(p_window);
+
+            Uint64 frameEnd = SDL_GetTicksNS();
+
+            if (frameEnd - frameStart > worstFrameNs)
+            {
+                worstFrameNs = frameEnd - frameStart;
+            }
+
+            if (ShaderCompilerFunctions::GetStats(compiler).pendingCount == 0)
+            {
+                result.readyMs = BenchmarkFunctions::NanosecondsToMilliseconds(frameEnd - start);
+                result.readyFrame = frame;
+                break;
+            }
+        }
+
+        glFinish();
+
+        result.worstFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(worstFrameNs);
+
+        const ShaderPermutationStats& stats = ShaderPermutationFunctions::GetStats(permutations);
+        SDL_Log("%u variants built as %u programs, %u draws used the fallback", stats.variantCount, stats.programCount, stats.fallbackCount);
+
+        GLStateCacheFunctions::UseProgram(stateCache, 0);
+        GLStateCacheFunctions::BindVertexArray(stateCache, 0);
+        glDeleteVertexArrays(1, &vertexArray);
+
+        ShaderCompilerFunctions::Destroy(compiler);
+        ShaderPermutationFunctions::Delete(permutations);
+
+        return result;
+    }
+
+    const char* GetModeName(ShaderCompileMode p_mode)
+    {
+        switch (p_mode)
+        {
+        case ShaderCompileMode::ParallelExtension:
+            return "Parallel extension";
+        case ShaderCompileMode::SharedContext:
+            return "Shared context";
+        default:
+            return "Synchronous";
+        }
+    }
+
+    void LogResult(ShaderCompileMode p_mode, const PermutationResult& p_result)
+    {
+        SDL_Log("%-24s worst frame %8.3f ms   all ready after %8.3f ms (frame %u)", GetModeName(p_mode), p_result.worstFrameMs, p_result.readyMs, p_result.readyFrame);
+    }
+}
+
+void RunShaderPermutationBenchmark(SDL_Window* p_window)
+{
+    SDL_Log("Shader permutation benchmark : %zu features", std::size(permutationFeatures));
+
+    char* prefPath = SDL_GetPrefPath("PacoEngine", "Benchmarks");
+    std::string includeDirectory = std::string(prefPath != nullptr ? prefPath : "") + "ShaderIncludes";
+    SDL_free(prefPath);
+
+    if (!SDL_CreateDirectory(includeDirectory.c_str())
+        || !SDL_SaveFile((includeDirectory + "/PermutationCommon.glsl").c_str(), permutationInclude, std::strlen(permutationInclude)))
+    {
+        SDL_Log("Failed to write the benchmark shader include : %s", SDL_GetError());
+        return;
+    }
+
+    //Salted by the time so no run reuses what the driver cached on disk during the previous one
+    unsigned int salt = static_cast<unsigned int>(SDL_GetTicksNS() ^ static_cast<Uint64>(SDL_GetPerformanceCounter()));
+
+    ShaderCompileMode usedMode = ShaderCompileMode::Synchronous;
+    PermutationResult synchronous = RunMode(p_window, ShaderCompileMode::Synchronous, includeDirectory, salt, usedMode);
+    LogResult(usedMode, synchronous);
+
+    PermutationResult background = RunMode(p_window, ShaderCompilerFunctions::SelectMode(), includeDirectory, salt + 1, usedMode);
+    LogResult(usedMode, background);
+}
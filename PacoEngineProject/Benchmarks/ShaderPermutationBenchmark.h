@@ -0,0 +1,9 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Draws with every variant of a permuted shader from its first frame, once compiling synchronously and once
+//in the background, and logs the worst frame and the time until every variant is ready for both
+void RunShaderPermutationBenchmark(SDL_Window* p_window);
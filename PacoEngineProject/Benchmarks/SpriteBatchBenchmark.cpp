@@ -0,0 +1,207 @@
+#include "SpriteBatchBenchmark.h"
+
+//std
+#include <cmath>
+#include <span>
+#include <vector>
+
+//engine
+#include "Rendering/SpriteBatch.h"
+#include "Rendering/TextureAtlasManager.h"
+
+
+namespace
+{
+    const unsigned int benchmarkTextureCount = 64;
+
+    const char* spriteVertexShader = R"(
+        #version 450 core
+        layout(location = 0) in vec2 a_position;
+        layout(location = 1) in vec3 a_uv;
+        layout(location = 2) in vec4 a_color;
+        out vec3 v_uv;
+        out vec4 v_color;
+        void main()
+        {
+            v_uv = a_uv;
+            v_color = a_color;
+            gl_Position = vec4(a_position, 0.0, 1.0);
+        }
+    )";
+
+    const char* spriteFragmentShader = R"(
+        #version 450 core
+        layout(binding = 0) uniform sampler2D u_texture;
+        in vec3 v_uv;
+        in vec4 v_color;
+        out vec4 o_color;
+        void main()
+        {
+            o_color = texture(u_texture, v_uv.xy) * v_color;
+        }
+    )";
+
+    const char* atlasSpriteFragmentShader = R"(
+        #version 450 core
+        layout(binding = 0) uniform sampler2DArray u_texture;
+        in vec3 v_uv;
+        in vec4 v_color;
+        out vec4 o_color;
+        void main()
+        {
+            o_color = texture(u_texture, v_uv) * v_color;
+        }
+    )";
+
+    //Checkerboard of two colors, sizes differ between textures so the atlas packs mixed shelves
+    std::vector<uint8_t> CreatePixels(unsigned int p_texture, GLsizei p_size)
+    {
+        std::vector<uint8_t> pixels(static_cast<size_t>(p_size) * p_size * 4);
+
+        for (GLsizei y = 0; y < p_size; y++)
+        {
+            for (GLsizei x = 0; x < p_size; x++)
+            {
+                uint8_t* pixel = &pixels[(static_cast<size_t>(y) * p_size + x) * 4];
+                bool isEven = ((x / 4) + (y / 4)) % 2 == 0;
+                pixel[0] = static_cast<uint8_t>(isEven ? p_texture * 4 : 255 - p_texture * 4);
+                pixel[1] = 128;
+                pixel[2] = static_cast<uint8_t>(isEven ? 255 - p_texture * 4 : p_texture * 4);
+                pixel[3] = 255;
+            }
+        }
+
+        return pixels;
+    }
+
+    GLsizei GetTextureSize(unsigned int p_texture)
+    {
+        const GLsizei sizes[4] = { 16, 24, 32, 48 };
+        return sizes[p_texture % 4];
+    }
+
+    void RunMode(SDL_Window* p_window, const BenchmarkSettings& p_settings, const char* p_name, GLuint p_program, std::span<const TextureAtlasRegion> p_regions)
+    {
+        GLStateCache stateCache;
+        GLStateCacheFunctions::Create(stateCache);
+
+        SpriteBatch spriteBatch;
+
+        if (!SpriteBatchFunctions::Create(spriteBatch, p_settings.spriteCount))
+        {
+            return;
+        }
+
+        const float spriteSize = 0.01f;
+
+        Uint64 totalFrameNs = 0;
+        Uint64 totalBatchNs = 0;
+
+        const unsigned int totalFrames = p_settings.warmupFrameCount + p_settings.frameCount;
+
+        for (unsigned int frame = 0; frame < totalFrames; frame++)
+        {
+            SDL_PumpEvents();
+
+            Uint64 frameStart = SDL_GetTicksNS();
+
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            GLStateCacheFunctions::BeginFrame(stateCache);
+
+            SpriteBatchFunctions::Begin(spriteBatch);
+
+            for (unsigned int sprite = 0; sprite < p_settings.spriteCount; sprite++)
+            {
+                float phase = static_cast<float>(sprite) * 0.37f + static_cast<float>(frame) * 0.05f;
+
+                Sprite submitted = {};
+                submitted.x = std::sin(phase) * 0.9f;
+                submitted.y = std::cos(phase * 1.3f) * 0.9f;
+                submitted.width = spriteSize;
+                submitted.height = spriteSize;
+                submitted.r = submitted.g = submitted.b = submitted.a = 1.0f;
+                submitted.program = p_program;
+                SpriteBatchFunctions::SetAtlasRegion(submitted, p_regions[sprite % p_regions.size()]);
+
+                SpriteBatchFunctions::Submit(spriteBatch, submitted);
+            }
+
+            SpriteBatchFunctions::End(spriteBatch, stateCache);
+
+            GLStateCacheFunctions::EndFrame(stateCache);
+
+            Uint64 batchEnd = SDL_GetTicksNS();
+
+            SDL_GL_SwapWindow(p_window);
+
+            Uint64 frameEnd = SDL_GetTicksNS();
+
+            if (frame >= p_settings.warmupFrameCount)
+            {
+                totalFrameNs += frameEnd - frameStart;
+                totalBatchNs += batchEnd - frameStart;
+            }
+        }
+
+        glFinish();
+
+        const SpriteBatchStats& stats = SpriteBatchFunctions::GetStats(spriteBatch);
+
+        BenchmarkResult result = {};
+        result.name = p_name;
+        result.averageFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalFrameNs) / p_settings.frameCount;
+        result.averageUploadMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalBatchNs) / p_settings.frameCount;
+        BenchmarkFunctions::LogResult(result);
+
+        const GLStateCounters& stateCounters = GLStateCacheFunctions::GetCounters(stateCache);
+
+        SDL_Log("%u quads/frame, %u flushes/frame, %u dropped, %u fence stalls", stats.quadCount, stats.flushCount, stats.droppedQuadCount, spriteBatch.streamingComponent.vertexStream.stallCount);
+        SDL_Log("%u GL state changes issued/frame, %u skipped", stateCounters.issuedCount, stateCounters.skippedCount);
+
+        RenderComponentFunctions::Unbind(stateCache);
+        SpriteBatchFunctions::Delete(spriteBatch);
+    }
+}
+
+void RunSpriteBatchBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Sprite batch benchmark : %u sprites, %u textures, %u frames", p_settings.spriteCount, benchmarkTextureCount, p_settings.frameCount);
+
+    GLuint program = BenchmarkFunctions::CreateProgram(spriteVertexShader, spriteFragmentShader);
+    GLuint atlasProgram = BenchmarkFunctions::CreateProgram(spriteVertexShader, atlasSpriteFragmentShader);
+
+    //Same pixels twice : one GL_TEXTURE_2D per texture, then packed into a texture array atlas
+    GLuint textures[benchmarkTextureCount];
+    std::vector<TextureAtlasRegion> textureRegions(benchmarkTextureCount);
+    std::vector<TextureAtlasRegion> atlasRegions(benchmarkTextureCount);
+
+    TextureAtlasManager atlasManager;
+    TextureAtlasManagerFunctions::Create(atlasManager, 4 * 1024 * 1024);
+    TextureAtlasManagerFunctions::AddAtlas(atlasManager, 256, 256, 8);
+
+    for (unsigned int texture = 0; texture < benchmarkTextureCount; texture++)
+    {
+        GLsizei size = GetTextureSize(texture);
+        std::vector<uint8_t> pixels = CreatePixels(texture, size);
+
+        glCreateTextures(GL_TEXTURE_2D, 1, &textures[texture]);
+        glTextureStorage2D(textures[texture], 1, GL_RGBA8, size, size);
+        glTextureSubImage2D(textures[texture], 0, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        glTextureParameteri(textures[texture], GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        textureRegions[texture] = { textures[texture], 0, 0.0f, 0.0f, 1.0f, 1.0f };
+
+        //A rejected texture keeps an empty region and draws from texture 0, the report below counts it
+        TextureAtlasManagerFunctions::Add(atlasManager, pixels.data(), size, size, atlasRegions[texture]);
+    }
+
+    TextureAtlasManagerFunctions::LogReport(atlasManager);
+
+    RunMode(p_window, p_settings, "SpriteBatch separate textures", program, textureRegions);
+    RunMode(p_window, p_settings, "SpriteBatch texture array atlas", atlasProgram, atlasRegions);
+
+    TextureAtlasManagerFunctions::Delete(atlasManager);
+    glDeleteTextures(benchmarkTextureCount, textures);
+    glDeleteProgram(program);
+    glDeleteProgram(atlasProgram);
+}
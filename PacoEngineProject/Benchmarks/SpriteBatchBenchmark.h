@@ -0,0 +1,10 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Submits p_settings.spriteCount sprites spread over many small textures every frame through a SpriteBatch,
+//once with a texture per image and once with the images packed in a texture array atlas,
+//and logs the CPU cost of a frame together with the batch counters and the atlas occupancy
+void RunSpriteBatchBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings);
@@ -0,0 +1,21 @@
+//stb libraries used by the engine headers are compiled once, here
+
+//stb_include opens files with fopen, which MSVC rejects under /sdl otherwise
+#define _CRT_SECURE_NO_WARNINGS
+
+//GLSL #line directives only take numbers
+#define STB_INCLUDE_LINE_GLSL
+#define STB_INCLUDE_IMPLEMENTATION
+#include <stb_include.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <stb_rect_pack.h>
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
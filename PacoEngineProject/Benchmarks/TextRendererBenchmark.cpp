@@ -0,0 +1,179 @@
+#include "TextRendererBenchmark.h"
+
+//std
+#include <string>
+#include <vector>
+
+//engine
+#include "Text/TextRenderer.h"
+
+
+namespace
+{
+    //Pixels with y pointing down to clip space
+    const char* textVertexShader = R"(
+        #version 450 core
+        layout(location = 0) uniform vec2 u_viewportSize;
+        layout(location = 0) in vec2 a_position;
+        layout(location = 1) in vec3 a_uvRange;
+        layout(location = 2) in vec4 a_color;
+        out vec3 v_uvRange;
+        out vec4 v_color;
+        void main()
+        {
+            v_uvRange = a_uvRange;
+            v_color = a_color;
+            gl_Position = vec4(a_position / u_viewportSize * vec2(2.0, -2.0) + vec2(-1.0, 1.0), 0.0, 1.0);
+        }
+    )";
+
+    const char* textFragmentShader = R"(
+        #version 450 core
+        layout(binding = 0) uniform sampler2D u_atlas;
+        in vec3 v_uvRange;
+        in vec4 v_color;
+        out vec4 o_color;
+        void main()
+        {
+            vec3 distances = texture(u_atlas, v_uvRange.xy).rgb;
+            float median = max(min(distances.r, distances.g), min(max(distances.r, distances.g), distances.b));
+            float alpha = clamp((median - 0.5) * v_uvRange.z + 0.5, 0.0, 1.0);
+            o_color = vec4(v_color.rgb, v_color.a * alpha);
+        }
+    )";
+
+    enum class TextRendererMode
+    {
+        LayoutEveryFrame,
+        StaticLabels,
+        ChangingLabels,
+    };
+
+    void RunMode(SDL_Window* p_window, const BenchmarkSettings& p_settings, const char* p_name, TextRendererMode p_mode, GLuint p_program, const FontAtlas& p_font)
+    {
+        GLStateCache stateCache;
+        GLStateCacheFunctions::Create(stateCache);
+
+        TextRenderer textRenderer;
+
+        //A lifetime of 0 evicts every run at the end of the frame that drew it
+        if (!TextRendererFunctions::Create(textRenderer, p_settings.drawCount * 16, p_mode == TextRendererMode::LayoutEveryFrame ? 0 : 120))
+        {
+            return;
+        }
+
+        int width = 0;
+        int height = 0;
+        SDL_GetWindowSizeInPixels(p_window, &width, &height);
+
+        GLStateCacheFunctions::UseProgram(stateCache, p_program);
+        glUniform2f(0, static_cast<float>(width), static_cast<float>(height));
+
+        GLStateCacheFunctions::SetBlend(stateCache, true);
+        GLStateCacheFunctions::SetBlendFunction(stateCache, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        std::vector<std::string> labels(p_settings.drawCount);
+
+        for (unsigned int label = 0; label < p_settings.drawCount; label++)
+        {
+            labels[label] = "Label " + std::to_string(label);
+        }
+
+        Uint64 totalFrameNs = 0;
+        Uint64 totalSubmitNs = 0;
+        unsigned int totalLayoutCount = 0;
+        std::string changingLabel;
+
+        const unsigned int totalFrames = p_settings.warmupFrameCount + p_settings.frameCount;
+
+        for (unsigned int frame = 0; frame < totalFrames; frame++)
+        {
+            SDL_PumpEvents();
+
+            Uint64 frameStart = SDL_GetTicksNS();
+
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            GLStateCacheFunctions::BeginFrame(stateCache);
+
+            TextRendererFunctions::Begin(textRenderer);
+
+            for (unsigned int label = 0; label < p_settings.drawCount; label++)
+            {
+                float x = static_cast<float>((label * 97) % static_cast<unsigned int>(width));
+                float y = static_cast<float>((label * 53) % static_cast<unsigned int>(height));
+
+                if (p_mode == TextRendererMode::ChangingLabels && label % 10 == 0)
+                {
+                    changingLabel = std::to_string((label * 7919 + frame * 31) % 100000);
+                    TextRendererFunctions::Submit(textRenderer, p_program, p_font, changingLabel, x, y, 18.0f, 255, 64, 64);
+                }
+                else
+                {
+                    TextRendererFunctions::Submit(textRenderer, p_program, p_font, labels[label], x, y, 14.0f);
+                }
+            }
+
+            TextRendererFunctions::End(textRenderer, stateCache);
+
+            GLStateCacheFunctions::EndFrame(stateCache);
+
+            Uint64 submitEnd = SDL_GetTicksNS();
+
+            SDL_GL_SwapWindow(p_window);
+
+            Uint64 frameEnd = SDL_GetTicksNS();
+
+            if (frame >= p_settings.warmupFrameCount)
+            {
+                totalFrameNs += frameEnd - frameStart;
+                totalSubmitNs += submitEnd - frameStart;
+                totalLayoutCount += TextRendererFunctions::GetStats(textRenderer).layoutCount;
+            }
+        }
+
+        glFinish();
+        GLStateCacheFunctions::SetBlend(stateCache, false);
+
+        const TextRendererStats& stats = TextRendererFunctions::GetStats(textRenderer);
+
+        BenchmarkResult result = {};
+        result.name = p_name;
+        result.averageFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalFrameNs) / p_settings.frameCount;
+        result.averageUploadMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalSubmitNs) / p_settings.frameCount;
+        BenchmarkFunctions::LogResult(result);
+
+        SDL_Log("%u quads/frame, %u draws/frame, %u layouts/frame, %u cached runs, %u dropped", stats.quadCount, stats.flushCount,
+            totalLayoutCount / p_settings.frameCount, stats.cachedRunCount, stats.droppedQuadCount);
+
+        RenderComponentFunctions::Unbind(stateCache);
+        GLStateCacheFunctions::UseProgram(stateCache, 0);
+        TextRendererFunctions::Delete(textRenderer);
+    }
+}
+
+void RunTextRendererBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Text renderer benchmark : %u labels, %u frames", p_settings.drawCount, p_settings.frameCount);
+
+    char* prefPath = SDL_GetPrefPath("PacoEngine", "Benchmarks");
+    std::string cacheDirectory = std::string(prefPath != nullptr ? prefPath : "") + "Fonts";
+    SDL_free(prefPath);
+
+    FontAtlas font;
+
+    if (!FontAtlasFunctions::Load(font, p_settings.fontPath, FontAtlasSettings{}, cacheDirectory.c_str()))
+    {
+        SDL_Log("Font %s not found, pass one with --font", p_settings.fontPath);
+        return;
+    }
+
+    GLuint program = BenchmarkFunctions::CreateProgram(textVertexShader, textFragmentShader);
+
+    RunMode(p_window, p_settings, "Layout every frame", TextRendererMode::LayoutEveryFrame, program, font);
+    RunMode(p_window, p_settings, "Cached static labels", TextRendererMode::StaticLabels, program, font);
+    RunMode(p_window, p_settings, "Cached, 10% changing", TextRendererMode::ChangingLabels, program, font);
+
+    glDeleteProgram(program);
+    FontAtlasFunctions::Delete(font);
+}
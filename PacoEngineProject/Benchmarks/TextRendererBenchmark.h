@@ -0,0 +1,10 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Draws p_settings.drawCount labels with a TextRenderer, once laying every label out each frame, once with the run
+//cache and static labels, and once with a tenth of the labels changing every frame like damage numbers,
+//and logs the frame and submission cost, the layouts and the draws per frame for each
+void RunTextRendererBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings);
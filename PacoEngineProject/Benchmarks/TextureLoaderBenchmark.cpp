@@ -0,0 +1,274 @@
+#include "TextureLoaderBenchmark.h"
+
+//std
+#include <string>
+#include <vector>
+
+//vendor
+#include <stb_image.h>
+#include <stb_image_write.h>
+
+//engine
+#include "Rendering/GLStateCache.h"
+#include "Rendering/TextureLoader.h"
+
+
+namespace
+{
+    const unsigned int benchmarkTextureCount = 32;
+    const int benchmarkTextureSize = 1024;
+
+    //Tiles of an 8x4 grid, the tile index comes from a uniform and the corner from gl_VertexID
+    const char* tileVertexShader = R"(
+        #version 450 core
+        layout(location = 0) uniform int u_tile;
+        out vec2 v_uv;
+        void main()
+        {
+            vec2 corner = vec2(gl_VertexID & 1, (gl_VertexID >> 1) & 1);
+            vec2 tile = vec2(u_tile % 8, u_tile / 8);
+            v_uv = corner;
+            gl_Position = vec4((tile + corner) / vec2(8.0, 4.0) * 2.0 - 1.0, 0.0, 1.0);
+        }
+    )";
+
+    const char* tileFragmentShader = R"(
+        #version 450 core
+        layout(binding = 0) uniform sampler2D u_texture;
+        in vec2 v_uv;
+        out vec4 o_color;
+        void main()
+        {
+            o_color = texture(u_texture, v_uv);
+        }
+    )";
+
+    struct TextureLoaderResult
+    {
+        double worstFrameMs;
+        double readyMs;
+        unsigned int readyFrame;
+    };
+
+    //Noisy gradients so the files do not compress to almost nothing and decoding costs what real textures cost
+    bool WriteTextures(const std::string& p_directory, std::vector<std::string>& p_outPaths)
+    {
+        std::vector<uint8_t> pixels(static_cast<size_t>(benchmarkTextureSize) * benchmarkTextureSize * 4);
+        uint32_t noise = 0x9E3779B9u;
+
+        for (unsigned int texture = 0; texture < benchmarkTextureCount; texture++)
+        {
+            std::string path = p_directory + "/Texture" + std::to_string(texture) + ".png";
+            p_outPaths.push_back(path);
+
+            if (SDL_GetPathInfo(path.c_str(), nullptr))
+            {
+                continue;
+            }
+
+            for (int y = 0; y < benchmarkTextureSize; y++)
+            {
+                for (int x = 0; x < benchmarkTextureSize; x++)
+                {
+                    noise = noise * 1664525u + 1013904223u;
+                    uint8_t* pixel = &pixels[(static_cast<size_t>(y) * benchmarkTextureSize + x) * 4];
+                    pixel[0] = static_cast<uint8_t>(x / 4 + (noise >> 28));
+                    pixel[1] = static_cast<uint8_t>(y / 4 + (noise >> 29));
+                    pixel[2] = static_cast<uint8_t>(texture * 8);
+                    pixel[3] = 255;
+                }
+            }
+
+            if (stbi_write_png(path.c_str(), benchmarkTextureSize, benchmarkTextureSize, 4, pixels.data(), benchmarkTextureSize * 4) == 0)
+            {
+                SDL_Log("Failed to write benchmark texture %s", path.c_str());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    GLuint LoadTextureSynchronously(const std::string& p_path)
+    {
+        int width = 0;
+        int height = 0;
+        int channelCount = 0;
+        stbi_uc* pixels = stbi_load(p_path.c_str(), &width, &height, &channelCount, 4);
+
+        if (pixels == nullptr)
+        {
+            return 0;
+        }
+
+        GLuint texture = 0;
+        glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+        glTextureStorage2D(texture, TextureLoaderFunctions::GetMipLevelCount(width, height), GL_RGBA8, width, height);
+        glTextureSubImage2D(texture, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glGenerateTextureMipmap(texture);
+
+        stbi_image_free(pixels);
+
+        return texture;
+    }
+
+    void DrawTiles(GLStateCache& p_stateCache, GLuint p_program, const std::vector<GLuint>& p_textures)
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        GLStateCacheFunctions::UseProgram(p_stateCache, p_program);
+
+        for (unsigned int tile = 0; tile < p_textures.size(); tile++)
+        {
+            glUniform1i(0, static_cast<GLint>(tile));
+            GLStateCacheFunctions::BindTextureUnit(p_stateCache, 0, p_textures[tile]);
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        }
+    }
+
+    void LogResult(const char* p_name, const TextureLoaderResult& p_result)
+    {
+        SDL_Log("%-24s worst frame %8.3f ms   all ready after %8.3f ms (frame %u)", p_name, p_result.worstFrameMs, p_result.readyMs, p_result.readyFrame);
+    }
+
+    //Every texture is loaded on frame 0, the worst frame is that one
+    TextureLoaderResult RunSynchronous(SDL_Window* p_window, GLStateCache& p_stateCache, GLuint p_program, const std::vector<std::string>& p_paths)
+    {
+        TextureLoaderResult result = {};
+
+        Uint64 frameStart = SDL_GetTicksNS();
+
+        std::vector<GLuint> textures;
+
+        for (const std::string& path : p_paths)
+        {
+            textures.push_back(LoadTextureSynchronously(path));
+        }
+
+        DrawTiles(p_stateCache, p_program, textures);
+        SDL_GL_SwapWindow(p_window);
+
+        Uint64 frameEnd = SDL_GetTicksNS();
+
+        glFinish();
+
+        result.worstFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(frameEnd - frameStart);
+        result.readyMs = result.worstFrameMs;
+
+        for (GLuint texture : textures)
+        {
+            GLStateCacheFunctions::ForgetTexture(p_stateCache, texture);
+        }
+
+        glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+
+        return result;
+    }
+
+    TextureLoaderResult RunLoader(SDL_Window* p_window, GLStateCache& p_stateCache, GLuint p_program, const std::vector<std::string>& p_paths)
+    {
+        TextureLoaderResult result = {};
+
+        TextureLoader loader;
+
+        if (!TextureLoaderFunctions::Create(loader, 4 * 1024 * 1024, 4))
+        {
+            return result;
+        }
+
+        Uint64 start = SDL_GetTicksNS();
+        Uint64 worstFrameNs = 0;
+
+        std::vector<TextureLoadRequest*> requests;
+        std::vector<GLuint> textures(p_paths.size());
+
+        for (const std::string& path : p_paths)
+        {
+            requests.push_back(&TextureLoaderFunctions::Load(loader, path));
+        }
+
+        for (unsigned int frame = 0; frame < 100000; frame++)
+        {
+            SDL_PumpEvents();
+
+            Uint64 frameStart = SDL_GetTicksNS();
+
+            TextureLoaderFunctions::Update(loader);
+
+            for (size_t texture = 0; texture < requests.size(); texture++)
+            {
+                textures[texture] = TextureLoaderFunctions::GetTexture(loader, *requests[texture]);
+            }
+
+            DrawTiles(p_stateCache, p_program, textures);
+            SDL_GL_SwapWindow(p_window);
+
+            Uint64 frameEnd = SDL_GetTicksNS();
+
+            if (frameEnd - frameStart > worstFrameNs)
+            {
+                worstFrameNs = frameEnd - frameStart;
+            }
+
+            TextureLoaderStats stats = TextureLoaderFunctions::GetStats(loader);
+
+            if (stats.decodeQueueDepth == 0 && stats.uploadQueueDepth == 0)
+            {
+                result.readyMs = BenchmarkFunctions::NanosecondsToMilliseconds(frameEnd - start);
+                result.readyFrame = frame;
+                break;
+            }
+        }
+
+        glFinish();
+
+        result.worstFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(worstFrameNs);
+
+        TextureLoaderStats stats = TextureLoaderFunctions::GetStats(loader);
+        SDL_Log("%u ready, %u failed, latency %.3f ms average, %.3f ms max", stats.readyCount, stats.failedCount,
+            BenchmarkFunctions::NanosecondsToMilliseconds(stats.averageLatencyNs), BenchmarkFunctions::NanosecondsToMilliseconds(stats.maxLatencyNs));
+
+        for (GLuint texture : textures)
+        {
+            GLStateCacheFunctions::ForgetTexture(p_stateCache, texture);
+        }
+
+        TextureLoaderFunctions::Destroy(loader);
+
+        return result;
+    }
+}
+
+void RunTextureLoaderBenchmark(SDL_Window* p_window)
+{
+    SDL_Log("Texture loader benchmark : %u textures of %dx%d", benchmarkTextureCount, benchmarkTextureSize, benchmarkTextureSize);
+
+    char* prefPath = SDL_GetPrefPath("PacoEngine", "Benchmarks");
+    std::string directory = std::string(prefPath != nullptr ? prefPath : "") + "Textures";
+    SDL_free(prefPath);
+
+    std::vector<std::string> paths;
+
+    if (!SDL_CreateDirectory(directory.c_str()) || !WriteTextures(directory, paths))
+    {
+        SDL_Log("Failed to write the benchmark textures : %s", SDL_GetError());
+        return;
+    }
+
+    GLuint program = BenchmarkFunctions::CreateProgram(tileVertexShader, tileFragmentShader);
+
+    GLStateCache stateCache;
+    GLStateCacheFunctions::Create(stateCache);
+
+    GLuint vertexArray = 0;
+    glCreateVertexArrays(1, &vertexArray);
+    GLStateCacheFunctions::BindVertexArray(stateCache, vertexArray);
+
+    LogResult("Synchronous", RunSynchronous(p_window, stateCache, program, paths));
+    LogResult("TextureLoader", RunLoader(p_window, stateCache, program, paths));
+
+    GLStateCacheFunctions::UseProgram(stateCache, 0);
+    GLStateCacheFunctions::BindVertexArray(stateCache, 0);
+    glDeleteVertexArrays(1, &vertexArray);
+    glDeleteProgram(program);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Draws a set of PNG textures requested on the first frame, once loading them synchronously and once through
+//a TextureLoader, and logs the worst frame, the time until every texture is ready and the loader latency
+void RunTextureLoaderBenchmark(SDL_Window* p_window);
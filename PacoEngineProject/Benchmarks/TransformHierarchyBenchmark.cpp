@@ -0,0 +1,133 @@
+#include "TransformHierarchyBenchmark.h"
+
+//std
+#include <vector>
+
+//engine
+#include "Scene/Scene.h"
+
+
+namespace
+{
+    const unsigned int nodesPerTree = 100;
+    const unsigned int updateCount = 50;
+
+    uint32_t NextNoise(uint32_t& p_noise)
+    {
+        p_noise = p_noise * 1664525u + 1013904223u;
+        return p_noise >> 8;
+    }
+
+    //What a scene graph without ordering does : depth-first recursion, each node fetched through the registry
+    void UpdateRecursively(entt::registry& p_registry, entt::entity p_entity, const glm::mat4& p_parentWorld)
+    {
+        TransformComponent& transform = p_registry.get<TransformComponent>(p_entity);
+        transform.world = p_parentWorld * SceneFunctions::ComputeLocalMatrix(transform);
+
+        for (entt::entity child = p_registry.get<HierarchyComponent>(p_entity).firstChild; child != entt::null; child = p_registry.get<HierarchyComponent>(child).nextSibling)
+        {
+            UpdateRecursively(p_registry, child, transform.world);
+        }
+    }
+
+    void LogResult(const char* p_name, Uint64 p_totalNs, unsigned int p_updatedCount)
+    {
+        SDL_Log("%-24s %8.3f ms   %7u transforms", p_name, BenchmarkFunctions::NanosecondsToMilliseconds(p_totalNs) / updateCount, p_updatedCount);
+    }
+}
+
+void RunTransformHierarchyBenchmark(const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Transform hierarchy benchmark : %u entities in trees of %u", p_settings.entityCount, nodesPerTree);
+
+    Scene scene;
+    SceneFunctions::Create(scene);
+
+    std::vector<entt::entity> entities;
+    std::vector<entt::entity> roots;
+    entities.reserve(p_settings.entityCount);
+    uint32_t noise = 0x9E3779B9u;
+
+    //Each node hangs under a random earlier node of its tree, entities of a tree are created together
+    for (unsigned int index = 0; index < p_settings.entityCount; index++)
+    {
+        unsigned int treeIndex = index % nodesPerTree;
+
+        TransformComponent transform;
+        transform.position = glm::vec3(static_cast<float>(NextNoise(noise) % 100), static_cast<float>(NextNoise(noise) % 100), 0.0f);
+        transform.rotation = glm::angleAxis(static_cast<float>(NextNoise(noise) % 360) * 0.0174533f, glm::vec3(0.0f, 0.0f, 1.0f));
+
+        entt::entity parent = treeIndex == 0 ? entt::null : entities[index - 1 - NextNoise(noise) % treeIndex];
+        entt::entity entity = SceneFunctions::CreateEntity(scene, transform, parent);
+        entities.push_back(entity);
+
+        if (parent == entt::null)
+        {
+            roots.push_back(entity);
+        }
+    }
+
+    SceneFunctions::UpdateWorldMatrices(scene);
+
+    Uint64 start = SDL_GetTicksNS();
+
+    for (unsigned int update = 0; update < updateCount; update++)
+    {
+        for (entt::entity root : roots)
+        {
+            UpdateRecursively(scene.registry, root, glm::mat4(1.0f));
+        }
+    }
+
+    LogResult("Naive recursion", SDL_GetTicksNS() - start, p_settings.entityCount);
+
+    Uint64 totalNs = 0;
+
+    for (unsigned int update = 0; update < updateCount; update++)
+    {
+        for (entt::entity root : roots)
+        {
+            SceneFunctions::MarkTransformDirty(scene, root);
+        }
+
+        start = SDL_GetTicksNS();
+        SceneFunctions::UpdateWorldMatrices(scene);
+        totalNs += SDL_GetTicksNS() - start;
+    }
+
+    LogResult("Batched, all dirty", totalNs, SceneFunctions::GetStats(scene).updatedTransformCount);
+
+    totalNs = 0;
+
+    for (unsigned int update = 0; update < updateCount; update++)
+    {
+        for (unsigned int dirty = 0; dirty < p_settings.entityCount / 100; dirty++)
+        {
+            entt::entity entity = entities[NextNoise(noise) % entities.size()];
+            scene.registry.get<TransformComponent>(entity).position.x += 1.0f;
+            SceneFunctions::MarkTransformDirty(scene, entity);
+        }
+
+        start = SDL_GetTicksNS();
+        SceneFunctions::UpdateWorldMatrices(scene);
+        totalNs += SDL_GetTicksNS() - start;
+    }
+
+    LogResult("Batched, 1% dirty", totalNs, SceneFunctions::GetStats(scene).updatedTransformCount);
+
+    totalNs = 0;
+
+    //Moves a whole tree under another one and back, each update reorders both storages
+    for (unsigned int update = 0; update < updateCount; update++)
+    {
+        SceneFunctions::SetParent(scene, roots[1], update % 2 == 0 ? roots[0] : entt::null);
+
+        start = SDL_GetTicksNS();
+        SceneFunctions::UpdateWorldMatrices(scene);
+        totalNs += SDL_GetTicksNS() - start;
+    }
+
+    LogResult("Reparent and reorder", totalNs, SceneFunctions::GetStats(scene).updatedTransformCount);
+
+    SceneFunctions::Destroy(scene);
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Builds a forest of p_settings.entityCount transforms and logs the time to compute every world matrix by recursing
+//from each root through registry lookups, against the depth-first batched update of the Scene with every transform
+//dirty and with 1% of them dirty, and the time to reorder the storages after a reparent
+void RunTransformHierarchyBenchmark(const BenchmarkSettings& p_settings);
@@ -0,0 +1,214 @@
+#include "UniformArenaBenchmark.h"
+
+//std
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+//engine
+#include "PacoEngineDefines.h"
+#include "Rendering/GLStateCache.h"
+#include "Rendering/RenderComponent.h"
+#include "Rendering/UniformArena.h"
+
+
+namespace
+{
+    struct QuadVertex
+    {
+        float x, y;
+
+        static const std::array<VertexAttribute, 1> attributes;
+    };
+
+    constexpr std::array<VertexAttribute, 1> QuadVertex::attributes =
+    {{
+        { 0, 2, GL_FLOAT, GL_FALSE, offsetof(QuadVertex, x) },
+    }};
+
+    //std140 layout of the DrawConstants block
+    struct DrawConstants
+    {
+        float transform[16];
+        float color[4];
+    };
+
+    const QuadVertex quadVertices[4] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+    const uint32_t quadIndices[6] = { 0, 1, 2, 2, 3, 0 };
+
+    const char* uniformVertexShader = R"(
+        #version 450 core
+        layout(location = 0) in vec2 a_position;
+        layout(location = 0) uniform mat4 u_transform;
+        layout(location = 1) uniform vec4 u_color;
+        out vec4 v_color;
+        void main()
+        {
+            v_color = u_color;
+            gl_Position = u_transform * vec4(a_position, 0.0, 1.0);
+        }
+    )";
+
+    const char* arenaVertexShader = R"(
+        #version 450 core
+        layout(location = 0) in vec2 a_position;
+        layout(std140, binding = 1) uniform DrawConstants
+        {
+            mat4 u_transform;
+            vec4 u_color;
+        };
+        out vec4 v_color;
+        void main()
+        {
+            v_color = u_color;
+            gl_Position = u_transform * vec4(a_position, 0.0, 1.0);
+        }
+    )";
+
+    const char* drawFragmentShader = R"(
+        #version 450 core
+        in vec4 v_color;
+        out vec4 o_color;
+        void main()
+        {
+            o_color = v_color;
+        }
+    )";
+
+    static_assert(PACO_DRAW_UNIFORM_BINDING == 1, "arenaVertexShader binds DrawConstants at PACO_DRAW_UNIFORM_BINDING");
+
+    DrawConstants MakeDrawConstants(unsigned int p_draw, unsigned int p_frame)
+    {
+        const float quadSize = 0.01f;
+
+        float phase = static_cast<float>(p_draw) * 0.37f + static_cast<float>(p_frame) * 0.05f;
+        float shade = static_cast<float>(p_draw % 255) / 255.0f;
+        float c = std::cos(phase) * quadSize;
+        float s = std::sin(phase) * quadSize;
+
+        //Column major rotation and scale followed by a translation
+        return DrawConstants{
+            { c, s, 0.0f, 0.0f, -s, c, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, std::sin(phase) * 0.9f, std::cos(phase * 1.3f) * 0.9f, 0.0f, 1.0f },
+            { shade, 0.5f, 1.0f - shade, 1.0f } };
+    }
+
+    BenchmarkResult RunMode(SDL_Window* p_window, const BenchmarkSettings& p_settings, bool p_usesArena, GLuint p_program)
+    {
+        RenderComponent renderComponent;
+        RenderComponentFunctions::Create<QuadVertex>(renderComponent, quadVertices, 4, quadIndices, 6);
+
+        UniformArena arena;
+
+        if (p_usesArena && !UniformArenaFunctions::Create(arena, static_cast<GLsizeiptr>(p_settings.drawCount) * 256))
+        {
+            RenderComponentFunctions::Delete(renderComponent);
+            return BenchmarkResult{};
+        }
+
+        GLStateCache stateCache;
+        GLStateCacheFunctions::Create(stateCache);
+        GLStateCacheFunctions::UseProgram(stateCache, p_program);
+        RenderComponentFunctions::Bind(renderComponent, stateCache);
+
+        glFinish();
+
+        Uint64 totalFrameNs = 0;
+        Uint64 totalSubmitNs = 0;
+
+        const unsigned int totalFrames = p_settings.warmupFrameCount + p_settings.frameCount;
+
+        for (unsigned int frame = 0; frame < totalFrames; frame++)
+        {
+            SDL_PumpEvents();
+
+            Uint64 frameStart = SDL_GetTicksNS();
+
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            if (p_usesArena)
+            {
+                UniformArenaFunctions::BeginFrame(arena);
+            }
+
+            for (unsigned int draw = 0; draw < p_settings.drawCount; draw++)
+            {
+                DrawConstants constants = MakeDrawConstants(draw, frame);
+
+                if (p_usesArena)
+                {
+                    UniformAllocation allocation;
+
+                    if (!UniformArenaFunctions::PushUniform(arena, constants, allocation))
+                    {
+                        break;
+                    }
+
+                    UniformArenaFunctions::BindUniform(arena, PACO_DRAW_UNIFORM_BINDING, allocation);
+                }
+                else
+                {
+                    glUniformMatrix4fv(0, 1, GL_FALSE, constants.transform);
+                    glUniform4fv(1, 1, constants.color);
+                }
+
+                RenderComponentFunctions::DrawElements(renderComponent, 6);
+            }
+
+            if (p_usesArena)
+            {
+                UniformArenaFunctions::EndFrame(arena);
+            }
+
+            Uint64 submitEnd = SDL_GetTicksNS();
+
+            SDL_GL_SwapWindow(p_window);
+
+            Uint64 frameEnd = SDL_GetTicksNS();
+
+            if (frame >= p_settings.warmupFrameCount)
+            {
+                totalFrameNs += frameEnd - frameStart;
+                totalSubmitNs += submitEnd - frameStart;
+            }
+        }
+
+        glFinish();
+
+        BenchmarkResult result = {};
+        result.averageFrameMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalFrameNs) / p_settings.frameCount;
+        result.averageUploadMs = BenchmarkFunctions::NanosecondsToMilliseconds(totalSubmitNs) / p_settings.frameCount;
+
+        if (p_usesArena)
+        {
+            const UniformArenaStats& stats = UniformArenaFunctions::GetStats(arena);
+            SDL_Log("UniformArena : %u allocations, %lld bytes used, %u failed, %u stalls", stats.allocationCount, static_cast<long long>(stats.usedBytes),
+                stats.failedAllocationCount, arena.streamBuffer.stallCount);
+            UniformArenaFunctions::Delete(arena);
+        }
+
+        RenderComponentFunctions::Unbind(stateCache);
+        RenderComponentFunctions::Delete(renderComponent);
+
+        return result;
+    }
+}
+
+void RunUniformArenaBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings)
+{
+    SDL_Log("Uniform arena benchmark : %u draws, %u frames", p_settings.drawCount, p_settings.frameCount);
+
+    GLuint uniformProgram = BenchmarkFunctions::CreateProgram(uniformVertexShader, drawFragmentShader);
+    GLuint arenaProgram = BenchmarkFunctions::CreateProgram(arenaVertexShader, drawFragmentShader);
+
+    BenchmarkResult uniforms = RunMode(p_window, p_settings, false, uniformProgram);
+    uniforms.name = "glUniform per draw";
+    BenchmarkFunctions::LogResult(uniforms);
+
+    BenchmarkResult arena = RunMode(p_window, p_settings, true, arenaProgram);
+    arena.name = "UniformArena range";
+    BenchmarkFunctions::LogResult(arena);
+
+    glDeleteProgram(uniformProgram);
+    glDeleteProgram(arenaProgram);
+}
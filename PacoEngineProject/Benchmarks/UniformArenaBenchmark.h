@@ -0,0 +1,9 @@
+#pragma once
+
+//benchmarks
+#include "BenchmarkCommon.h"
+
+
+//Draws p_settings.drawCount quads each with its own transform and color, once set with glUniform* calls and
+//once pushed into a UniformArena and bound with glBindBufferRange, and logs the CPU cost of a frame for both
+void RunUniformArenaBenchmark(SDL_Window* p_window, const BenchmarkSettings& p_settings);
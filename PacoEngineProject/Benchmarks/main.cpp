@@ -0,0 +1,138 @@
+//std
+#include <cstdlib>
+#include <cstring>
+
+//vendor
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <glad/glad/gl.h>
+
+//benchmarks
+#include "BenchmarkCommon.h"
+#include "BufferStreamingBenchmark.h"
+#include "DynamicAtlasBenchmark.h"
+#include "FontAtlasBenchmark.h"
+#include "GlyphCacheBenchmark.h"
+#include "InstancingBenchmark.h"
+#include "MeshDrawBenchmark.h"
+#include "SceneBenchmark.h"
+#include "ShaderCacheBenchmark.h"
+#include "ShaderPermutationBenchmark.h"
+#include "SpriteBatchBenchmark.h"
+#include "TextRendererBenchmark.h"
+#include "TextureLoaderBenchmark.h"
+#include "TransformHierarchyBenchmark.h"
+#include "UniformArenaBenchmark.h"
+
+
+//Usage : Benchmarks [--frames N] [--sprites N] [--instances N] [--shaders N] [--draws N] [--entities N] [--font path] [--cjk-font path]
+static void ParseSettings(int argc, char** argv, BenchmarkSettings& p_settings)
+{
+    for (int argument = 1; argument + 1 < argc; argument += 2)
+    {
+        unsigned int value = static_cast<unsigned int>(std::strtoul(argv[argument + 1], nullptr, 10));
+
+        if (std::strcmp(argv[argument], "--frames") == 0)
+        {
+            p_settings.frameCount = value;
+        }
+        else if (std::strcmp(argv[argument], "--sprites") == 0)
+        {
+            p_settings.spriteCount = value;
+        }
+        else if (std::strcmp(argv[argument], "--instances") == 0)
+        {
+            p_settings.instanceCount = value;
+        }
+        else if (std::strcmp(argv[argument], "--shaders") == 0)
+        {
+            p_settings.shaderProgramCount = value;
+        }
+        else if (std::strcmp(argv[argument], "--draws") == 0)
+        {
+            p_settings.drawCount = value;
+        }
+        else if (std::strcmp(argv[argument], "--entities") == 0)
+        {
+            p_settings.entityCount = value;
+        }
+        else if (std::strcmp(argv[argument], "--font") == 0)
+        {
+            p_settings.fontPath = argv[argument + 1];
+        }
+        else if (std::strcmp(argv[argument], "--cjk-font") == 0)
+        {
+            p_settings.cjkFontPath = argv[argument + 1];
+        }
+        else
+        {
+            SDL_Log("Unknown benchmark argument %s", argv[argument]);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkSettings settings;
+    ParseSettings(argc, argv, settings);
+
+    if (!SDL_Init(SDL_INIT_VIDEO))
+    {
+        SDL_Log("Error on SDL_Init : %s", SDL_GetError());
+        return -1;
+    }
+
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+
+    SDL_Window* window = SDL_CreateWindow("Paco Engine Benchmarks", 800, 600, SDL_WINDOW_OPENGL);
+
+    if (window == nullptr)
+    {
+        SDL_Log("Error on SDL_CreateWindow : %s", SDL_GetError());
+        return -1;
+    }
+
+    SDL_GLContext sdlGlCtx = SDL_GL_CreateContext(window);
+
+    if (sdlGlCtx == nullptr)
+    {
+        SDL_Log("Failed to Create SDL Context : %s", SDL_GetError());
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return -1;
+    }
+
+    //Benchmarks measure submission cost, V-Sync would hide it
+    SDL_GL_SetSwapInterval(0);
+
+    if (!gladLoadGL((GLADloadfunc)SDL_GL_GetProcAddress))
+    {
+        SDL_Log("Failed to initialize GLAD");
+        SDL_GL_DestroyContext(sdlGlCtx);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return -1;
+    }
+
+    RunBufferStreamingBenchmark(window, settings);
+    RunSpriteBatchBenchmark(window, settings);
+    RunInstancingBenchmark(window, settings);
+    RunMeshDrawBenchmark(window, settings);
+    RunUniformArenaBenchmark(window, settings);
+    RunShaderCacheBenchmark(settings);
+    RunShaderPermutationBenchmark(window);
+    RunTextureLoaderBenchmark(window);
+    RunDynamicAtlasBenchmark(window, settings);
+    RunFontAtlasBenchmark(settings);
+    RunTextRendererBenchmark(window, settings);
+    RunGlyphCacheBenchmark(settings);
+    RunSceneBenchmark(settings);
+    RunTransformHierarchyBenchmark(settings);
+
+    SDL_GL_DestroyContext(sdlGlCtx);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+//vendor
+#include <SDL3/SDL_timer.h>
+
+//engine
+#include "PacoEngineDefines.h"
+
+
+struct GameLoopStats
+{
+    unsigned int stepCount = 0;
+
+    //Simulation time thrown away because a frame needed more than maxStepsPerFrame steps
+    Uint64 droppedNs = 0;
+
+    Uint64 sleptNs = 0;
+    Uint64 spunNs = 0;
+};
+
+//Fixed timestep loop : the simulation always advances by stepNs, whatever the frame rate.
+//Frame time is accumulated and consumed in whole steps, the remainder gives the interpolation
+//factor between the previous and the current simulation state used for rendering.
+//The frame limiter sleeps most of the remaining frame time and spins only the last spinThresholdNs,
+//sleeping is imprecise (about a millisecond on Windows) but spinning a whole frame burns a core.
+struct GameLoop
+{
+    Uint64 stepNs = 0;
+
+    //0 disables the frame limiter
+    Uint64 targetFrameNs = 0;
+
+    Uint64 spinThresholdNs = PACO_FRAME_LIMITER_SPIN_NS;
+    unsigned int maxStepsPerFrame = PACO_MAX_SIMULATION_STEPS_PER_FRAME;
+
+    Uint64 accumulatorNs = 0;
+    Uint64 frameStartNs = 0;
+
+    GameLoopStats frameStats;
+    GameLoopStats lastFrameStats;
+};
+
+namespace GameLoopFunctions
+{
+    //p_targetFrameRate of 0 leaves the frame rate unlimited
+    static void Create(GameLoop& p_gameLoop, unsigned int p_stepRate, unsigned int p_targetFrameRate = 0)
+    {
+        p_gameLoop = GameLoop{};
+        p_gameLoop.stepNs = SDL_NS_PER_SECOND / p_stepRate;
+
+        if (p_targetFrameRate > 0)
+        {
+            p_gameLoop.targetFrameNs = SDL_NS_PER_SECOND / p_targetFrameRate;
+        }
+
+        p_gameLoop.frameStartNs = SDL_GetTicksNS();
+    }
+
+    //Adds the time elapsed since the previous frame and returns how many simulation steps to run this frame
+    static unsigned int BeginFrame(GameLoop& p_gameLoop)
+    {
+        Uint64 now = SDL_GetTicksNS();
+        Uint64 elapsedNs = now - p_gameLoop.frameStartNs;
+        p_gameLoop.frameStartNs = now;
+
+        p_gameLoop.lastFrameStats = p_gameLoop.frameStats;
+        p_gameLoop.frameStats = GameLoopStats{};
+
+        p_gameLoop.accumulatorNs += elapsedNs;
+
+        Uint64 stepCount = p_gameLoop.accumulatorNs / p_gameLoop.stepNs;
+
+        //Past maxStepsPerFrame the simulation slows down instead of spiraling into ever longer frames
+        if (stepCount > p_gameLoop.maxStepsPerFrame)
+        {
+            Uint64 keptNs = p_gameLoop.stepNs * p_gameLoop.maxStepsPerFrame;
+            p_gameLoop.frameStats.droppedNs = p_gameLoop.accumulatorNs - keptNs - p_gameLoop.accumulatorNs % p_gameLoop.stepNs;
+            p_gameLoop.accumulatorNs -= p_gameLoop.frameStats.droppedNs;
+            stepCount = p_gameLoop.maxStepsPerFrame;
+        }
+
+        p_gameLoop.accumulatorNs -= stepCount * p_gameLoop.stepNs;
+        p_gameLoop.frameStats.stepCount = static_cast<unsigned int>(stepCount);
+
+        return static_cast<unsigned int>(stepCount);
+    }
+
+    //Step length in seconds, the delta time every simulation step must use
+    static float GetStepSeconds(const GameLoop& p_gameLoop)
+    {
+        return static_cast<float>(p_gameLoop.stepNs) / static_cast<float>(SDL_NS_PER_SECOND);
+    }
+
+    //How far the frame is between the last two simulation states, in [0, 1)
+    static float GetInterpolationAlpha(const GameLoop& p_gameLoop)
+    {
+        return static_cast<float>(p_gameLoop.accumulatorNs) / static_cast<float>(p_gameLoop.stepNs);
+    }
+
+    static float Interpolate(float p_previous, float p_current, float p_alpha)
+    {
+        return p_previous + (p_current - p_previous) * p_alpha;
+    }
+
+    //Waits until targetFrameNs has passed since BeginFrame, does nothing when the limiter is disabled
+    static void EndFrame(GameLoop& p_gameLoop)
+    {
+        if (p_gameLoop.targetFrameNs == 0)
+        {
+            return;
+        }
+
+        Uint64 frameEndNs = p_gameLoop.frameStartNs + p_gameLoop.targetFrameNs;
+        Uint64 now = SDL_GetTicksNS();
+
+        if (now + p_gameLoop.spinThresholdNs < frameEndNs)
+        {
+            SDL_DelayNS(frameEndNs - now - p_gameLoop.spinThresholdNs);
+
+            Uint64 afterSleep = SDL_GetTicksNS();
+            p_gameLoop.frameStats.sleptNs = afterSleep - now;
+            now = afterSleep;
+        }
+
+        Uint64 spinStart = now;
+
+        while (now < frameEndNs)
+        {
+            now = SDL_GetTicksNS();
+        }
+
+        p_gameLoop.frameStats.spunNs = now - spinStart;
+    }
+
+    //Counters of the last finished frame
+    static const GameLoopStats& GetStats(const GameLoop& p_gameLoop)
+    {
+        return p_gameLoop.lastFrameStats;
+    }
+}
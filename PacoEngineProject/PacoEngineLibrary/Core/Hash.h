@@ -0,0 +1,51 @@
+#pragma once
+
+//std
+#include <cstddef>
+#include <cstdint>
+
+
+//64 bit FNV-1a, used for cache keys : vertex layouts, shader sources, font atlases and text runs.
+//Not meant to resist collisions on purpose, callers compare the hashed data when a false match would be a bug.
+namespace HashFunctions
+{
+    constexpr uint64_t fnvOffsetBasis = 14695981039346656037ull;
+    constexpr uint64_t fnvPrime = 1099511628211ull;
+
+    //Hashes the 8 bytes of p_value, low byte first
+    constexpr uint64_t HashValue(uint64_t p_hash, uint64_t p_value)
+    {
+        for (unsigned int byte = 0; byte < 8; byte++)
+        {
+            p_hash ^= (p_value >> (byte * 8)) & 0xFF;
+            p_hash *= fnvPrime;
+        }
+
+        return p_hash;
+    }
+
+    static uint64_t HashBytes(uint64_t p_hash, const void* p_data, size_t p_size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(p_data);
+
+        for (size_t byte = 0; byte < p_size; byte++)
+        {
+            p_hash ^= bytes[byte];
+            p_hash *= fnvPrime;
+        }
+
+        return p_hash;
+    }
+
+    //A null p_string hashes as an empty one
+    static uint64_t HashString(uint64_t p_hash, const char* p_string)
+    {
+        for (const char* character = p_string; character != nullptr && *character != '\0'; character++)
+        {
+            p_hash ^= static_cast<unsigned char>(*character);
+            p_hash *= fnvPrime;
+        }
+
+        return p_hash;
+    }
+}
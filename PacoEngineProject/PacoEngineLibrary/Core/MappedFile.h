@@ -0,0 +1,115 @@
+#pragma once
+
+//std
+#include <cstddef>
+#include <cstdint>
+
+//platform
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+//Read-only view of a whole file mapped in memory, pages are read from disk when first touched
+struct MappedFile
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int descriptor = -1;
+#endif
+};
+
+namespace MappedFileFunctions
+{
+    static void Close(MappedFile& p_mappedFile);
+
+    //Returns false when the file cannot be opened or is empty
+    static bool Open(MappedFile& p_mappedFile, const char* p_path)
+    {
+#ifdef _WIN32
+        p_mappedFile.file = CreateFileA(p_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+        LARGE_INTEGER size = {};
+
+        if (p_mappedFile.file == INVALID_HANDLE_VALUE || !GetFileSizeEx(p_mappedFile.file, &size) || size.QuadPart == 0)
+        {
+            Close(p_mappedFile);
+            return false;
+        }
+
+        p_mappedFile.mapping = CreateFileMappingA(p_mappedFile.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        p_mappedFile.data = p_mappedFile.mapping != nullptr ? static_cast<const uint8_t*>(MapViewOfFile(p_mappedFile.mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        p_mappedFile.size = static_cast<size_t>(size.QuadPart);
+#else
+        p_mappedFile.descriptor = open(p_path, O_RDONLY);
+
+        struct stat status = {};
+
+        if (p_mappedFile.descriptor < 0 || fstat(p_mappedFile.descriptor, &status) != 0 || status.st_size == 0)
+        {
+            Close(p_mappedFile);
+            return false;
+        }
+
+        void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, p_mappedFile.descriptor, 0);
+        p_mappedFile.data = data != MAP_FAILED ? static_cast<const uint8_t*>(data) : nullptr;
+        p_mappedFile.size = static_cast<size_t>(status.st_size);
+#endif
+
+        if (p_mappedFile.data == nullptr)
+        {
+            Close(p_mappedFile);
+            return false;
+        }
+
+        return true;
+    }
+
+    static void Close(MappedFile& p_mappedFile)
+    {
+#ifdef _WIN32
+        if (p_mappedFile.data != nullptr)
+        {
+            UnmapViewOfFile(p_mappedFile.data);
+        }
+
+        if (p_mappedFile.mapping != nullptr)
+        {
+            CloseHandle(p_mappedFile.mapping);
+        }
+
+        if (p_mappedFile.file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(p_mappedFile.file);
+        }
+#else
+        if (p_mappedFile.data != nullptr)
+        {
+            munmap(const_cast<uint8_t*>(p_mappedFile.data), p_mappedFile.size);
+        }
+
+        if (p_mappedFile.descriptor >= 0)
+        {
+            close(p_mappedFile.descriptor);
+        }
+#endif
+
+        p_mappedFile = MappedFile{};
+    }
+}
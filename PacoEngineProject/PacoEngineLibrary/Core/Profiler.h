@@ -0,0 +1,372 @@
+#pragma once
+
+//engine
+#include "PacoEngineDefines.h"
+
+//Profiling is compiled in only when PACO_PROFILING is defined to 1 (TestApp Debug does),
+//otherwise every PACO_PROFILE_ macro expands to nothing and the markers can stay in hot paths.
+//
+//    PACO_PROFILE_SCOPE("Name")         CPU scope until the end of the enclosing block, any thread
+//    PACO_PROFILE_GPU_SCOPE("Name")     GL_TIMESTAMP scope, only on the thread owning the GL context
+//    PACO_PROFILE_GPU_FRAME_END()       once per frame after the swap, collects the GPU scopes of older frames
+//    PACO_PROFILE_THREAD_NAME("Name")   label of the calling thread in the trace
+//    PACO_PROFILE_EXPORT("trace.json")  writes everything recorded so far as Chrome trace JSON (chrome://tracing, Perfetto)
+#ifndef PACO_PROFILING
+#define PACO_PROFILING 0
+#endif
+
+#if PACO_PROFILING
+
+//std
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL.h>
+#include <glad/glad/gl.h>
+
+
+struct ProfileEvent
+{
+    const char* name;
+    Uint64 startNs;
+    Uint64 endNs;
+};
+
+//Written only by its own thread, eventCount is published with release so the exporter
+//can read every event below it while the thread keeps recording. Events past the capacity are dropped.
+struct ProfilerThreadBuffer
+{
+    unsigned int threadId = 0;
+    const char* threadName = nullptr;
+    std::unique_ptr<ProfileEvent[]> events;
+    std::atomic<unsigned int> eventCount = 0;
+    std::atomic<unsigned int> droppedCount = 0;
+};
+
+//Begin and end timestamp queries of every GPU scope of one frame
+struct ProfilerGpuFrame
+{
+    GLuint queries[PACO_PROFILER_GPU_SCOPES_PER_FRAME * 2] = {};
+    const char* names[PACO_PROFILER_GPU_SCOPES_PER_FRAME] = {};
+    unsigned int scopeCount = 0;
+};
+
+//GPU scopes are recorded in one frame slot per frame in flight. A slot is read back just before it is reused, by the
+//EndGpuFrame that ends the frame PACO_MAX_FRAMES_IN_FLIGHT - 1 frames after its own, so reading the queries almost never waits on the GPU.
+struct ProfilerGpuTimeline
+{
+    bool isCreated = false;
+    ProfilerGpuFrame frames[PACO_MAX_FRAMES_IN_FLIGHT];
+    unsigned int currentFrame = 0;
+
+    //Added to GPU timestamps to bring them on the SDL_GetTicksNS timeline
+    Sint64 gpuToCpuOffsetNs = 0;
+
+    ProfilerThreadBuffer* buffer = nullptr;
+};
+
+//Puts the buffer of a thread back in the free list when the thread exits, so threads started and joined again and again,
+//such as the font bakers, record into the same few buffers instead of adding one each. Recorded events stay in the buffer.
+struct ProfilerThreadRegistration
+{
+    ProfilerThreadBuffer* buffer = nullptr;
+
+    ~ProfilerThreadRegistration();
+};
+
+struct Profiler
+{
+    std::mutex registrationMutex;
+    std::vector<std::unique_ptr<ProfilerThreadBuffer>> threadBuffers;
+    std::vector<ProfilerThreadBuffer*> freeThreadBuffers;
+    ProfilerGpuTimeline gpuTimeline;
+};
+
+namespace ProfilerFunctions
+{
+    //inline rather than static : every translation unit must share the same profiler and thread buffers
+    inline Profiler& GetProfiler()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    inline thread_local ProfilerThreadBuffer* currentThreadBuffer = nullptr;
+    inline thread_local ProfilerThreadRegistration currentThreadRegistration;
+
+    //Only registration takes a lock, recording into the returned buffer never does
+    inline ProfilerThreadBuffer* CreateThreadBuffer(const char* p_threadName)
+    {
+        Profiler& profiler = GetProfiler();
+
+        std::unique_ptr<ProfilerThreadBuffer> buffer = std::make_unique<ProfilerThreadBuffer>();
+        buffer->threadName = p_threadName;
+        buffer->events = std::make_unique<ProfileEvent[]>(PACO_PROFILER_EVENTS_PER_THREAD);
+
+        std::lock_guard<std::mutex> lock(profiler.registrationMutex);
+        buffer->threadId = static_cast<unsigned int>(profiler.threadBuffers.size());
+        profiler.threadBuffers.push_back(std::move(buffer));
+
+        return profiler.threadBuffers.back().get();
+    }
+
+    inline ProfilerThreadBuffer* GetThreadBuffer()
+    {
+        if (currentThreadBuffer == nullptr)
+        {
+            Profiler& profiler = GetProfiler();
+
+            {
+                std::lock_guard<std::mutex> lock(profiler.registrationMutex);
+
+                if (!profiler.freeThreadBuffers.empty())
+                {
+                    currentThreadBuffer = profiler.freeThreadBuffers.back();
+                    profiler.freeThreadBuffers.pop_back();
+                }
+            }
+
+            if (currentThreadBuffer == nullptr)
+            {
+                currentThreadBuffer = CreateThreadBuffer(nullptr);
+            }
+
+            currentThreadRegistration.buffer = currentThreadBuffer;
+        }
+
+        return currentThreadBuffer;
+    }
+
+    inline void SetThreadName(const char* p_threadName)
+    {
+        GetThreadBuffer()->threadName = p_threadName;
+    }
+
+    inline void RecordEvent(ProfilerThreadBuffer* p_buffer, const char* p_name, Uint64 p_startNs, Uint64 p_endNs)
+    {
+        unsigned int eventIndex = p_buffer->eventCount.load(std::memory_order_relaxed);
+
+        if (eventIndex >= PACO_PROFILER_EVENTS_PER_THREAD)
+        {
+            p_buffer->droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        p_buffer->events[eventIndex] = ProfileEvent{ p_name, p_startNs, p_endNs };
+        p_buffer->eventCount.store(eventIndex + 1, std::memory_order_release);
+    }
+
+    inline void CreateGpuTimeline(ProfilerGpuTimeline& p_timeline)
+    {
+        for (ProfilerGpuFrame& frame : p_timeline.frames)
+        {
+            glCreateQueries(GL_TIMESTAMP, PACO_PROFILER_GPU_SCOPES_PER_FRAME * 2, frame.queries);
+        }
+
+        GLint64 gpuNowNs = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNowNs);
+        p_timeline.gpuToCpuOffsetNs = static_cast<Sint64>(SDL_GetTicksNS()) - gpuNowNs;
+
+        p_timeline.buffer = CreateThreadBuffer("GPU");
+        p_timeline.isCreated = true;
+    }
+
+    //Returns the scope index in the current frame, or -1 when the frame has no query left
+    inline int BeginGpuScope(const char* p_name)
+    {
+        ProfilerGpuTimeline& timeline = GetProfiler().gpuTimeline;
+
+        if (!timeline.isCreated)
+        {
+            CreateGpuTimeline(timeline);
+        }
+
+        ProfilerGpuFrame& frame = timeline.frames[timeline.currentFrame];
+
+        if (frame.scopeCount >= PACO_PROFILER_GPU_SCOPES_PER_FRAME)
+        {
+            timeline.buffer->droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return -1;
+        }
+
+        unsigned int scope = frame.scopeCount++;
+        frame.names[scope] = p_name;
+        glQueryCounter(frame.queries[scope * 2], GL_TIMESTAMP);
+
+        return static_cast<int>(scope);
+    }
+
+    inline void EndGpuScope(int p_scope)
+    {
+        if (p_scope < 0)
+        {
+            return;
+        }
+
+        ProfilerGpuTimeline& timeline = GetProfiler().gpuTimeline;
+        glQueryCounter(timeline.frames[timeline.currentFrame].queries[p_scope * 2 + 1], GL_TIMESTAMP);
+    }
+
+    //Moves to the next frame slot and reads back the scopes it held. Ending frame F reads frame F - (PACO_MAX_FRAMES_IN_FLIGHT - 1),
+    //whose queries the GPU has had PACO_MAX_FRAMES_IN_FLIGHT - 1 swaps to finish.
+    inline void EndGpuFrame()
+    {
+        ProfilerGpuTimeline& timeline = GetProfiler().gpuTimeline;
+
+        if (!timeline.isCreated)
+        {
+            return;
+        }
+
+        timeline.currentFrame = (timeline.currentFrame + 1) % PACO_MAX_FRAMES_IN_FLIGHT;
+        ProfilerGpuFrame& frame = timeline.frames[timeline.currentFrame];
+
+        for (unsigned int scope = 0; scope < frame.scopeCount; scope++)
+        {
+            GLuint64 beginNs = 0;
+            GLuint64 endNs = 0;
+            glGetQueryObjectui64v(frame.queries[scope * 2], GL_QUERY_RESULT, &beginNs);
+            glGetQueryObjectui64v(frame.queries[scope * 2 + 1], GL_QUERY_RESULT, &endNs);
+
+            RecordEvent(timeline.buffer, frame.names[scope], beginNs + timeline.gpuToCpuOffsetNs, endNs + timeline.gpuToCpuOffsetNs);
+        }
+
+        frame.scopeCount = 0;
+    }
+
+    inline void WriteJsonString(SDL_IOStream* p_stream, const char* p_text)
+    {
+        SDL_IOprintf(p_stream, "\"");
+
+        for (const char* character = p_text; *character != '\0'; character++)
+        {
+            if (*character == '"' || *character == '\\')
+            {
+                SDL_IOprintf(p_stream, "\\");
+            }
+
+            SDL_IOprintf(p_stream, "%c", *character);
+        }
+
+        SDL_IOprintf(p_stream, "\"");
+    }
+
+    //Chrome trace event format : one complete ("X") event per scope, timestamps in microseconds
+    inline bool ExportChromeTrace(const char* p_path)
+    {
+        SDL_IOStream* stream = SDL_IOFromFile(p_path, "w");
+
+        if (stream == nullptr)
+        {
+            SDL_Log("Failed to open profiler trace %s : %s", p_path, SDL_GetError());
+            return false;
+        }
+
+        Profiler& profiler = GetProfiler();
+        std::lock_guard<std::mutex> lock(profiler.registrationMutex);
+
+        SDL_IOprintf(stream, "{\"traceEvents\":[\n");
+
+        bool isFirstEvent = true;
+
+        for (const std::unique_ptr<ProfilerThreadBuffer>& buffer : profiler.threadBuffers)
+        {
+            if (buffer->threadName != nullptr)
+            {
+                SDL_IOprintf(stream, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", isFirstEvent ? "" : ",\n", buffer->threadId);
+                WriteJsonString(stream, buffer->threadName);
+                SDL_IOprintf(stream, "}}");
+                isFirstEvent = false;
+            }
+
+            unsigned int eventCount = buffer->eventCount.load(std::memory_order_acquire);
+
+            for (unsigned int eventIndex = 0; eventIndex < eventCount; eventIndex++)
+            {
+                const ProfileEvent& event = buffer->events[eventIndex];
+
+                SDL_IOprintf(stream, "%s{\"name\":", isFirstEvent ? "" : ",\n");
+                WriteJsonString(stream, event.name);
+                SDL_IOprintf(stream, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    buffer->threadId, static_cast<double>(event.startNs) / 1000.0, static_cast<double>(event.endNs - event.startNs) / 1000.0);
+                isFirstEvent = false;
+            }
+
+            unsigned int droppedCount = buffer->droppedCount.load(std::memory_order_relaxed);
+
+            if (droppedCount > 0)
+            {
+                SDL_Log("Profiler thread %u dropped %u events, raise PACO_PROFILER_EVENTS_PER_THREAD", buffer->threadId, droppedCount);
+            }
+        }
+
+        SDL_IOprintf(stream, "\n]}\n");
+
+        return SDL_CloseIO(stream);
+    }
+}
+
+inline ProfilerThreadRegistration::~ProfilerThreadRegistration()
+{
+    if (buffer != nullptr)
+    {
+        Profiler& profiler = ProfilerFunctions::GetProfiler();
+        std::lock_guard<std::mutex> lock(profiler.registrationMutex);
+        profiler.freeThreadBuffers.push_back(buffer);
+    }
+}
+
+//Records the time between its construction and destruction into the calling thread's buffer
+struct ProfileScope
+{
+    ProfilerThreadBuffer* buffer;
+    const char* name;
+    Uint64 startNs;
+
+    explicit ProfileScope(const char* p_name)
+        : buffer(ProfilerFunctions::GetThreadBuffer()), name(p_name), startNs(SDL_GetTicksNS())
+    {
+    }
+
+    ~ProfileScope()
+    {
+        ProfilerFunctions::RecordEvent(buffer, name, startNs, SDL_GetTicksNS());
+    }
+};
+
+struct ProfileGpuScope
+{
+    int scope;
+
+    explicit ProfileGpuScope(const char* p_name)
+        : scope(ProfilerFunctions::BeginGpuScope(p_name))
+    {
+    }
+
+    ~ProfileGpuScope()
+    {
+        ProfilerFunctions::EndGpuScope(scope);
+    }
+};
+
+#define PACO_PROFILE_CONCAT_INNER(a, b) a##b
+#define PACO_PROFILE_CONCAT(a, b) PACO_PROFILE_CONCAT_INNER(a, b)
+
+#define PACO_PROFILE_SCOPE(name) ProfileScope PACO_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PACO_PROFILE_GPU_SCOPE(name) ProfileGpuScope PACO_PROFILE_CONCAT(profileGpuScope, __LINE__)(name)
+#define PACO_PROFILE_GPU_FRAME_END() ProfilerFunctions::EndGpuFrame()
+#define PACO_PROFILE_THREAD_NAME(name) ProfilerFunctions::SetThreadName(name)
+#define PACO_PROFILE_EXPORT(path) ProfilerFunctions::ExportChromeTrace(path)
+
+#else
+
+#define PACO_PROFILE_SCOPE(name)
+#define PACO_PROFILE_GPU_SCOPE(name)
+#define PACO_PROFILE_GPU_FRAME_END()
+#define PACO_PROFILE_THREAD_NAME(name)
+#define PACO_PROFILE_EXPORT(path)
+
+#endif
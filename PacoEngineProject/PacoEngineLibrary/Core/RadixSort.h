@@ -0,0 +1,68 @@
+#pragma once
+
+//std
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace RadixSortFunctions
+{
+    //Stable LSD radix sort of p_keys, p_values is moved along with its key.
+    //One 8 bit pass per key byte, passes where every key shares the same byte value are skipped,
+    //so keys that only use their high bytes cost as many passes as bytes that actually vary.
+    //The scratch vectors are resized as needed, keep them around between calls to avoid allocating.
+    static void SortKeyValues(std::vector<uint64_t>& p_keys, std::vector<uint32_t>& p_values, std::vector<uint64_t>& p_scratchKeys, std::vector<uint32_t>& p_scratchValues)
+    {
+        const size_t count = p_keys.size();
+
+        if (count < 2)
+        {
+            return;
+        }
+
+        p_scratchKeys.resize(count);
+        p_scratchValues.resize(count);
+
+        size_t histograms[8][256] = {};
+
+        for (uint64_t key : p_keys)
+        {
+            for (unsigned int byte = 0; byte < 8; byte++)
+            {
+                histograms[byte][(key >> (byte * 8)) & 0xFF]++;
+            }
+        }
+
+        for (unsigned int byte = 0; byte < 8; byte++)
+        {
+            size_t* histogram = histograms[byte];
+            const unsigned int shift = byte * 8;
+
+            if (histogram[(p_keys[0] >> shift) & 0xFF] == count)
+            {
+                continue;
+            }
+
+            size_t offset = 0;
+
+            for (unsigned int bucket = 0; bucket < 256; bucket++)
+            {
+                size_t bucketCount = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketCount;
+            }
+
+            for (size_t index = 0; index < count; index++)
+            {
+                size_t destination = histogram[(p_keys[index] >> shift) & 0xFF]++;
+                p_scratchKeys[destination] = p_keys[index];
+                p_scratchValues[destination] = p_values[index];
+            }
+
+            std::swap(p_keys, p_scratchKeys);
+            std::swap(p_values, p_scratchValues);
+        }
+    }
+}
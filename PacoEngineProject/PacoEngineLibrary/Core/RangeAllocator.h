@@ -0,0 +1,176 @@
+#pragma once
+
+//std
+#include <cstdint>
+#include <iterator>
+#include <map>
+
+
+//Slice [offset, offset + count) handed out by a RangeAllocator, units are up to the owner (vertices, indices, bytes)
+struct RangeAllocation
+{
+    uint32_t offset = 0;
+    uint32_t count = 0;
+};
+
+struct RangeAllocatorStats
+{
+    uint32_t capacity = 0;
+    uint32_t usedCount = 0;
+    uint32_t freeCount = 0;
+    uint32_t largestFreeBlock = 0;
+    uint32_t freeBlockCount = 0;
+    uint32_t allocationCount = 0;
+
+    //usedCount / capacity
+    float utilization = 0.0f;
+
+    //1 - largestFreeBlock / freeCount, 0 when all the free space is one contiguous block
+    float fragmentation = 0.0f;
+};
+
+//Best fit free-list allocator over the range [0, capacity).
+//Free blocks are indexed by offset to coalesce neighbours on Free and by size to find the best fit on Allocate.
+struct RangeAllocator
+{
+    uint32_t capacity = 0;
+    uint32_t usedCount = 0;
+    uint32_t allocationCount = 0;
+    std::map<uint32_t, uint32_t> freeBlocksByOffset;
+    std::multimap<uint32_t, uint32_t> freeBlocksBySize;
+};
+
+namespace RangeAllocatorFunctions
+{
+    static void AddFreeBlock(RangeAllocator& p_allocator, uint32_t p_offset, uint32_t p_count)
+    {
+        p_allocator.freeBlocksByOffset.emplace(p_offset, p_count);
+        p_allocator.freeBlocksBySize.emplace(p_count, p_offset);
+    }
+
+    static void RemoveFreeBlockBySize(RangeAllocator& p_allocator, uint32_t p_offset, uint32_t p_count)
+    {
+        auto [first, last] = p_allocator.freeBlocksBySize.equal_range(p_count);
+
+        for (auto block = first; block != last; ++block)
+        {
+            if (block->second == p_offset)
+            {
+                p_allocator.freeBlocksBySize.erase(block);
+                return;
+            }
+        }
+    }
+
+    static void Create(RangeAllocator& p_allocator, uint32_t p_capacity)
+    {
+        p_allocator = RangeAllocator{};
+        p_allocator.capacity = p_capacity;
+
+        if (p_capacity > 0)
+        {
+            AddFreeBlock(p_allocator, 0, p_capacity);
+        }
+    }
+
+    //Returns false when no free block is large enough, the allocator is left untouched in that case
+    static bool Allocate(RangeAllocator& p_allocator, uint32_t p_count, RangeAllocation& p_outAllocation)
+    {
+        if (p_count == 0)
+        {
+            return false;
+        }
+
+        auto bestFit = p_allocator.freeBlocksBySize.lower_bound(p_count);
+
+        if (bestFit == p_allocator.freeBlocksBySize.end())
+        {
+            return false;
+        }
+
+        uint32_t blockCount = bestFit->first;
+        uint32_t blockOffset = bestFit->second;
+
+        p_allocator.freeBlocksBySize.erase(bestFit);
+        p_allocator.freeBlocksByOffset.erase(blockOffset);
+
+        if (blockCount > p_count)
+        {
+            AddFreeBlock(p_allocator, blockOffset + p_count, blockCount - p_count);
+        }
+
+        p_allocator.usedCount += p_count;
+        p_allocator.allocationCount++;
+
+        p_outAllocation.offset = blockOffset;
+        p_outAllocation.count = p_count;
+
+        return true;
+    }
+
+    //Gives the range back and merges it with the free blocks directly before and after it
+    static void Free(RangeAllocator& p_allocator, const RangeAllocation& p_allocation)
+    {
+        if (p_allocation.count == 0)
+        {
+            return;
+        }
+
+        uint32_t offset = p_allocation.offset;
+        uint32_t count = p_allocation.count;
+
+        auto next = p_allocator.freeBlocksByOffset.lower_bound(offset);
+
+        if (next != p_allocator.freeBlocksByOffset.begin())
+        {
+            auto previous = std::prev(next);
+
+            if (previous->first + previous->second == offset)
+            {
+                offset = previous->first;
+                count += previous->second;
+                RemoveFreeBlockBySize(p_allocator, previous->first, previous->second);
+                p_allocator.freeBlocksByOffset.erase(previous);
+            }
+        }
+
+        if (next != p_allocator.freeBlocksByOffset.end() && offset + count == next->first)
+        {
+            count += next->second;
+            RemoveFreeBlockBySize(p_allocator, next->first, next->second);
+            p_allocator.freeBlocksByOffset.erase(next);
+        }
+
+        AddFreeBlock(p_allocator, offset, count);
+
+        p_allocator.usedCount -= p_allocation.count;
+        p_allocator.allocationCount--;
+    }
+
+    static RangeAllocatorStats GetStats(const RangeAllocator& p_allocator)
+    {
+        RangeAllocatorStats stats;
+        stats.capacity = p_allocator.capacity;
+        stats.usedCount = p_allocator.usedCount;
+        stats.freeCount = p_allocator.capacity - p_allocator.usedCount;
+        stats.freeBlockCount = static_cast<uint32_t>(p_allocator.freeBlocksByOffset.size());
+        stats.allocationCount = p_allocator.allocationCount;
+
+        if (!p_allocator.freeBlocksBySize.empty())
+        {
+            stats.largestFreeBlock = p_allocator.freeBlocksBySize.rbegin()->first;
+        }
+
+        if (stats.capacity > 0)
+        {
+            stats.utilization = static_cast<float>(stats.usedCount) / static_cast<float>(stats.capacity);
+        }
+
+        if (stats.freeCount > 0)
+        {
+            stats.fragmentation = 1.0f - static_cast<float>(stats.largestFreeBlock) / static_cast<float>(stats.freeCount);
+        }
+
+        return stats;
+    }
+}
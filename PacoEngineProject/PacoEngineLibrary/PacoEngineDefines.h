@@ -1 +1,40 @@
 #pragma once
+
+//Rendering
+//Maximum number of frames the CPU may run ahead of the GPU, also the region count of streamed buffers
+#define PACO_MAX_FRAMES_IN_FLIGHT 3
+
+//Time a stream buffer waits on a region fence before waiting again, in nanoseconds
+#define PACO_STREAM_FENCE_TIMEOUT_NS 1000000
+
+//Texture units whose bindings are tracked by GLStateCache
+#define PACO_GL_STATE_TEXTURE_UNITS 16
+
+//Vertex buffer binding of per-instance data, binding 0 holds the mesh vertices
+#define PACO_INSTANCE_BINDING 1
+
+//Uniform block binding of the per-draw constants RenderQueue binds from a UniformArena
+#define PACO_DRAW_UNIFORM_BINDING 1
+
+//Maximum number of frames the main thread may simulate ahead of the render thread
+#define PACO_MAX_FRAME_LATENCY 2
+
+//Post-transform cache size MeshOptimizerFunctions measures with, FIFO like most GPUs
+#define PACO_MESH_OPTIMIZER_FIFO_CACHE_SIZE 16
+
+//LRU cache size modelled by the vertex cache optimisation, larger than the FIFO so it stays good on any cache size
+#define PACO_MESH_OPTIMIZER_LRU_CACHE_SIZE 32
+
+//Core
+//Last part of a limited frame that is busy-waited instead of slept, in nanoseconds
+#define PACO_FRAME_LIMITER_SPIN_NS 2000000
+
+//Simulation steps run at most in one frame before simulation time is dropped
+#define PACO_MAX_SIMULATION_STEPS_PER_FRAME 8
+
+//Profiler
+//Scopes recorded per thread before the profiler starts dropping them
+#define PACO_PROFILER_EVENTS_PER_THREAD 65536
+
+//GPU timestamp scopes per frame, every scope uses two queries
+#define PACO_PROFILER_GPU_SCOPES_PER_FRAME 32
@@ -0,0 +1,110 @@
+#pragma once
+
+//std
+#include <cstddef>
+#include <cstdint>
+
+//vendor
+#include <SDL3/SDL_log.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "Core/MappedFile.h"
+#include "Core/Profiler.h"
+#include "Rendering/CompressedTextureFormat.h"
+
+
+//Texture cooked offline by the TextureCooker tool, see CompressedTextureFormat.h.
+//Loading maps the file and hands every level to the driver as stored, nothing is decoded or converted.
+struct CompressedTexture
+{
+    GLuint texture = 0;
+    GLenum format = 0;
+    GLsizei width = 0;
+    GLsizei height = 0;
+    GLsizei levelCount = 0;
+
+    //Compressed bytes of all levels, what the texture takes in video memory
+    uint64_t dataSize = 0;
+};
+
+namespace CompressedTextureFunctions
+{
+    static bool IsFormatSupported(GLenum p_format)
+    {
+        return GLAD_GL_EXT_texture_compression_s3tc && (!CompressedTextureFormatFunctions::IsSrgb(p_format) || GLAD_GL_EXT_texture_sRGB);
+    }
+
+    //p_data holds a whole cooked file
+    static bool CreateFromMemory(CompressedTexture& p_compressedTexture, const uint8_t* p_data, size_t p_size)
+    {
+        PACO_PROFILE_SCOPE("CompressedTexture::Create");
+
+        const CompressedTextureHeader* header = nullptr;
+        const CompressedTextureLevel* levels = nullptr;
+
+        if (!CompressedTextureFormatFunctions::Validate(p_data, p_size, header, levels))
+        {
+            SDL_Log("Invalid compressed texture data");
+            return false;
+        }
+
+        if (!IsFormatSupported(header->format))
+        {
+            SDL_Log("Compressed texture format 0x%X is not supported by the driver", header->format);
+            return false;
+        }
+
+        p_compressedTexture.format = header->format;
+        p_compressedTexture.width = static_cast<GLsizei>(header->width);
+        p_compressedTexture.height = static_cast<GLsizei>(header->height);
+        p_compressedTexture.levelCount = static_cast<GLsizei>(header->levelCount);
+        p_compressedTexture.dataSize = 0;
+
+        glCreateTextures(GL_TEXTURE_2D, 1, &p_compressedTexture.texture);
+        glTextureStorage2D(p_compressedTexture.texture, p_compressedTexture.levelCount, header->format, p_compressedTexture.width, p_compressedTexture.height);
+        glTextureParameteri(p_compressedTexture.texture, GL_TEXTURE_MIN_FILTER, p_compressedTexture.levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTextureParameteri(p_compressedTexture.texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        for (GLsizei level = 0; level < p_compressedTexture.levelCount; level++)
+        {
+            const CompressedTextureLevel& textureLevel = levels[level];
+
+            glCompressedTextureSubImage2D(p_compressedTexture.texture, level, 0, 0, static_cast<GLsizei>(textureLevel.width), static_cast<GLsizei>(textureLevel.height),
+                header->format, static_cast<GLsizei>(textureLevel.size), p_data + textureLevel.offset);
+
+            p_compressedTexture.dataSize += textureLevel.size;
+        }
+
+        return true;
+    }
+
+    static bool Load(CompressedTexture& p_compressedTexture, const char* p_path)
+    {
+        MappedFile mappedFile;
+
+        if (!MappedFileFunctions::Open(mappedFile, p_path))
+        {
+            SDL_Log("Failed to map compressed texture %s", p_path);
+            return false;
+        }
+
+        bool isCreated = CreateFromMemory(p_compressedTexture, mappedFile.data, mappedFile.size);
+
+        //The driver copied the levels before glCompressedTextureSubImage2D returned
+        MappedFileFunctions::Close(mappedFile);
+
+        if (!isCreated)
+        {
+            SDL_Log("Failed to load compressed texture %s", p_path);
+        }
+
+        return isCreated;
+    }
+
+    static void Delete(CompressedTexture& p_compressedTexture)
+    {
+        glDeleteTextures(1, &p_compressedTexture.texture);
+        p_compressedTexture = CompressedTexture{};
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+//std
+#include <cstddef>
+#include <cstdint>
+
+//vendor
+#include <glad/glad/gl.h>
+
+
+//File layout of a cooked texture, every field little endian :
+//    CompressedTextureHeader
+//    CompressedTextureLevel[levelCount], level 0 is the full size image
+//    level data, each level starting on a multiple of compressedTextureDataAlignment
+//Levels hold S3TC blocks exactly as glCompressedTextureSubImage2D expects them, so a mapped file is uploaded as is.
+struct CompressedTextureHeader
+{
+    uint32_t magic = 0;
+    uint32_t version = 0;
+
+    //GL internal format, one of the BC1 or BC3 formats, sRGB or not
+    uint32_t format = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t levelCount = 0;
+};
+
+struct CompressedTextureLevel
+{
+    //From the start of the file
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+static_assert(sizeof(CompressedTextureHeader) == 24 && sizeof(CompressedTextureLevel) == 24, "Cooked texture layout must not depend on the compiler");
+
+namespace CompressedTextureFormatFunctions
+{
+    //"PTEX"
+    constexpr uint32_t magic = 0x58455450;
+    constexpr uint32_t version = 1;
+    constexpr uint64_t dataAlignment = 16;
+
+    static bool IsSupportedFormat(uint32_t p_format)
+    {
+        return p_format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || p_format == GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+            || p_format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT || p_format == GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+    }
+
+    //Bytes of one 4x4 block : 8 for BC1, 16 for BC3
+    static uint32_t GetBlockSize(uint32_t p_format)
+    {
+        return p_format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || p_format == GL_COMPRESSED_SRGB_S3TC_DXT1_EXT ? 8 : 16;
+    }
+
+    static uint64_t GetLevelSize(uint32_t p_format, uint32_t p_width, uint32_t p_height)
+    {
+        return static_cast<uint64_t>((p_width + 3) / 4) * ((p_height + 3) / 4) * GetBlockSize(p_format);
+    }
+
+    static bool IsSrgb(uint32_t p_format)
+    {
+        return p_format == GL_COMPRESSED_SRGB_S3TC_DXT1_EXT || p_format == GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+    }
+
+    //Levels of the full mip chain down to 1x1
+    static uint32_t GetMaxLevelCount(uint32_t p_width, uint32_t p_height)
+    {
+        uint32_t levelCount = 1;
+
+        for (uint32_t size = p_width > p_height ? p_width : p_height; size > 1; size >>= 1)
+        {
+            levelCount++;
+        }
+
+        return levelCount;
+    }
+
+    //Checks the header and that every level lies inside the p_size bytes of p_data.
+    //On success p_outHeader and p_outLevels point into p_data.
+    static bool Validate(const uint8_t* p_data, size_t p_size, const CompressedTextureHeader*& p_outHeader, const CompressedTextureLevel*& p_outLevels)
+    {
+        if (p_size < sizeof(CompressedTextureHeader))
+        {
+            return false;
+        }
+
+        const CompressedTextureHeader* header = reinterpret_cast<const CompressedTextureHeader*>(p_data);
+
+        if (header->magic != magic || header->version != version || !IsSupportedFormat(header->format) || header->width == 0 || header->height == 0
+            || header->levelCount == 0 || header->levelCount > GetMaxLevelCount(header->width, header->height)
+            || p_size < sizeof(CompressedTextureHeader) + sizeof(CompressedTextureLevel) * header->levelCount)
+        {
+            return false;
+        }
+
+        const CompressedTextureLevel* levels = reinterpret_cast<const CompressedTextureLevel*>(p_data + sizeof(CompressedTextureHeader));
+
+        for (uint32_t level = 0; level < header->levelCount; level++)
+        {
+            uint32_t expectedWidth = header->width >> level > 0 ? header->width >> level : 1;
+            uint32_t expectedHeight = header->height >> level > 0 ? header->height >> level : 1;
+
+            if (levels[level].width != expectedWidth || levels[level].height != expectedHeight
+                || levels[level].size != GetLevelSize(header->format, expectedWidth, expectedHeight)
+                || levels[level].offset > p_size || levels[level].size > p_size - levels[level].offset)
+            {
+                return false;
+            }
+        }
+
+        p_outHeader = header;
+        p_outLevels = levels;
+
+        return true;
+    }
+}
@@ -0,0 +1,522 @@
+#pragma once
+
+//std
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL_log.h>
+#include <glad/glad/gl.h>
+#include <stb_rect_pack.h>
+
+//engine
+#include "Core/Profiler.h"
+#include "Rendering/TextureArrayAtlas.h"
+
+
+//Identifies a region for as long as it lives, repacks move it but keep the handle valid
+struct DynamicAtlasHandle
+{
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
+struct DynamicAtlasEntry
+{
+    uint32_t page = 0;
+    uint32_t generation = 0;
+
+    //Rectangle reserved in the page, padding included
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    uint64_t lastUsedFrame = 0;
+    bool isLive = false;
+};
+
+//stb_rect_pack skyline of a page, kept on the heap as the context points into itself
+struct DynamicAtlasPacker
+{
+    stbrp_context context = {};
+    std::vector<stbrp_node> nodes;
+};
+
+struct DynamicAtlasPage
+{
+    std::unique_ptr<DynamicAtlasPacker> packer;
+
+    //Texture array layer the page currently lives in, repacks move pages between layers
+    unsigned int layer = 0;
+
+    //Texels reserved by live regions, and by removed ones the skyline cannot reuse until the page is repacked
+    uint64_t liveArea = 0;
+    uint64_t deadArea = 0;
+
+    bool isRepacking = false;
+};
+
+//New layout of one page, computed by the worker from the live regions of the page when it was queued
+struct DynamicAtlasRepack
+{
+    uint32_t page = 0;
+    std::vector<DynamicAtlasHandle> handles;
+    std::vector<stbrp_rect> rects;
+    std::unique_ptr<DynamicAtlasPacker> packer;
+    bool isPacked = false;
+    std::atomic<bool> isDone = false;
+};
+
+struct DynamicAtlasStats
+{
+    unsigned int regionCount = 0;
+    unsigned int insertCount = 0;
+    unsigned int failedInsertCount = 0;
+    unsigned int evictedCount = 0;
+    unsigned int repackCount = 0;
+
+    uint64_t liveArea = 0;
+    uint64_t deadArea = 0;
+    uint64_t totalArea = 0;
+};
+
+//Atlas filled at runtime with images of any size, for UI icons, generated thumbnails or user content.
+//Pages are layers of one GL_TEXTURE_2D_ARRAY, so everything it holds is drawn with a single texture bind.
+//Regions are packed on insert with stb_rect_pack. When no page has room, the least recently used regions are
+//evicted and the insert fails for this frame. The space of removed regions comes back when their page is repacked :
+//a worker computes the new layout, then Update moves the live regions on the GPU into a spare layer,
+//which becomes the page. Nothing is read back and no atlas is rebuilt on the calling thread.
+//stb_rect_pack.h is compiled by the application : exactly one of its sources defines STB_RECT_PACK_IMPLEMENTATION before including it.
+struct DynamicAtlas
+{
+    GLuint texture = 0;
+    GLsizei pageSize = 0;
+    GLsizei padding = 0;
+
+    //Removed texels over reserved texels of a page above which the page is repacked
+    float fragmentationThreshold = 0.25f;
+
+    std::vector<DynamicAtlasPage> pages;
+    unsigned int spareLayer = 0;
+
+    std::vector<DynamicAtlasEntry> entries;
+    std::vector<uint32_t> freeEntries;
+    uint64_t frame = 0;
+
+    //Set when an insert found no room, the most fragmented page is repacked even below the threshold
+    bool isFull = false;
+
+    //One repack at a time, there is a single spare layer
+    std::deque<DynamicAtlasRepack> repacks;
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<DynamicAtlasRepack*> queuedRepacks;
+    bool stopRequested = false;
+
+    DynamicAtlasStats stats;
+};
+
+namespace DynamicAtlasFunctions
+{
+    static std::unique_ptr<DynamicAtlasPacker> CreatePacker(GLsizei p_pageSize)
+    {
+        std::unique_ptr<DynamicAtlasPacker> packer = std::make_unique<DynamicAtlasPacker>();
+        packer->nodes.resize(static_cast<size_t>(p_pageSize));
+        stbrp_init_target(&packer->context, p_pageSize, p_pageSize, packer->nodes.data(), p_pageSize);
+
+        return packer;
+    }
+
+    static void RunWorker(DynamicAtlas& p_atlas)
+    {
+        PACO_PROFILE_THREAD_NAME("Dynamic Atlas");
+
+        while (true)
+        {
+            DynamicAtlasRepack* repack = nullptr;
+
+            {
+                std::unique_lock<std::mutex> lock(p_atlas.mutex);
+                p_atlas.condition.wait(lock, [&p_atlas]() { return p_atlas.stopRequested || !p_atlas.queuedRepacks.empty(); });
+
+                if (p_atlas.stopRequested)
+                {
+                    break;
+                }
+
+                repack = p_atlas.queuedRepacks.front();
+                p_atlas.queuedRepacks.pop_front();
+            }
+
+            PACO_PROFILE_SCOPE("RepackAtlasPage");
+
+            //All at once, which packs tighter than the incremental inserts that filled the page
+            repack->isPacked = stbrp_pack_rects(&repack->packer->context, repack->rects.data(), static_cast<int>(repack->rects.size())) == 1;
+            repack->isDone.store(true, std::memory_order_release);
+        }
+    }
+
+    //p_pageCount pages of p_pageSize x p_pageSize RGBA8 texels, one more layer is allocated as the repack target
+    static bool Create(DynamicAtlas& p_atlas, GLsizei p_pageSize, unsigned int p_pageCount, GLsizei p_padding = 1, float p_fragmentationThreshold = 0.25f)
+    {
+        GLint maxLayers = 0;
+        glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+
+        if (p_pageCount == 0 || static_cast<GLint>(p_pageCount) + 1 > maxLayers)
+        {
+            SDL_Log("DynamicAtlas page count must be between 1 and %d, got %u", maxLayers - 1, p_pageCount);
+            return false;
+        }
+
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &p_atlas.texture);
+        glTextureStorage3D(p_atlas.texture, 1, GL_RGBA8, p_pageSize, p_pageSize, static_cast<GLsizei>(p_pageCount) + 1);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        p_atlas.pageSize = p_pageSize;
+        p_atlas.padding = p_padding;
+        p_atlas.fragmentationThreshold = p_fragmentationThreshold;
+        p_atlas.pages.resize(p_pageCount);
+
+        for (unsigned int page = 0; page < p_pageCount; page++)
+        {
+            p_atlas.pages[page].packer = CreatePacker(p_pageSize);
+            p_atlas.pages[page].layer = page;
+        }
+
+        p_atlas.spareLayer = p_pageCount;
+        p_atlas.thread = std::thread(RunWorker, std::ref(p_atlas));
+
+        return true;
+    }
+
+    static bool IsLive(const DynamicAtlas& p_atlas, DynamicAtlasHandle p_handle)
+    {
+        return p_handle.index < p_atlas.entries.size() && p_atlas.entries[p_handle.index].isLive && p_atlas.entries[p_handle.index].generation == p_handle.generation;
+    }
+
+    static void RemoveEntry(DynamicAtlas& p_atlas, uint32_t p_index)
+    {
+        DynamicAtlasEntry& entry = p_atlas.entries[p_index];
+        DynamicAtlasPage& page = p_atlas.pages[entry.page];
+        uint64_t area = static_cast<uint64_t>(entry.width) * entry.height;
+
+        page.liveArea -= area;
+        page.deadArea += area;
+        entry.isLive = false;
+        p_atlas.freeEntries.push_back(p_index);
+    }
+
+    //The region stops being drawable right away, its texels are reclaimed by the next repack of its page
+    static void Remove(DynamicAtlas& p_atlas, DynamicAtlasHandle p_handle)
+    {
+        if (IsLive(p_atlas, p_handle))
+        {
+            RemoveEntry(p_atlas, p_handle.index);
+        }
+    }
+
+    //Evicts regions not used this frame, oldest first, until p_area texels are freed.
+    //Pages being repacked are left alone, their regions are about to move.
+    static void EvictLeastRecentlyUsed(DynamicAtlas& p_atlas, uint64_t p_area)
+    {
+        std::vector<uint32_t> candidates;
+
+        for (uint32_t index = 0; index < p_atlas.entries.size(); index++)
+        {
+            const DynamicAtlasEntry& entry = p_atlas.entries[index];
+
+            if (entry.isLive && entry.lastUsedFrame < p_atlas.frame && !p_atlas.pages[entry.page].isRepacking)
+            {
+                candidates.push_back(index);
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+            [&p_atlas](uint32_t p_left, uint32_t p_right) { return p_atlas.entries[p_left].lastUsedFrame < p_atlas.entries[p_right].lastUsedFrame; });
+
+        uint64_t evictedArea = 0;
+
+        for (uint32_t index : candidates)
+        {
+            if (evictedArea >= p_area)
+            {
+                break;
+            }
+
+            evictedArea += static_cast<uint64_t>(p_atlas.entries[index].width) * p_atlas.entries[index].height;
+            RemoveEntry(p_atlas, index);
+            p_atlas.stats.evictedCount++;
+        }
+    }
+
+    //Copies RGBA8 p_pixels into a page. Returns false when it is larger than a page or when no page has room,
+    //in which case least recently used regions are evicted so a later insert succeeds once their page is repacked.
+    static bool Insert(DynamicAtlas& p_atlas, const uint8_t* p_pixels, GLsizei p_width, GLsizei p_height, DynamicAtlasHandle& p_outHandle)
+    {
+        PACO_PROFILE_SCOPE("DynamicAtlas::Insert");
+
+        stbrp_rect rect = {};
+        rect.w = p_width + p_atlas.padding * 2;
+        rect.h = p_height + p_atlas.padding * 2;
+
+        if (rect.w > p_atlas.pageSize || rect.h > p_atlas.pageSize)
+        {
+            SDL_Log("Image of %dx%d does not fit in a DynamicAtlas page of %d", p_width, p_height, p_atlas.pageSize);
+            p_atlas.stats.failedInsertCount++;
+            return false;
+        }
+
+        uint32_t pageIndex = 0;
+
+        for (; pageIndex < p_atlas.pages.size(); pageIndex++)
+        {
+            DynamicAtlasPage& page = p_atlas.pages[pageIndex];
+
+            if (!page.isRepacking && stbrp_pack_rects(&page.packer->context, &rect, 1) == 1)
+            {
+                break;
+            }
+        }
+
+        if (pageIndex == p_atlas.pages.size())
+        {
+            EvictLeastRecentlyUsed(p_atlas, static_cast<uint64_t>(rect.w) * rect.h);
+            p_atlas.isFull = true;
+            p_atlas.stats.failedInsertCount++;
+            return false;
+        }
+
+        uint32_t index = 0;
+
+        if (!p_atlas.freeEntries.empty())
+        {
+            index = p_atlas.freeEntries.back();
+            p_atlas.freeEntries.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(p_atlas.entries.size());
+            p_atlas.entries.emplace_back();
+        }
+
+        DynamicAtlasEntry& entry = p_atlas.entries[index];
+        entry.page = pageIndex;
+        entry.generation++;
+        entry.x = rect.x;
+        entry.y = rect.y;
+        entry.width = rect.w;
+        entry.height = rect.h;
+        entry.lastUsedFrame = p_atlas.frame;
+        entry.isLive = true;
+
+        DynamicAtlasPage& page = p_atlas.pages[pageIndex];
+        page.liveArea += static_cast<uint64_t>(rect.w) * rect.h;
+
+        TextureArrayAtlasFunctions::UploadPadded(p_atlas.texture, page.layer, rect.x, rect.y, p_pixels, p_width, p_height, p_atlas.padding);
+
+        p_outHandle = { index, entry.generation };
+        p_atlas.stats.insertCount++;
+
+        return true;
+    }
+
+    //Fills p_outRegion with where the region is this frame and marks it used. The region may move on the next Update,
+    //so it is looked up every frame rather than stored. Returns false once the region was evicted or removed.
+    static bool GetRegion(DynamicAtlas& p_atlas, DynamicAtlasHandle p_handle, TextureAtlasRegion& p_outRegion)
+    {
+        if (!IsLive(p_atlas, p_handle))
+        {
+            return false;
+        }
+
+        DynamicAtlasEntry& entry = p_atlas.entries[p_handle.index];
+        entry.lastUsedFrame = p_atlas.frame;
+
+        float pageSize = static_cast<float>(p_atlas.pageSize);
+
+        p_outRegion.texture = p_atlas.texture;
+        p_outRegion.layer = p_atlas.pages[entry.page].layer;
+        p_outRegion.u0 = static_cast<float>(entry.x + p_atlas.padding) / pageSize;
+        p_outRegion.v0 = static_cast<float>(entry.y + p_atlas.padding) / pageSize;
+        p_outRegion.u1 = static_cast<float>(entry.x + entry.width - p_atlas.padding) / pageSize;
+        p_outRegion.v1 = static_cast<float>(entry.y + entry.height - p_atlas.padding) / pageSize;
+
+        return true;
+    }
+
+    //Moves the live regions of a finished repack into the spare layer, which takes the place of the page
+    static void ApplyRepack(DynamicAtlas& p_atlas, DynamicAtlasRepack& p_repack)
+    {
+        PACO_PROFILE_SCOPE("DynamicAtlas::ApplyRepack");
+
+        DynamicAtlasPage& page = p_atlas.pages[p_repack.page];
+        page.isRepacking = false;
+
+        //Cannot happen with the regions the page already held, the old layout stays if it does
+        if (!p_repack.isPacked)
+        {
+            SDL_Log("DynamicAtlas failed to repack page %u", p_repack.page);
+            return;
+        }
+
+        uint64_t liveArea = 0;
+        uint64_t deadArea = 0;
+
+        for (size_t region = 0; region < p_repack.handles.size(); region++)
+        {
+            const stbrp_rect& rect = p_repack.rects[region];
+            uint64_t area = static_cast<uint64_t>(rect.w) * rect.h;
+
+            //Removed while the worker was packing, its new place stays reserved until the next repack
+            if (!IsLive(p_atlas, p_repack.handles[region]))
+            {
+                deadArea += area;
+                continue;
+            }
+
+            DynamicAtlasEntry& entry = p_atlas.entries[p_repack.handles[region].index];
+
+            glCopyImageSubData(p_atlas.texture, GL_TEXTURE_2D_ARRAY, 0, entry.x, entry.y, static_cast<GLint>(page.layer),
+                p_atlas.texture, GL_TEXTURE_2D_ARRAY, 0, rect.x, rect.y, static_cast<GLint>(p_atlas.spareLayer), rect.w, rect.h, 1);
+
+            entry.x = rect.x;
+            entry.y = rect.y;
+            liveArea += area;
+        }
+
+        std::swap(page.layer, p_atlas.spareLayer);
+        page.packer = std::move(p_repack.packer);
+        page.liveArea = liveArea;
+        page.deadArea = deadArea;
+
+        p_atlas.stats.repackCount++;
+    }
+
+    static void QueueRepack(DynamicAtlas& p_atlas, uint32_t p_page)
+    {
+        DynamicAtlasRepack& repack = p_atlas.repacks.emplace_back();
+        repack.page = p_page;
+        repack.packer = CreatePacker(p_atlas.pageSize);
+
+        for (uint32_t index = 0; index < p_atlas.entries.size(); index++)
+        {
+            const DynamicAtlasEntry& entry = p_atlas.entries[index];
+
+            if (entry.isLive && entry.page == p_page)
+            {
+                stbrp_rect rect = {};
+                rect.id = static_cast<int>(repack.rects.size());
+                rect.w = entry.width;
+                rect.h = entry.height;
+
+                repack.handles.push_back({ index, entry.generation });
+                repack.rects.push_back(rect);
+            }
+        }
+
+        p_atlas.pages[p_page].isRepacking = true;
+
+        {
+            std::lock_guard<std::mutex> lock(p_atlas.mutex);
+            p_atlas.queuedRepacks.push_back(&repack);
+        }
+
+        p_atlas.condition.notify_one();
+    }
+
+    //Once per frame, before the regions of the frame are looked up. Applies a finished repack
+    //and queues the next one when a page is fragmented enough or an insert found no room.
+    static void Update(DynamicAtlas& p_atlas)
+    {
+        PACO_PROFILE_SCOPE("DynamicAtlas::Update");
+
+        p_atlas.frame++;
+
+        if (!p_atlas.repacks.empty() && p_atlas.repacks.front().isDone.load(std::memory_order_acquire))
+        {
+            ApplyRepack(p_atlas, p_atlas.repacks.front());
+            p_atlas.repacks.pop_front();
+        }
+
+        if (!p_atlas.repacks.empty())
+        {
+            return;
+        }
+
+        uint32_t mostFragmentedPage = UINT32_MAX;
+        float highestFragmentation = 0.0f;
+
+        for (uint32_t page = 0; page < p_atlas.pages.size(); page++)
+        {
+            const DynamicAtlasPage& atlasPage = p_atlas.pages[page];
+            uint64_t reservedArea = atlasPage.liveArea + atlasPage.deadArea;
+            float fragmentation = reservedArea > 0 ? static_cast<float>(atlasPage.deadArea) / static_cast<float>(reservedArea) : 0.0f;
+
+            if (atlasPage.deadArea > 0 && fragmentation > highestFragmentation)
+            {
+                highestFragmentation = fragmentation;
+                mostFragmentedPage = page;
+            }
+        }
+
+        if (mostFragmentedPage != UINT32_MAX && (highestFragmentation > p_atlas.fragmentationThreshold || p_atlas.isFull))
+        {
+            QueueRepack(p_atlas, mostFragmentedPage);
+            p_atlas.isFull = false;
+        }
+    }
+
+    static DynamicAtlasStats GetStats(const DynamicAtlas& p_atlas)
+    {
+        DynamicAtlasStats stats = p_atlas.stats;
+        stats.regionCount = static_cast<unsigned int>(p_atlas.entries.size() - p_atlas.freeEntries.size());
+        stats.totalArea = static_cast<uint64_t>(p_atlas.pageSize) * p_atlas.pageSize * p_atlas.pages.size();
+
+        for (const DynamicAtlasPage& page : p_atlas.pages)
+        {
+            stats.liveArea += page.liveArea;
+            stats.deadArea += page.deadArea;
+        }
+
+        return stats;
+    }
+
+    //Waits for the repack in flight, if any
+    static void Delete(DynamicAtlas& p_atlas)
+    {
+        if (p_atlas.thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(p_atlas.mutex);
+                p_atlas.stopRequested = true;
+            }
+
+            p_atlas.condition.notify_one();
+            p_atlas.thread.join();
+        }
+
+        glDeleteTextures(1, &p_atlas.texture);
+
+        p_atlas.pages.clear();
+        p_atlas.entries.clear();
+        p_atlas.freeEntries.clear();
+        p_atlas.repacks.clear();
+        p_atlas.queuedRepacks.clear();
+        p_atlas.texture = 0;
+    }
+}
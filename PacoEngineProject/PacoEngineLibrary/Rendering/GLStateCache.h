@@ -0,0 +1,273 @@
+#pragma once
+
+//std
+#include <cstdint>
+
+//vendor
+#include <glad/glad/gl.h>
+
+//engine
+#include "PacoEngineDefines.h"
+
+
+//Value stored in a cached slot when the real GL value is not known, the next call always reaches the driver
+constexpr GLuint glStateUnknown = 0xFFFFFFFF;
+
+struct GLStateCounters
+{
+    unsigned int issuedCount = 0;
+    unsigned int skippedCount = 0;
+};
+
+//Shadow copy of the GL context state the engine changes.
+//Every state change goes through GLStateCacheFunctions, calls that would not change anything are skipped.
+//One cache per GL context, used only on the thread owning that context.
+//Code changing GL state behind the cache's back must call Invalidate afterwards,
+//programs, vertex arrays, buffers and textures must be forgotten before being deleted since GL reuses names.
+struct GLStateCache
+{
+    GLuint program = glStateUnknown;
+    GLuint vertexArray = glStateUnknown;
+
+    //Buffers attached to binding 0 and as element buffer of the bound vertex array, forgotten whenever it changes
+    GLuint vertexBuffer = glStateUnknown;
+    GLuint elementBuffer = glStateUnknown;
+
+    GLuint textures[PACO_GL_STATE_TEXTURE_UNITS] = {};
+
+    GLuint blendEnabled = glStateUnknown;
+    GLenum blendSourceFactor = glStateUnknown;
+    GLenum blendDestinationFactor = glStateUnknown;
+
+    GLuint depthTestEnabled = glStateUnknown;
+    GLuint depthWriteEnabled = glStateUnknown;
+    GLenum depthFunction = glStateUnknown;
+
+    GLuint cullFaceEnabled = glStateUnknown;
+    GLenum cullFaceMode = glStateUnknown;
+
+    GLStateCounters frameCounters;
+    GLStateCounters lastFrameCounters;
+};
+
+namespace GLStateCacheFunctions
+{
+    //Forgets every cached value, the counters are kept
+    static void Invalidate(GLStateCache& p_stateCache)
+    {
+        p_stateCache.program = glStateUnknown;
+        p_stateCache.vertexArray = glStateUnknown;
+        p_stateCache.vertexBuffer = glStateUnknown;
+        p_stateCache.elementBuffer = glStateUnknown;
+
+        for (GLuint& texture : p_stateCache.textures)
+        {
+            texture = glStateUnknown;
+        }
+
+        p_stateCache.blendEnabled = glStateUnknown;
+        p_stateCache.blendSourceFactor = glStateUnknown;
+        p_stateCache.blendDestinationFactor = glStateUnknown;
+        p_stateCache.depthTestEnabled = glStateUnknown;
+        p_stateCache.depthWriteEnabled = glStateUnknown;
+        p_stateCache.depthFunction = glStateUnknown;
+        p_stateCache.cullFaceEnabled = glStateUnknown;
+        p_stateCache.cullFaceMode = glStateUnknown;
+    }
+
+    static void Create(GLStateCache& p_stateCache)
+    {
+        p_stateCache = GLStateCache{};
+        Invalidate(p_stateCache);
+    }
+
+    //Returns true when p_value differs from the cached slot and stores it, counts the call either way
+    static bool Update(GLStateCache& p_stateCache, GLuint& p_cachedValue, GLuint p_value)
+    {
+        if (p_cachedValue == p_value)
+        {
+            p_stateCache.frameCounters.skippedCount++;
+            return false;
+        }
+
+        p_cachedValue = p_value;
+        p_stateCache.frameCounters.issuedCount++;
+        return true;
+    }
+
+    static void SetCapability(GLStateCache& p_stateCache, GLuint& p_cachedValue, GLenum p_capability, bool p_enabled)
+    {
+        if (!Update(p_stateCache, p_cachedValue, p_enabled ? GL_TRUE : GL_FALSE))
+        {
+            return;
+        }
+
+        if (p_enabled)
+        {
+            glEnable(p_capability);
+        }
+        else
+        {
+            glDisable(p_capability);
+        }
+    }
+
+    static void UseProgram(GLStateCache& p_stateCache, GLuint p_program)
+    {
+        if (Update(p_stateCache, p_stateCache.program, p_program))
+        {
+            glUseProgram(p_program);
+        }
+    }
+
+    static void BindVertexArray(GLStateCache& p_stateCache, GLuint p_vertexArray)
+    {
+        if (Update(p_stateCache, p_stateCache.vertexArray, p_vertexArray))
+        {
+            glBindVertexArray(p_vertexArray);
+            p_stateCache.vertexBuffer = glStateUnknown;
+            p_stateCache.elementBuffer = glStateUnknown;
+        }
+    }
+
+    //Attaches the buffers to the bound vertex array, for vertex arrays shared by meshes of the same layout
+    static void BindVertexBuffers(GLStateCache& p_stateCache, GLuint p_vertexBuffer, GLsizei p_stride, GLuint p_elementBuffer)
+    {
+        if (Update(p_stateCache, p_stateCache.vertexBuffer, p_vertexBuffer))
+        {
+            glVertexArrayVertexBuffer(p_stateCache.vertexArray, 0, p_vertexBuffer, 0, p_stride);
+        }
+
+        if (Update(p_stateCache, p_stateCache.elementBuffer, p_elementBuffer))
+        {
+            glVertexArrayElementBuffer(p_stateCache.vertexArray, p_elementBuffer);
+        }
+    }
+
+    //Units past PACO_GL_STATE_TEXTURE_UNITS are not tracked and always bound
+    static void BindTextureUnit(GLStateCache& p_stateCache, GLuint p_unit, GLuint p_texture)
+    {
+        if (p_unit >= PACO_GL_STATE_TEXTURE_UNITS)
+        {
+            p_stateCache.frameCounters.issuedCount++;
+            glBindTextureUnit(p_unit, p_texture);
+            return;
+        }
+
+        if (Update(p_stateCache, p_stateCache.textures[p_unit], p_texture))
+        {
+            glBindTextureUnit(p_unit, p_texture);
+        }
+    }
+
+    static void SetBlend(GLStateCache& p_stateCache, bool p_enabled)
+    {
+        SetCapability(p_stateCache, p_stateCache.blendEnabled, GL_BLEND, p_enabled);
+    }
+
+    static void SetBlendFunction(GLStateCache& p_stateCache, GLenum p_sourceFactor, GLenum p_destinationFactor)
+    {
+        if (p_stateCache.blendSourceFactor == p_sourceFactor && p_stateCache.blendDestinationFactor == p_destinationFactor)
+        {
+            p_stateCache.frameCounters.skippedCount++;
+            return;
+        }
+
+        p_stateCache.blendSourceFactor = p_sourceFactor;
+        p_stateCache.blendDestinationFactor = p_destinationFactor;
+        p_stateCache.frameCounters.issuedCount++;
+
+        glBlendFunc(p_sourceFactor, p_destinationFactor);
+    }
+
+    static void SetDepthTest(GLStateCache& p_stateCache, bool p_enabled)
+    {
+        SetCapability(p_stateCache, p_stateCache.depthTestEnabled, GL_DEPTH_TEST, p_enabled);
+    }
+
+    static void SetDepthWrite(GLStateCache& p_stateCache, bool p_enabled)
+    {
+        if (Update(p_stateCache, p_stateCache.depthWriteEnabled, p_enabled ? GL_TRUE : GL_FALSE))
+        {
+            glDepthMask(p_enabled ? GL_TRUE : GL_FALSE);
+        }
+    }
+
+    static void SetDepthFunction(GLStateCache& p_stateCache, GLenum p_function)
+    {
+        if (Update(p_stateCache, p_stateCache.depthFunction, p_function))
+        {
+            glDepthFunc(p_function);
+        }
+    }
+
+    static void SetCullFace(GLStateCache& p_stateCache, bool p_enabled)
+    {
+        SetCapability(p_stateCache, p_stateCache.cullFaceEnabled, GL_CULL_FACE, p_enabled);
+    }
+
+    static void SetCullFaceMode(GLStateCache& p_stateCache, GLenum p_mode)
+    {
+        if (Update(p_stateCache, p_stateCache.cullFaceMode, p_mode))
+        {
+            glCullFace(p_mode);
+        }
+    }
+
+    //Objects about to be deleted must be forgotten, GL may hand the same name out again
+    static void ForgetProgram(GLStateCache& p_stateCache, GLuint p_program)
+    {
+        if (p_stateCache.program == p_program)
+        {
+            p_stateCache.program = glStateUnknown;
+        }
+    }
+
+    static void ForgetVertexArray(GLStateCache& p_stateCache, GLuint p_vertexArray)
+    {
+        if (p_stateCache.vertexArray == p_vertexArray)
+        {
+            p_stateCache.vertexArray = glStateUnknown;
+        }
+    }
+
+    static void ForgetBuffer(GLStateCache& p_stateCache, GLuint p_buffer)
+    {
+        if (p_stateCache.vertexBuffer == p_buffer)
+        {
+            p_stateCache.vertexBuffer = glStateUnknown;
+        }
+
+        if (p_stateCache.elementBuffer == p_buffer)
+        {
+            p_stateCache.elementBuffer = glStateUnknown;
+        }
+    }
+
+    static void ForgetTexture(GLStateCache& p_stateCache, GLuint p_texture)
+    {
+        for (GLuint& texture : p_stateCache.textures)
+        {
+            if (texture == p_texture)
+            {
+                texture = glStateUnknown;
+            }
+        }
+    }
+
+    static void BeginFrame(GLStateCache& p_stateCache)
+    {
+        p_stateCache.frameCounters = GLStateCounters{};
+    }
+
+    static void EndFrame(GLStateCache& p_stateCache)
+    {
+        p_stateCache.lastFrameCounters = p_stateCache.frameCounters;
+    }
+
+    //Counters of the last finished frame
+    static const GLStateCounters& GetCounters(const GLStateCache& p_stateCache)
+    {
+        return p_stateCache.lastFrameCounters;
+    }
+}
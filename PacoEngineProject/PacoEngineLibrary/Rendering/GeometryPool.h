@@ -0,0 +1,127 @@
+#pragma once
+
+//std
+#include <cstdint>
+
+//vendor
+#include <SDL3/SDL_log.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "Core/RangeAllocator.h"
+#include "Rendering/RenderComponent.h"
+
+
+//Vertex and index slices of one mesh inside a GeometryPool, counts are in vertices and indices
+struct MeshAllocation
+{
+    RangeAllocation vertices;
+    RangeAllocation indices;
+};
+
+struct GeometryPoolStats
+{
+    RangeAllocatorStats vertexStats;
+    RangeAllocatorStats indexStats;
+};
+
+//One large immutable VBO/EBO pair shared by every mesh of a vertex layout.
+//Meshes get (offset, count) slices from two RangeAllocators and are drawn with base vertex draws,
+//so any number of meshes is drawn from a single bound VAO without creating GL objects per mesh.
+//Mesh indices stay relative to the mesh's first vertex, so 16 bit indices work for any pool size
+//as long as every single mesh has fewer than 65536 vertices.
+struct GeometryPool
+{
+    RenderComponent renderComponent;
+    RangeAllocator vertexAllocator;
+    RangeAllocator indexAllocator;
+};
+
+namespace GeometryPoolFunctions
+{
+    template<typename TVertexType, typename TIndexType = uint32_t>
+    static void Create(GeometryPool& p_geometryPool, unsigned int p_vertexCapacity, unsigned int p_indexCapacity)
+    {
+        RenderComponent& renderComponent = p_geometryPool.renderComponent;
+
+        RenderComponentFunctions::Create(renderComponent);
+        RenderComponentFunctions::PreallocateBuffersMemory<TVertexType, TIndexType>(renderComponent, p_vertexCapacity, p_indexCapacity);
+        RenderComponentFunctions::SetAttributeFormats<TVertexType>(renderComponent);
+        RenderComponentFunctions::LinkBuffers<TVertexType>(renderComponent, p_vertexCapacity);
+
+        RangeAllocatorFunctions::Create(p_geometryPool.vertexAllocator, p_vertexCapacity);
+        RangeAllocatorFunctions::Create(p_geometryPool.indexAllocator, p_indexCapacity);
+    }
+
+    //Reserves room for the mesh and uploads it, returns false when the pool has no free slice large enough.
+    //TIndexType must be the index type the pool was created with.
+    template<typename TVertexType, typename TIndexType>
+    static bool AllocateMesh(GeometryPool& p_geometryPool, const TVertexType* p_vertices, unsigned int p_vertexCount, const TIndexType* p_indices, unsigned int p_indexCount, MeshAllocation& p_outMesh)
+    {
+        if (IndexTypeTraits<TIndexType>::glType != p_geometryPool.renderComponent.indexType)
+        {
+            SDL_Log("GeometryPool mesh indices do not match the index type of the pool");
+            return false;
+        }
+
+        if (p_vertexCount > IndexTypeTraits<TIndexType>::maxVertexCount)
+        {
+            SDL_Log("GeometryPool mesh of %u vertices cannot be addressed by its index type", p_vertexCount);
+            return false;
+        }
+
+        if (!RangeAllocatorFunctions::Allocate(p_geometryPool.vertexAllocator, p_vertexCount, p_outMesh.vertices))
+        {
+            SDL_Log("GeometryPool out of vertex space for a mesh of %u vertices", p_vertexCount);
+            return false;
+        }
+
+        if (!RangeAllocatorFunctions::Allocate(p_geometryPool.indexAllocator, p_indexCount, p_outMesh.indices))
+        {
+            SDL_Log("GeometryPool out of index space for a mesh of %u indices", p_indexCount);
+            RangeAllocatorFunctions::Free(p_geometryPool.vertexAllocator, p_outMesh.vertices);
+            p_outMesh = MeshAllocation{};
+            return false;
+        }
+
+        GLintptr vertexOffset = sizeof(TVertexType) * static_cast<GLintptr>(p_outMesh.vertices.offset);
+        GLintptr indexOffset = sizeof(TIndexType) * static_cast<GLintptr>(p_outMesh.indices.offset);
+
+        RenderComponentFunctions::UpdateBuffersData<TVertexType, TIndexType>(p_geometryPool.renderComponent, p_vertices, p_indices, p_vertexCount, p_indexCount, vertexOffset, indexOffset);
+
+        return true;
+    }
+
+    static void FreeMesh(GeometryPool& p_geometryPool, MeshAllocation& p_mesh)
+    {
+        RangeAllocatorFunctions::Free(p_geometryPool.vertexAllocator, p_mesh.vertices);
+        RangeAllocatorFunctions::Free(p_geometryPool.indexAllocator, p_mesh.indices);
+        p_mesh = MeshAllocation{};
+    }
+
+    static void Bind(GeometryPool& p_geometryPool, GLStateCache& p_stateCache)
+    {
+        RenderComponentFunctions::Bind(p_geometryPool.renderComponent, p_stateCache);
+    }
+
+    //The pool must be bound
+    static void DrawMesh(const GeometryPool& p_geometryPool, const MeshAllocation& p_mesh)
+    {
+        RenderComponentFunctions::DrawElements(p_geometryPool.renderComponent, p_mesh.indices.count, p_mesh.indices.offset, p_mesh.vertices.offset);
+    }
+
+    static GeometryPoolStats GetStats(const GeometryPool& p_geometryPool)
+    {
+        GeometryPoolStats stats;
+        stats.vertexStats = RangeAllocatorFunctions::GetStats(p_geometryPool.vertexAllocator);
+        stats.indexStats = RangeAllocatorFunctions::GetStats(p_geometryPool.indexAllocator);
+
+        return stats;
+    }
+
+    static void Delete(GeometryPool& p_geometryPool)
+    {
+        RenderComponentFunctions::Delete(p_geometryPool.renderComponent);
+        p_geometryPool = GeometryPool{};
+    }
+}
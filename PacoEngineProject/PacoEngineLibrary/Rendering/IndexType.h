@@ -0,0 +1,57 @@
+#pragma once
+
+//std
+#include <cstdint>
+
+//vendor
+#include <glad/glad/gl.h>
+
+
+//GL enum and limits of an index type, only uint16_t and uint32_t are valid index types
+template<typename TIndexType>
+struct IndexTypeTraits;
+
+template<>
+struct IndexTypeTraits<uint16_t>
+{
+    static constexpr GLenum glType = GL_UNSIGNED_SHORT;
+
+    //Vertices addressable from one base vertex
+    static constexpr uint32_t maxVertexCount = 65536;
+};
+
+template<>
+struct IndexTypeTraits<uint32_t>
+{
+    static constexpr GLenum glType = GL_UNSIGNED_INT;
+    static constexpr uint32_t maxVertexCount = 0xFFFFFFFF;
+};
+
+namespace IndexTypeFunctions
+{
+    static GLsizeiptr GetSize(GLenum p_indexType)
+    {
+        return p_indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    }
+
+    //Smallest index type able to address p_vertexCount vertices
+    static GLenum Select(uint32_t p_vertexCount)
+    {
+        return p_vertexCount <= IndexTypeTraits<uint16_t>::maxVertexCount ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    }
+
+    //Byte offset of p_firstIndex cast for the glDraw*Elements* calls
+    static const void* GetOffset(GLenum p_indexType, uint32_t p_firstIndex)
+    {
+        return reinterpret_cast<const void*>(GetSize(p_indexType) * static_cast<GLsizeiptr>(p_firstIndex));
+    }
+
+    //Narrows 32 bit indices to 16 bit, every index must be below 65536
+    static void Narrow(const uint32_t* p_indices, uint32_t p_indexCount, uint16_t* p_outIndices)
+    {
+        for (uint32_t index = 0; index < p_indexCount; index++)
+        {
+            p_outIndices[index] = static_cast<uint16_t>(p_indices[index]);
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+//std
+#include <array>
+#include <cstddef>
+
+//vendor
+#include <glad/glad/gl.h>
+
+//engine
+#include "Core/Profiler.h"
+#include "PacoEngineDefines.h"
+#include "Rendering/GLStateCache.h"
+#include "Rendering/RenderComponent.h"
+
+
+//Per-instance data of a 2D quad, read once per instance through binding PACO_INSTANCE_BINDING.
+//Position and scale share location 4 as one vec4, locations start at 4 so they never collide with the mesh's own attributes.
+struct QuadInstance
+{
+    float x, y;
+    float scaleX, scaleY;
+    float rotation;
+    float r, g, b, a;
+    float u0, v0, u1, v1;
+
+    static const std::array<VertexAttribute, 4> attributes;
+};
+
+constexpr std::array<VertexAttribute, 4> QuadInstance::attributes =
+{{
+    { 4, 4, GL_FLOAT, GL_FALSE, offsetof(QuadInstance, x) },
+    { 5, 1, GL_FLOAT, GL_FALSE, offsetof(QuadInstance, rotation) },
+    { 6, 4, GL_FLOAT, GL_FALSE, offsetof(QuadInstance, r) },
+    { 7, 4, GL_FLOAT, GL_FALSE, offsetof(QuadInstance, u0) },
+}};
+
+//One mesh drawn many times with a single glDrawElementsInstanced.
+//The mesh lives in renderComponent (binding 0), per-instance data in instanceBuffer (binding PACO_INSTANCE_BINDING, divisor 1).
+//The instance buffer is immutable storage, it is replaced by a larger one when more instances are uploaded than it holds.
+struct InstancedRenderComponent
+{
+    RenderComponent renderComponent;
+    GLuint instanceBuffer = 0;
+    GLsizei instanceStride = 0;
+    unsigned int instanceCapacity = 0;
+    unsigned int instanceCount = 0;
+
+    //Number of times the instance buffer had to be replaced, should stop growing after the first frames
+    unsigned int growCount = 0;
+};
+
+namespace InstancedRenderComponentFunctions
+{
+    static void CreateInstanceBuffer(InstancedRenderComponent& p_instancedComponent, unsigned int p_instanceCapacity)
+    {
+        glCreateBuffers(1, &p_instancedComponent.instanceBuffer);
+        glNamedBufferStorage(p_instancedComponent.instanceBuffer, static_cast<GLsizeiptr>(p_instancedComponent.instanceStride) * p_instanceCapacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+        RenderComponentFunctions::LinkInstanceBuffer(p_instancedComponent.renderComponent, p_instancedComponent.instanceBuffer, p_instancedComponent.instanceStride);
+
+        p_instancedComponent.instanceCapacity = p_instanceCapacity;
+    }
+
+    //Uploads the mesh once, p_instanceCapacity is only the initial size of the instance buffer
+    template<typename TVertexType, typename TInstanceType, typename TIndexType>
+    static void Create(InstancedRenderComponent& p_instancedComponent, const TVertexType* p_vertices, unsigned int p_vertexCount, const TIndexType* p_indices, unsigned int p_indexCount, unsigned int p_instanceCapacity)
+    {
+        RenderComponent& renderComponent = p_instancedComponent.renderComponent;
+
+        RenderComponentFunctions::Create(renderComponent);
+        RenderComponentFunctions::PreallocateBuffersMemory<TVertexType, TIndexType>(renderComponent, p_vertexCount, p_indexCount);
+        RenderComponentFunctions::UpdateBuffersData<TVertexType, TIndexType>(renderComponent, p_vertices, p_indices, p_vertexCount, p_indexCount);
+        RenderComponentFunctions::SetAttributeFormats<TVertexType>(renderComponent);
+        RenderComponentFunctions::SetAttributeFormats<TInstanceType>(renderComponent, PACO_INSTANCE_BINDING);
+        RenderComponentFunctions::LinkBuffers<TVertexType>(renderComponent, p_vertexCount);
+
+        p_instancedComponent.instanceStride = sizeof(TInstanceType);
+        p_instancedComponent.instanceCount = 0;
+        CreateInstanceBuffer(p_instancedComponent, p_instanceCapacity > 0 ? p_instanceCapacity : 1);
+    }
+
+    //Replaces the instances drawn by Draw, the buffer at least doubles when it is too small
+    template<typename TInstanceType>
+    static void UpdateInstances(InstancedRenderComponent& p_instancedComponent, const TInstanceType* p_instances, unsigned int p_instanceCount)
+    {
+        PACO_PROFILE_SCOPE("InstancedRenderComponent::UpdateInstances");
+
+        if (p_instanceCount > p_instancedComponent.instanceCapacity)
+        {
+            unsigned int newCapacity = p_instancedComponent.instanceCapacity * 2;
+
+            if (newCapacity < p_instanceCount)
+            {
+                newCapacity = p_instanceCount;
+            }
+
+            glDeleteBuffers(1, &p_instancedComponent.instanceBuffer);
+            CreateInstanceBuffer(p_instancedComponent, newCapacity);
+            p_instancedComponent.growCount++;
+        }
+
+        glNamedBufferSubData(p_instancedComponent.instanceBuffer, 0, sizeof(TInstanceType) * static_cast<GLsizeiptr>(p_instanceCount), p_instances);
+
+        p_instancedComponent.instanceCount = p_instanceCount;
+    }
+
+    //Draws p_indexCount indices of the mesh once per uploaded instance
+    static void Draw(const InstancedRenderComponent& p_instancedComponent, GLStateCache& p_stateCache, GLsizei p_indexCount)
+    {
+        if (p_instancedComponent.instanceCount == 0)
+        {
+            return;
+        }
+
+        RenderComponentFunctions::Bind(p_instancedComponent.renderComponent, p_stateCache);
+        glDrawElementsInstanced(GL_TRIANGLES, p_indexCount, p_instancedComponent.renderComponent.indexType, nullptr, p_instancedComponent.instanceCount);
+    }
+
+    static void Delete(InstancedRenderComponent& p_instancedComponent)
+    {
+        glDeleteBuffers(1, &p_instancedComponent.instanceBuffer);
+        RenderComponentFunctions::Delete(p_instancedComponent.renderComponent);
+        p_instancedComponent = InstancedRenderComponent{};
+    }
+}
@@ -0,0 +1,451 @@
+#pragma once
+
+//std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//engine
+#include "PacoEngineDefines.h"
+
+
+//Post-transform vertex cache figures of an index buffer, lower is better for both.
+//ACMR : transformed vertices per triangle, 0.5 at best for a regular grid, 3 without any reuse.
+//ATVR : transformed vertices per unique vertex, 1 means every vertex is transformed exactly once.
+struct VertexCacheStats
+{
+    unsigned int transformedCount = 0;
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+//Offline mesh processing run before meshes reach UpdateBuffersData, in this order :
+//DeduplicateVertices, OptimizeVertexCache, optionally OptimizeOverdraw, then OptimizeVertexFetch.
+//Indices are uint32_t triangle lists, vertices any trivially copyable type compared byte for byte.
+namespace MeshOptimizerFunctions
+{
+    //Simulates a FIFO post-transform cache of p_cacheSize entries, the model most GPUs are closest to
+    static VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& p_indices, size_t p_vertexCount, unsigned int p_cacheSize = PACO_MESH_OPTIMIZER_FIFO_CACHE_SIZE)
+    {
+        VertexCacheStats stats;
+
+        if (p_indices.empty())
+        {
+            return stats;
+        }
+
+        //Cache timestamps, a vertex is in the cache while fewer than p_cacheSize misses happened since it entered
+        std::vector<unsigned int> insertedAt(p_vertexCount, 0);
+        std::vector<bool> isReferenced(p_vertexCount, false);
+        unsigned int missCount = 0;
+        size_t uniqueCount = 0;
+
+        for (uint32_t index : p_indices)
+        {
+            if (!isReferenced[index])
+            {
+                isReferenced[index] = true;
+                uniqueCount++;
+            }
+
+            if (insertedAt[index] == 0 || missCount - insertedAt[index] + 1 > p_cacheSize)
+            {
+                missCount++;
+                insertedAt[index] = missCount;
+            }
+        }
+
+        stats.transformedCount = missCount;
+        stats.acmr = static_cast<float>(missCount) / static_cast<float>(p_indices.size() / 3);
+        stats.atvr = static_cast<float>(missCount) / static_cast<float>(uniqueCount);
+
+        return stats;
+    }
+
+    //Merges byte identical vertices, p_indices is rewritten to reference the kept ones. Returns the new vertex count.
+    template<typename TVertexType>
+    static size_t DeduplicateVertices(std::vector<TVertexType>& p_vertices, std::vector<uint32_t>& p_indices)
+    {
+        std::unordered_map<std::string_view, uint32_t> uniqueVertices;
+        uniqueVertices.reserve(p_vertices.size());
+
+        std::vector<uint32_t> remap(p_vertices.size());
+        std::vector<TVertexType> uniqueVertexData;
+        uniqueVertexData.reserve(p_vertices.size());
+
+        for (size_t vertex = 0; vertex < p_vertices.size(); vertex++)
+        {
+            std::string_view bytes(reinterpret_cast<const char*>(&p_vertices[vertex]), sizeof(TVertexType));
+            auto [existing, isNew] = uniqueVertices.emplace(bytes, static_cast<uint32_t>(uniqueVertexData.size()));
+
+            if (isNew)
+            {
+                uniqueVertexData.push_back(p_vertices[vertex]);
+            }
+
+            remap[vertex] = existing->second;
+        }
+
+        for (uint32_t& index : p_indices)
+        {
+            index = remap[index];
+        }
+
+        p_vertices = std::move(uniqueVertexData);
+
+        return p_vertices.size();
+    }
+
+    //Tom Forsyth's linear-speed vertex cache optimisation : triangles are emitted greedily by the score of their
+    //vertices, favouring vertices in a simulated LRU cache and vertices with few triangles left.
+    static float ForsythVertexScore(int p_cachePosition, unsigned int p_remainingTriangles)
+    {
+        const int cacheSize = PACO_MESH_OPTIMIZER_LRU_CACHE_SIZE;
+
+        if (p_remainingTriangles == 0)
+        {
+            return -1.0f;
+        }
+
+        float score = 0.0f;
+
+        if (p_cachePosition >= 0)
+        {
+            //The three vertices of the last triangle get a fixed score so the next triangle does not just reuse them
+            if (p_cachePosition < 3)
+            {
+                score = 0.75f;
+            }
+            else
+            {
+                float scaler = 1.0f / static_cast<float>(cacheSize - 3);
+                score = std::pow(1.0f - static_cast<float>(p_cachePosition - 3) * scaler, 1.5f);
+            }
+        }
+
+        score += 2.0f / std::sqrt(static_cast<float>(p_remainingTriangles));
+
+        return score;
+    }
+
+    static void OptimizeVertexCache(std::vector<uint32_t>& p_indices, size_t p_vertexCount)
+    {
+        const int cacheSize = PACO_MESH_OPTIMIZER_LRU_CACHE_SIZE;
+        const size_t triangleCount = p_indices.size() / 3;
+
+        if (triangleCount == 0)
+        {
+            return;
+        }
+
+        //Triangles of every vertex as one flat array, vertex v owns [triangleOffsets[v], triangleOffsets[v + 1])
+        std::vector<unsigned int> remainingTriangles(p_vertexCount, 0);
+
+        for (uint32_t index : p_indices)
+        {
+            remainingTriangles[index]++;
+        }
+
+        std::vector<size_t> triangleOffsets(p_vertexCount + 1, 0);
+
+        for (size_t vertex = 0; vertex < p_vertexCount; vertex++)
+        {
+            triangleOffsets[vertex + 1] = triangleOffsets[vertex] + remainingTriangles[vertex];
+        }
+
+        std::vector<uint32_t> vertexTriangles(p_indices.size());
+        std::vector<size_t> fillOffsets(triangleOffsets.begin(), triangleOffsets.end() - 1);
+
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                uint32_t vertex = p_indices[triangle * 3 + corner];
+                vertexTriangles[fillOffsets[vertex]++] = static_cast<uint32_t>(triangle);
+            }
+        }
+
+        std::vector<int> cachePositions(p_vertexCount, -1);
+        std::vector<float> vertexScores(p_vertexCount);
+
+        for (size_t vertex = 0; vertex < p_vertexCount; vertex++)
+        {
+            vertexScores[vertex] = ForsythVertexScore(-1, remainingTriangles[vertex]);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool> isEmitted(triangleCount, false);
+
+        //Scores of the triangles the fallback may pick, entries older than triangleScores or of emitted triangles are skipped when popped.
+        //The fallback only runs once no cached vertex has a triangle left, so a triangle's last score change happened when its
+        //last vertex left the cache, or it never changed, and pushing on eviction only is enough.
+        std::priority_queue<std::pair<float, uint32_t>> scoreHeap;
+
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            triangleScores[triangle] = vertexScores[p_indices[triangle * 3]] + vertexScores[p_indices[triangle * 3 + 1]] + vertexScores[p_indices[triangle * 3 + 2]];
+            scoreHeap.emplace(triangleScores[triangle], static_cast<uint32_t>(triangle));
+        }
+
+        std::vector<uint32_t> cache;
+        cache.reserve(cacheSize + 3);
+
+        std::vector<uint32_t> optimizedIndices;
+        optimizedIndices.reserve(p_indices.size());
+
+        int64_t bestTriangle = -1;
+
+        for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+        {
+            //Nothing in the cache touches an unemitted triangle, restart from the best scored one left
+            if (bestTriangle < 0)
+            {
+                while (isEmitted[scoreHeap.top().second] || scoreHeap.top().first != triangleScores[scoreHeap.top().second])
+                {
+                    scoreHeap.pop();
+                }
+
+                bestTriangle = static_cast<int64_t>(scoreHeap.top().second);
+            }
+
+            size_t triangle = static_cast<size_t>(bestTriangle);
+            isEmitted[triangle] = true;
+
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                uint32_t vertex = p_indices[triangle * 3 + corner];
+                optimizedIndices.push_back(vertex);
+
+                //Removes the triangle from the vertex's list of remaining triangles
+                uint32_t* first = &vertexTriangles[triangleOffsets[vertex]];
+                uint32_t* last = first + remainingTriangles[vertex];
+                std::iter_swap(std::find(first, last, static_cast<uint32_t>(triangle)), last - 1);
+                remainingTriangles[vertex]--;
+            }
+
+            //Moves the triangle's vertices to the front of the LRU cache
+            std::vector<uint32_t> newCache = { p_indices[triangle * 3], p_indices[triangle * 3 + 1], p_indices[triangle * 3 + 2] };
+
+            for (uint32_t vertex : cache)
+            {
+                if (vertex != newCache[0] && vertex != newCache[1] && vertex != newCache[2])
+                {
+                    newCache.push_back(vertex);
+                }
+            }
+
+            for (size_t position = 0; position < newCache.size(); position++)
+            {
+                uint32_t vertex = newCache[position];
+                cachePositions[vertex] = position < static_cast<size_t>(cacheSize) ? static_cast<int>(position) : -1;
+                vertexScores[vertex] = ForsythVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+            }
+
+            //Only triangles of the vertices just scored changed score, evicted ones included.
+            //The best next triangle is among those of the vertices still cached.
+            bestTriangle = -1;
+            float bestScore = -1.0f;
+
+            for (size_t position = 0; position < newCache.size(); position++)
+            {
+                uint32_t vertex = newCache[position];
+
+                for (size_t slot = 0; slot < remainingTriangles[vertex]; slot++)
+                {
+                    uint32_t candidate = vertexTriangles[triangleOffsets[vertex] + slot];
+                    float score = vertexScores[p_indices[candidate * 3]] + vertexScores[p_indices[candidate * 3 + 1]] + vertexScores[p_indices[candidate * 3 + 2]];
+                    triangleScores[candidate] = score;
+
+                    if (position >= static_cast<size_t>(cacheSize))
+                    {
+                        scoreHeap.emplace(score, candidate);
+                    }
+                    else if (score > bestScore)
+                    {
+                        bestScore = score;
+                        bestTriangle = candidate;
+                    }
+                }
+            }
+
+            if (newCache.size() > static_cast<size_t>(cacheSize))
+            {
+                newCache.resize(cacheSize);
+            }
+
+            cache.swap(newCache);
+        }
+
+        p_indices.swap(optimizedIndices);
+    }
+
+    //Reorders clusters of the vertex cache optimized triangle list so outward facing clusters are drawn first,
+    //which lets early depth testing reject more of what is behind them. Clusters are split as in Tipsify : the FIFO cache
+    //is simulated from cold at every cluster start, and a cluster ends as soon as its own ACMR falls to p_threshold times
+    //the ACMR of the whole list, so any cluster order costs the vertex cache about that much.
+    //p_getPosition returns the position of a vertex as a float[3]. Returns the cluster count.
+    static size_t OptimizeOverdraw(std::vector<uint32_t>& p_indices, size_t p_vertexCount, const std::function<const float* (uint32_t)>& p_getPosition,
+        unsigned int p_cacheSize = PACO_MESH_OPTIMIZER_FIFO_CACHE_SIZE, float p_threshold = 1.05f)
+    {
+        const size_t triangleCount = p_indices.size() / 3;
+
+        if (triangleCount == 0)
+        {
+            return 0;
+        }
+
+        const float clusterAcmr = AnalyzeVertexCache(p_indices, p_vertexCount, p_cacheSize).acmr * p_threshold;
+
+        std::vector<size_t> clusterStarts = { 0 };
+        std::vector<unsigned int> insertedAt(p_vertexCount, 0);
+        unsigned int missCount = 0;
+        unsigned int clusterMissCount = 0;
+
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            unsigned int triangleMisses = 0;
+
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                uint32_t vertex = p_indices[triangle * 3 + corner];
+
+                if (insertedAt[vertex] == 0 || missCount - insertedAt[vertex] + 1 > p_cacheSize)
+                {
+                    missCount++;
+                    insertedAt[vertex] = missCount;
+                    triangleMisses++;
+                }
+            }
+
+            clusterMissCount += triangleMisses;
+            const size_t clusterTriangleCount = triangle + 1 - clusterStarts.back();
+
+            if (triangle + 1 < triangleCount && static_cast<float>(clusterMissCount) <= clusterAcmr * static_cast<float>(clusterTriangleCount))
+            {
+                clusterStarts.push_back(triangle + 1);
+                clusterMissCount = 0;
+
+                //The next cluster may be drawn after any other one, its simulated cache starts cold
+                missCount += p_cacheSize;
+            }
+        }
+
+        clusterStarts.push_back(triangleCount);
+
+        float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+
+        for (uint32_t index : p_indices)
+        {
+            const float* position = p_getPosition(index);
+            meshCentroid[0] += position[0];
+            meshCentroid[1] += position[1];
+            meshCentroid[2] += position[2];
+        }
+
+        for (float& component : meshCentroid)
+        {
+            component /= static_cast<float>(p_indices.size());
+        }
+
+        //Sort key : how much the cluster faces away from the mesh centre, area weighted normal against centroid offset
+        std::vector<float> clusterKeys(clusterStarts.size() - 1);
+
+        for (size_t cluster = 0; cluster + 1 < clusterStarts.size(); cluster++)
+        {
+            float centroid[3] = { 0.0f, 0.0f, 0.0f };
+            float normal[3] = { 0.0f, 0.0f, 0.0f };
+
+            for (size_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; triangle++)
+            {
+                const float* a = p_getPosition(p_indices[triangle * 3]);
+                const float* b = p_getPosition(p_indices[triangle * 3 + 1]);
+                const float* c = p_getPosition(p_indices[triangle * 3 + 2]);
+
+                float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+                float ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+
+                normal[0] += ab[1] * ac[2] - ab[2] * ac[1];
+                normal[1] += ab[2] * ac[0] - ab[0] * ac[2];
+                normal[2] += ab[0] * ac[1] - ab[1] * ac[0];
+
+                for (size_t axis = 0; axis < 3; axis++)
+                {
+                    centroid[axis] += a[axis] + b[axis] + c[axis];
+                }
+            }
+
+            float triangleCornerCount = static_cast<float>((clusterStarts[cluster + 1] - clusterStarts[cluster]) * 3);
+            float normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+            float key = 0.0f;
+
+            if (normalLength > 0.0f)
+            {
+                for (size_t axis = 0; axis < 3; axis++)
+                {
+                    key += (centroid[axis] / triangleCornerCount - meshCentroid[axis]) * normal[axis] / normalLength;
+                }
+            }
+
+            clusterKeys[cluster] = key;
+        }
+
+        std::vector<size_t> clusterOrder(clusterKeys.size());
+
+        for (size_t cluster = 0; cluster < clusterOrder.size(); cluster++)
+        {
+            clusterOrder[cluster] = cluster;
+        }
+
+        std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&clusterKeys](size_t p_left, size_t p_right)
+        {
+            return clusterKeys[p_left] > clusterKeys[p_right];
+        });
+
+        std::vector<uint32_t> reorderedIndices;
+        reorderedIndices.reserve(p_indices.size());
+
+        for (size_t cluster : clusterOrder)
+        {
+            reorderedIndices.insert(reorderedIndices.end(), p_indices.begin() + clusterStarts[cluster] * 3, p_indices.begin() + clusterStarts[cluster + 1] * 3);
+        }
+
+        p_indices.swap(reorderedIndices);
+
+        return clusterOrder.size();
+    }
+
+    //Renumbers vertices in order of first use so vertex fetch walks memory forward, unreferenced vertices are dropped.
+    //Returns the new vertex count.
+    template<typename TVertexType>
+    static size_t OptimizeVertexFetch(std::vector<TVertexType>& p_vertices, std::vector<uint32_t>& p_indices)
+    {
+        const uint32_t unassigned = 0xFFFFFFFF;
+
+        std::vector<uint32_t> remap(p_vertices.size(), unassigned);
+        std::vector<TVertexType> orderedVertices;
+        orderedVertices.reserve(p_vertices.size());
+
+        for (uint32_t& index : p_indices)
+        {
+            if (remap[index] == unassigned)
+            {
+                remap[index] = static_cast<uint32_t>(orderedVertices.size());
+                orderedVertices.push_back(p_vertices[index]);
+            }
+
+            index = remap[index];
+        }
+
+        p_vertices = std::move(orderedVertices);
+
+        return p_vertices.size();
+    }
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+//std
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL_log.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "Core/Profiler.h"
+#include "PacoEngineDefines.h"
+#include "Rendering/GLStateCache.h"
+#include "Rendering/IndexType.h"
+#include "Rendering/VertexArrayCache.h"
+#include "Rendering/VertexLayout.h"
+
+
+//When usesCachedVertexArray is set the vao belongs to a VertexArrayCache and is shared with every
+//component of the same vertex layout, vbo and ebo are attached to it on Bind through the GLStateCache.
+//Its attribute formats and bindings are then shared too and cannot be changed per component.
+//indexType is the type the ebo was allocated with, GL_UNSIGNED_SHORT halves index memory and fetch bandwidth
+//and is enough whenever a draw addresses fewer than 65536 vertices from its base vertex.
+struct RenderComponent
+{
+    GLuint vbo = 0;
+    GLuint ebo = 0;
+    GLuint vao = 0;
+    GLsizei vertexStride = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    bool usesCachedVertexArray = false;
+};
+
+namespace RenderComponentFunctions
+{
+    static void Create(RenderComponent& p_renderComponent)
+    {
+        glCreateBuffers(1, &p_renderComponent.vbo);
+        glCreateBuffers(1, &p_renderComponent.ebo);
+        glCreateVertexArrays(1, &p_renderComponent.vao);
+    }
+
+    //Creates the buffers only, the VAO comes from p_cache and is shared with every component of the same layout
+    template<typename TVertexType>
+    static void Create(RenderComponent& p_renderComponent, VertexArrayCache& p_cache)
+    {
+        glCreateBuffers(1, &p_renderComponent.vbo);
+        glCreateBuffers(1, &p_renderComponent.ebo);
+
+        p_renderComponent.vao = VertexArrayCacheFunctions::GetOrCreate<TVertexType>(p_cache);
+        p_renderComponent.vertexStride = sizeof(TVertexType);
+        p_renderComponent.usesCachedVertexArray = true;
+    }
+
+    static void Bind(const RenderComponent& p_renderComponent, GLStateCache& p_stateCache)
+    {
+        PACO_PROFILE_SCOPE("RenderComponent::Bind");
+
+        GLStateCacheFunctions::BindVertexArray(p_stateCache, p_renderComponent.vao);
+
+        if (p_renderComponent.usesCachedVertexArray)
+        {
+            GLStateCacheFunctions::BindVertexBuffers(p_stateCache, p_renderComponent.vbo, p_renderComponent.vertexStride, p_renderComponent.ebo);
+        }
+    }
+
+    static void Unbind(GLStateCache& p_stateCache)
+    {
+        GLStateCacheFunctions::BindVertexArray(p_stateCache, 0);
+    }
+
+    template<typename TVertexType, typename TIndexType = uint32_t>
+    static void PreallocateBuffersMemory(RenderComponent& p_renderComponent, unsigned int p_vertexCount, unsigned int  p_indexCount, bool p_isStatic = false)
+    {
+        GLenum flags = GL_DYNAMIC_STORAGE_BIT;
+
+        if (p_isStatic)
+        {
+            flags = 0;
+        }
+
+        GLsizeiptr verticesSize = sizeof(TVertexType) * p_vertexCount;
+
+        GLsizeiptr indicesSize = sizeof(TIndexType) * p_indexCount;
+
+        glNamedBufferStorage(p_renderComponent.vbo, verticesSize, nullptr, flags);
+        glNamedBufferStorage(p_renderComponent.ebo, indicesSize, nullptr, flags);
+
+        p_renderComponent.indexType = IndexTypeTraits<TIndexType>::glType;
+
+    }
+
+    template<typename TVertexType, typename TIndexType = uint32_t>
+    static void UpdateBuffersData(RenderComponent& p_renderComponent, const void* p_vertexData, const void* p_indexData, unsigned int p_vertexCount, unsigned int p_indexCount, GLintptr p_vertexOffset = 0, GLintptr p_indexOffset = 0) {
+
+        PACO_PROFILE_SCOPE("RenderComponent::UpdateBuffersData");
+
+        GLsizeiptr vertexSize = sizeof(TVertexType) * p_vertexCount;
+        GLsizeiptr indexSize = sizeof(TIndexType) * p_indexCount;
+
+        glNamedBufferSubData(p_renderComponent.vbo, p_vertexOffset, vertexSize, p_vertexData);
+        glNamedBufferSubData(p_renderComponent.ebo, p_indexOffset, indexSize, p_indexData);
+    }
+
+    template<typename TVertexType>
+    static void UpdateVertexBufferData(RenderComponent& p_renderComponent, const void* p_data, unsigned int p_vertexCount, GLintptr p_offset = 0) {
+
+        PACO_PROFILE_SCOPE("RenderComponent::UpdateVertexBufferData");
+
+        GLsizeiptr size = sizeof(TVertexType) * p_vertexCount;
+
+        glNamedBufferSubData(p_renderComponent.vbo, p_offset, size, p_data);
+    }
+
+    template<typename TIndexType = uint32_t>
+    static void UpdateIndexBufferData(RenderComponent& p_renderComponent, const void* p_data, unsigned int p_indexCount, GLintptr p_offset = 0) {
+
+        PACO_PROFILE_SCOPE("RenderComponent::UpdateIndexBufferData");
+
+        GLsizeiptr size = sizeof(TIndexType) * p_indexCount;
+
+        glNamedBufferSubData(p_renderComponent.ebo, p_offset, size, p_data);
+    }
+
+    static void SetAttributeFormats(RenderComponent& p_renderComponent, std::span<const VertexAttribute> p_attributes, GLuint p_bindingIndex = 0)
+    {
+        if (p_renderComponent.usesCachedVertexArray)
+        {
+            SDL_Log("Cannot change the attribute formats of a vertex array shared through a VertexArrayCache");
+            return;
+        }
+
+        VertexLayoutFunctions::ApplyAttributeFormats(p_renderComponent.vao, p_attributes, p_bindingIndex);
+    }
+
+    template<typename TVertexType>
+    static void SetAttributeFormats(RenderComponent& p_renderComponent, GLuint p_bindingIndex = 0)
+    {
+        SetAttributeFormats(p_renderComponent, VertexLayout<TVertexType>::attributes, p_bindingIndex);
+    }
+
+    template<typename TVertexType>
+    static void LinkBuffers(RenderComponent& p_renderComponent, unsigned int p_vertexCount)
+    {
+        GLuint vao = p_renderComponent.vao;
+
+        GLsizeiptr size = sizeof(TVertexType);
+
+        p_renderComponent.vertexStride = sizeof(TVertexType);
+
+        //A shared vao gets the buffers on Bind
+        if (p_renderComponent.usesCachedVertexArray)
+        {
+            return;
+        }
+
+        glVertexArrayVertexBuffer(vao, 0, p_renderComponent.vbo, 0, size);
+        glVertexArrayElementBuffer(vao, p_renderComponent.ebo);
+    }
+
+    //Immutable copy of a mesh, indices are given as 32 bit and stored as GL_UNSIGNED_SHORT whenever p_vertexCount fits in 16 bits
+    template<typename TVertexType>
+    static void StoreMesh(RenderComponent& p_renderComponent, const TVertexType* p_vertices, unsigned int p_vertexCount, const uint32_t* p_indices, unsigned int p_indexCount)
+    {
+        glNamedBufferStorage(p_renderComponent.vbo, sizeof(TVertexType) * static_cast<GLsizeiptr>(p_vertexCount), p_vertices, 0);
+
+        p_renderComponent.indexType = IndexTypeFunctions::Select(p_vertexCount);
+
+        if (p_renderComponent.indexType == GL_UNSIGNED_SHORT)
+        {
+            std::vector<uint16_t> narrowIndices(p_indexCount);
+            IndexTypeFunctions::Narrow(p_indices, p_indexCount, narrowIndices.data());
+            glNamedBufferStorage(p_renderComponent.ebo, sizeof(uint16_t) * static_cast<GLsizeiptr>(p_indexCount), narrowIndices.data(), 0);
+        }
+        else
+        {
+            glNamedBufferStorage(p_renderComponent.ebo, sizeof(uint32_t) * static_cast<GLsizeiptr>(p_indexCount), p_indices, 0);
+        }
+    }
+
+    //Creates the component with its own vao and an immutable copy of a mesh, DrawElements draws with the index type StoreMesh picked
+    template<typename TVertexType>
+    static void Create(RenderComponent& p_renderComponent, const TVertexType* p_vertices, unsigned int p_vertexCount, const uint32_t* p_indices, unsigned int p_indexCount)
+    {
+        Create(p_renderComponent);
+        StoreMesh(p_renderComponent, p_vertices, p_vertexCount, p_indices, p_indexCount);
+        SetAttributeFormats<TVertexType>(p_renderComponent);
+        LinkBuffers<TVertexType>(p_renderComponent, p_vertexCount);
+    }
+
+    //Same with the vao shared through p_cache
+    template<typename TVertexType>
+    static void Create(RenderComponent& p_renderComponent, VertexArrayCache& p_cache, const TVertexType* p_vertices, unsigned int p_vertexCount, const uint32_t* p_indices, unsigned int p_indexCount)
+    {
+        Create<TVertexType>(p_renderComponent, p_cache);
+        StoreMesh(p_renderComponent, p_vertices, p_vertexCount, p_indices, p_indexCount);
+    }
+
+    //Draws with the component's index type, the component must be bound. p_firstIndex is in indices.
+    static void DrawElements(const RenderComponent& p_renderComponent, GLsizei p_indexCount, uint32_t p_firstIndex = 0, GLint p_baseVertex = 0)
+    {
+        glDrawElementsBaseVertex(GL_TRIANGLES, p_indexCount, p_renderComponent.indexType, IndexTypeFunctions::GetOffset(p_renderComponent.indexType, p_firstIndex), p_baseVertex);
+    }
+
+    //Sources the attributes set on p_bindingIndex from p_instanceBuffer, advancing once every p_divisor instances
+    static void LinkInstanceBuffer(RenderComponent& p_renderComponent, GLuint p_instanceBuffer, GLsizei p_instanceStride, GLuint p_bindingIndex = PACO_INSTANCE_BINDING, GLuint p_divisor = 1)
+    {
+        if (p_renderComponent.usesCachedVertexArray)
+        {
+            SDL_Log("Cannot link an instance buffer to a vertex array shared through a VertexArrayCache");
+            return;
+        }
+
+        glVertexArrayVertexBuffer(p_renderComponent.vao, p_bindingIndex, p_instanceBuffer, 0, p_instanceStride);
+        glVertexArrayBindingDivisor(p_renderComponent.vao, p_bindingIndex, p_divisor);
+    }
+
+    //Forget the vao, vbo and ebo in every GLStateCache they were bound through before deleting
+    static void Delete(RenderComponent& p_renderComponent)
+    {
+        glDeleteBuffers(1, &p_renderComponent.vbo);
+        glDeleteBuffers(1, &p_renderComponent.ebo);
+
+        if (!p_renderComponent.usesCachedVertexArray)
+        {
+            glDeleteVertexArrays(1, &p_renderComponent.vao);
+        }
+
+    }
+
+}
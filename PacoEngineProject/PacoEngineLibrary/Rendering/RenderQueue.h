@@ -0,0 +1,202 @@
+#pragma once
+
+//std
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//vendor
+#include <glad/glad/gl.h>
+
+//engine
+#include "PacoEngineDefines.h"
+#include "Core/Profiler.h"
+#include "Core/RadixSort.h"
+#include "Rendering/GLStateCache.h"
+#include "Rendering/RenderComponent.h"
+
+
+//One indexed draw of a RenderComponent, firstIndex is in indices and baseVertex in vertices.
+//The component must stay alive until the queue is executed.
+struct RenderCommand
+{
+    const RenderComponent* renderComponent;
+    GLuint program;
+    GLuint texture;
+    GLsizei indexCount;
+    uint32_t firstIndex;
+    GLint baseVertex;
+
+    //Per-draw uniform block bound at PACO_DRAW_UNIFORM_BINDING, usually a UniformArena range. Skipped when uniformSize is 0.
+    GLuint uniformBuffer = 0;
+    GLintptr uniformOffset = 0;
+    GLsizeiptr uniformSize = 0;
+};
+
+struct RenderQueueStats
+{
+    unsigned int commandCount = 0;
+    unsigned int programChangeCount = 0;
+    unsigned int textureChangeCount = 0;
+    unsigned int vertexArrayChangeCount = 0;
+    unsigned int uniformBindCount = 0;
+};
+
+//Draws recorded in any order and executed sorted by their 64 bit key.
+//A queue is recorded by a single thread, threads record into their own queue and
+//the queues are merged on the render thread before sorting, no locking is needed.
+struct RenderQueue
+{
+    std::vector<uint64_t> sortKeys;
+    std::vector<RenderCommand> commands;
+
+    std::vector<uint32_t> sortIndices;
+    std::vector<uint64_t> sortScratchKeys;
+    std::vector<uint32_t> sortScratchIndices;
+
+    RenderQueueStats lastStats;
+};
+
+namespace RenderQueueFunctions
+{
+    //Key layout, most significant first : layer 8 bits | program 16 bits | texture 16 bits | depth 24 bits.
+    //Program and texture names are truncated, a collision only costs a state change since Execute compares the real names.
+    constexpr unsigned int layerShift = 56;
+    constexpr unsigned int programShift = 40;
+    constexpr unsigned int textureShift = 24;
+    constexpr uint64_t depthMask = (1ull << 24) - 1;
+
+    //p_depth is expected in [0, 1], p_backToFront reverses the depth order for translucent layers
+    static uint64_t MakeSortKey(uint8_t p_layer, GLuint p_program, GLuint p_texture, float p_depth, bool p_backToFront = false)
+    {
+        float clampedDepth = p_depth < 0.0f ? 0.0f : (p_depth > 1.0f ? 1.0f : p_depth);
+        uint64_t depth = static_cast<uint64_t>(clampedDepth * static_cast<float>(depthMask));
+
+        if (p_backToFront)
+        {
+            depth = depthMask - depth;
+        }
+
+        return (static_cast<uint64_t>(p_layer) << layerShift)
+            | (static_cast<uint64_t>(p_program & 0xFFFF) << programShift)
+            | (static_cast<uint64_t>(p_texture & 0xFFFF) << textureShift)
+            | depth;
+    }
+
+    static void Reserve(RenderQueue& p_queue, unsigned int p_commandCount)
+    {
+        p_queue.sortKeys.reserve(p_commandCount);
+        p_queue.commands.reserve(p_commandCount);
+        p_queue.sortIndices.reserve(p_commandCount);
+        p_queue.sortScratchKeys.reserve(p_commandCount);
+        p_queue.sortScratchIndices.reserve(p_commandCount);
+    }
+
+    //Keeps the allocated memory for the next frame
+    static void Clear(RenderQueue& p_queue)
+    {
+        p_queue.sortKeys.clear();
+        p_queue.commands.clear();
+    }
+
+    static void Submit(RenderQueue& p_queue, uint64_t p_sortKey, const RenderCommand& p_command)
+    {
+        p_queue.sortKeys.push_back(p_sortKey);
+        p_queue.commands.push_back(p_command);
+    }
+
+    //Appends every command of p_sources to p_queue in order, the sources are cleared.
+    //Commands with equal keys therefore execute in source order, then submission order.
+    static void Merge(RenderQueue& p_queue, std::span<RenderQueue> p_sources)
+    {
+        size_t totalCount = p_queue.commands.size();
+
+        for (const RenderQueue& source : p_sources)
+        {
+            totalCount += source.commands.size();
+        }
+
+        p_queue.sortKeys.reserve(totalCount);
+        p_queue.commands.reserve(totalCount);
+
+        for (RenderQueue& source : p_sources)
+        {
+            p_queue.sortKeys.insert(p_queue.sortKeys.end(), source.sortKeys.begin(), source.sortKeys.end());
+            p_queue.commands.insert(p_queue.commands.end(), source.commands.begin(), source.commands.end());
+            Clear(source);
+        }
+    }
+
+    //Sorts the keys with their command indices, the commands themselves are not moved
+    static void Sort(RenderQueue& p_queue)
+    {
+        PACO_PROFILE_SCOPE("RenderQueue::Sort");
+
+        const uint32_t commandCount = static_cast<uint32_t>(p_queue.commands.size());
+
+        p_queue.sortIndices.resize(commandCount);
+
+        for (uint32_t command = 0; command < commandCount; command++)
+        {
+            p_queue.sortIndices[command] = command;
+        }
+
+        RadixSortFunctions::SortKeyValues(p_queue.sortKeys, p_queue.sortIndices, p_queue.sortScratchKeys, p_queue.sortScratchIndices);
+    }
+
+    //Draws every command in key order in a single pass, state changes go through p_stateCache.
+    //Sort must have been called since the last Submit or Merge.
+    static void Execute(RenderQueue& p_queue, GLStateCache& p_stateCache)
+    {
+        PACO_PROFILE_SCOPE("RenderQueue::Execute");
+        PACO_PROFILE_GPU_SCOPE("RenderQueue::Execute");
+
+        RenderQueueStats stats;
+        stats.commandCount = static_cast<unsigned int>(p_queue.sortIndices.size());
+
+        const RenderComponent* boundComponent = nullptr;
+        GLuint boundProgram = glStateUnknown;
+        GLuint boundTexture = glStateUnknown;
+
+        for (uint32_t commandIndex : p_queue.sortIndices)
+        {
+            const RenderCommand& command = p_queue.commands[commandIndex];
+
+            if (command.program != boundProgram)
+            {
+                GLStateCacheFunctions::UseProgram(p_stateCache, command.program);
+                boundProgram = command.program;
+                stats.programChangeCount++;
+            }
+
+            if (command.texture != boundTexture)
+            {
+                GLStateCacheFunctions::BindTextureUnit(p_stateCache, 0, command.texture);
+                boundTexture = command.texture;
+                stats.textureChangeCount++;
+            }
+
+            if (command.renderComponent != boundComponent)
+            {
+                RenderComponentFunctions::Bind(*command.renderComponent, p_stateCache);
+                boundComponent = command.renderComponent;
+                stats.vertexArrayChangeCount++;
+            }
+
+            if (command.uniformSize > 0)
+            {
+                glBindBufferRange(GL_UNIFORM_BUFFER, PACO_DRAW_UNIFORM_BINDING, command.uniformBuffer, command.uniformOffset, command.uniformSize);
+                stats.uniformBindCount++;
+            }
+
+            RenderComponentFunctions::DrawElements(*command.renderComponent, command.indexCount, command.firstIndex, command.baseVertex);
+        }
+
+        p_queue.lastStats = stats;
+    }
+
+    static const RenderQueueStats& GetStats(const RenderQueue& p_queue)
+    {
+        return p_queue.lastStats;
+    }
+}
@@ -0,0 +1,254 @@
+#pragma once
+
+//std
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "PacoEngineDefines.h"
+#include "Core/Profiler.h"
+#include "Rendering/GLStateCache.h"
+#include "Rendering/RenderQueue.h"
+
+
+//Everything the render thread needs to draw one frame, written by the main thread and read-only once submitted.
+//GL objects can only be created or updated on the render thread, renderTasks run there before the queue is executed.
+struct FramePacket
+{
+    uint64_t frameIndex = 0;
+    float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    std::vector<std::function<void(GLStateCache&)>> renderTasks;
+    RenderQueue renderQueue;
+};
+
+struct RenderThreadStats
+{
+    //Time the main thread waited for a free packet, the render thread is the bottleneck when it grows
+    Uint64 mainWaitNs = 0;
+
+    //Time the render thread waited for a submitted packet, the main thread is the bottleneck when it grows
+    Uint64 renderWaitNs = 0;
+
+    Uint64 renderedFrameCount = 0;
+};
+
+//Render thread owning the GL context and consuming the frame packets produced by the main thread.
+//With a latency of N frames the main thread simulates frame F while the render thread submits frame F - N,
+//there are N + 1 packets : one being written, one being rendered and N - 1 waiting.
+//Swapping from a thread other than the main one is fine on Windows and Linux but not on macOS.
+struct RenderThread
+{
+    SDL_Window* window = nullptr;
+    SDL_GLContext context = nullptr;
+    unsigned int latency = 1;
+
+    FramePacket packets[PACO_MAX_FRAME_LATENCY + 1];
+    unsigned int packetCount = 0;
+    unsigned int writeIndex = 0;
+    unsigned int readIndex = 0;
+    uint64_t nextFrameIndex = 0;
+
+    std::counting_semaphore<PACO_MAX_FRAME_LATENCY + 1> freePackets{ 0 };
+
+    //One more than the packet count, Stop releases it once to wake the render thread
+    std::counting_semaphore<PACO_MAX_FRAME_LATENCY + 2> readyPackets{ 0 };
+    std::atomic<bool> stopRequested = false;
+    std::thread thread;
+
+    //Set by the render thread once it tried to make the context current, Start waits for it
+    std::mutex startMutex;
+    std::condition_variable startCondition;
+    bool isStartDone = false;
+    bool hasContext = false;
+
+    GLStateCache stateCache;
+
+    std::atomic<Uint64> mainWaitNs = 0;
+    std::atomic<Uint64> renderWaitNs = 0;
+    std::atomic<Uint64> renderedFrameCount = 0;
+};
+
+namespace RenderThreadFunctions
+{
+    static void RenderPacket(RenderThread& p_renderThread, FramePacket& p_packet)
+    {
+        PACO_PROFILE_SCOPE("RenderPacket");
+
+        GLStateCache& stateCache = p_renderThread.stateCache;
+
+        GLStateCacheFunctions::BeginFrame(stateCache);
+
+        {
+            PACO_PROFILE_GPU_SCOPE("Frame");
+
+            for (std::function<void(GLStateCache&)>& renderTask : p_packet.renderTasks)
+            {
+                renderTask(stateCache);
+            }
+
+            glClearColor(p_packet.clearColor[0], p_packet.clearColor[1], p_packet.clearColor[2], p_packet.clearColor[3]);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            RenderQueueFunctions::Sort(p_packet.renderQueue);
+            RenderQueueFunctions::Execute(p_packet.renderQueue, stateCache);
+        }
+
+        GLStateCacheFunctions::EndFrame(stateCache);
+
+        {
+            PACO_PROFILE_SCOPE("SwapWindow");
+            SDL_GL_SwapWindow(p_renderThread.window);
+        }
+
+        PACO_PROFILE_GPU_FRAME_END();
+    }
+
+    static void Run(RenderThread* p_renderThread)
+    {
+        RenderThread& renderThread = *p_renderThread;
+
+        PACO_PROFILE_THREAD_NAME("Render");
+
+        const bool hasContext = SDL_GL_MakeCurrent(renderThread.window, renderThread.context);
+
+        if (!hasContext)
+        {
+            SDL_Log("Render thread failed to make the GL context current : %s", SDL_GetError());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(renderThread.startMutex);
+            renderThread.isStartDone = true;
+            renderThread.hasContext = hasContext;
+        }
+
+        renderThread.startCondition.notify_one();
+
+        if (!hasContext)
+        {
+            return;
+        }
+
+        GLStateCacheFunctions::Create(renderThread.stateCache);
+
+        while (true)
+        {
+            Uint64 waitStart = SDL_GetTicksNS();
+            renderThread.readyPackets.acquire();
+            renderThread.renderWaitNs += SDL_GetTicksNS() - waitStart;
+
+            if (renderThread.stopRequested)
+            {
+                break;
+            }
+
+            RenderPacket(renderThread, renderThread.packets[renderThread.readIndex]);
+
+            renderThread.readIndex = (renderThread.readIndex + 1) % renderThread.packetCount;
+            renderThread.renderedFrameCount++;
+            renderThread.freePackets.release();
+        }
+
+        SDL_GL_MakeCurrent(renderThread.window, nullptr);
+    }
+
+    //The context must be current on the calling thread and GL loaded, it is handed over to the render thread.
+    //Returns false with the context current again on the calling thread when the render thread cannot use it.
+    //p_latency is the number of frames the main thread may run ahead, between 1 and PACO_MAX_FRAME_LATENCY.
+    static bool Start(RenderThread& p_renderThread, SDL_Window* p_window, SDL_GLContext p_context, unsigned int p_latency = 1)
+    {
+        if (p_latency == 0 || p_latency > PACO_MAX_FRAME_LATENCY)
+        {
+            SDL_Log("RenderThread latency must be between 1 and %d, got %u", PACO_MAX_FRAME_LATENCY, p_latency);
+            return false;
+        }
+
+        if (!SDL_GL_MakeCurrent(p_window, nullptr))
+        {
+            SDL_Log("Failed to release the GL context for the render thread : %s", SDL_GetError());
+            return false;
+        }
+
+        p_renderThread.window = p_window;
+        p_renderThread.context = p_context;
+        p_renderThread.latency = p_latency;
+        p_renderThread.packetCount = p_latency + 1;
+        p_renderThread.stopRequested = false;
+        p_renderThread.isStartDone = false;
+        p_renderThread.hasContext = false;
+
+        p_renderThread.thread = std::thread(Run, &p_renderThread);
+
+        {
+            std::unique_lock<std::mutex> lock(p_renderThread.startMutex);
+            p_renderThread.startCondition.wait(lock, [&p_renderThread] { return p_renderThread.isStartDone; });
+        }
+
+        if (!p_renderThread.hasContext)
+        {
+            p_renderThread.thread.join();
+            SDL_GL_MakeCurrent(p_window, p_context);
+            return false;
+        }
+
+        p_renderThread.freePackets.release(p_renderThread.packetCount);
+
+        return true;
+    }
+
+    //Waits until a packet is free and returns it cleared, blocks when the render thread is p_latency frames behind
+    static FramePacket& BeginFrame(RenderThread& p_renderThread)
+    {
+        Uint64 waitStart = SDL_GetTicksNS();
+        p_renderThread.freePackets.acquire();
+        p_renderThread.mainWaitNs += SDL_GetTicksNS() - waitStart;
+
+        FramePacket& packet = p_renderThread.packets[p_renderThread.writeIndex];
+        packet.frameIndex = p_renderThread.nextFrameIndex++;
+        packet.renderTasks.clear();
+        RenderQueueFunctions::Clear(packet.renderQueue);
+
+        return packet;
+    }
+
+    //Hands the packet returned by BeginFrame to the render thread, it must not be touched afterwards
+    static void EndFrame(RenderThread& p_renderThread)
+    {
+        p_renderThread.writeIndex = (p_renderThread.writeIndex + 1) % p_renderThread.packetCount;
+        p_renderThread.readyPackets.release();
+    }
+
+    static RenderThreadStats GetStats(const RenderThread& p_renderThread)
+    {
+        RenderThreadStats stats;
+        stats.mainWaitNs = p_renderThread.mainWaitNs;
+        stats.renderWaitNs = p_renderThread.renderWaitNs;
+        stats.renderedFrameCount = p_renderThread.renderedFrameCount;
+
+        return stats;
+    }
+
+    //Packets submitted but not rendered yet are dropped, the context is made current again on the calling thread
+    static void Stop(RenderThread& p_renderThread)
+    {
+        if (!p_renderThread.thread.joinable())
+        {
+            return;
+        }
+
+        p_renderThread.stopRequested = true;
+        p_renderThread.readyPackets.release();
+        p_renderThread.thread.join();
+
+        SDL_GL_MakeCurrent(p_renderThread.window, p_renderThread.context);
+    }
+}
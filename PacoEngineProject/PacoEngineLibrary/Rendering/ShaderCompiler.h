@@ -0,0 +1,344 @@
+#pragma once
+
+//std
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "Core/Profiler.h"
+#include "Rendering/ShaderProgram.h"
+
+
+enum class ShaderCompileMode
+{
+    //Submit builds the program before returning, used when neither background path is available
+    Synchronous,
+
+    //The driver compiles on its own threads, Update polls GL_COMPLETION_STATUS_KHR and finishes the links
+    ParallelExtension,
+
+    //A worker thread builds programs on a second context sharing objects with the submitting one,
+    //current on a hidden window of its own since a surface can only be current on one thread
+    SharedContext,
+};
+
+enum class ShaderCompileState
+{
+    Pending,
+    Ready,
+    Failed,
+};
+
+//A program built in the background. The sources are owned by the request so it must stay at the same address,
+//and alive, until its state leaves Pending. shaderProgram may only be read once the state is Ready.
+struct ShaderCompileRequest
+{
+    std::vector<GLenum> stageTypes;
+    std::vector<std::string> stageSources;
+
+    ShaderProgram shaderProgram;
+    ShaderProgramLink link;
+    std::atomic<ShaderCompileState> state = ShaderCompileState::Pending;
+};
+
+struct ShaderCompilerStats
+{
+    unsigned int submittedCount = 0;
+    unsigned int pendingCount = 0;
+};
+
+//Builds shader programs without stalling the thread that owns the GL context.
+//Every function is called from that thread. In SharedContext mode p_cache belongs to the worker until Destroy.
+struct ShaderCompiler
+{
+    ShaderCompileMode mode = ShaderCompileMode::Synchronous;
+    ShaderProgramCache* cache = nullptr;
+
+    //ParallelExtension
+    std::vector<ShaderCompileRequest*> pendingLinks;
+
+    //SharedContext
+    SDL_Window* window = nullptr;
+    SDL_Window* workerWindow = nullptr;
+    SDL_GLContext context = nullptr;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<ShaderCompileRequest*> queuedRequests;
+    bool stopRequested = false;
+
+    unsigned int submittedCount = 0;
+    std::atomic<unsigned int> pendingCount = 0;
+};
+
+namespace ShaderCompilerFunctions
+{
+    static std::vector<ShaderStage> GetStages(const ShaderCompileRequest& p_request)
+    {
+        std::vector<ShaderStage> stages;
+
+        for (size_t stage = 0; stage < p_request.stageTypes.size(); stage++)
+        {
+            stages.push_back({ p_request.stageTypes[stage], p_request.stageSources[stage].c_str() });
+        }
+
+        return stages;
+    }
+
+    static void Complete(ShaderCompiler& p_compiler, ShaderCompileRequest& p_request, bool p_isBuilt)
+    {
+        p_compiler.pendingCount--;
+        p_request.state.store(p_isBuilt ? ShaderCompileState::Ready : ShaderCompileState::Failed, std::memory_order_release);
+    }
+
+    //Best mode the current context supports, the parallel extension is preferred as it needs no second context
+    static ShaderCompileMode SelectMode()
+    {
+        if (GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile)
+        {
+            return ShaderCompileMode::ParallelExtension;
+        }
+
+        return ShaderCompileMode::SharedContext;
+    }
+
+    static void RunWorker(ShaderCompiler& p_compiler)
+    {
+        PACO_PROFILE_THREAD_NAME("Shader Compiler");
+
+        //Without a context every request fails, including the ones submitted later
+        const bool hasContext = SDL_GL_MakeCurrent(p_compiler.workerWindow, p_compiler.context);
+
+        if (!hasContext)
+        {
+            SDL_Log("Shader compiler thread failed to make its GL context current, its programs will fail : %s", SDL_GetError());
+        }
+
+        while (true)
+        {
+            ShaderCompileRequest* request = nullptr;
+
+            {
+                std::unique_lock<std::mutex> lock(p_compiler.mutex);
+                p_compiler.condition.wait(lock, [&p_compiler]() { return p_compiler.stopRequested || !p_compiler.queuedRequests.empty(); });
+
+                if (p_compiler.stopRequested)
+                {
+                    break;
+                }
+
+                request = p_compiler.queuedRequests.front();
+                p_compiler.queuedRequests.pop_front();
+            }
+
+            if (!hasContext)
+            {
+                Complete(p_compiler, *request, false);
+                continue;
+            }
+
+            PACO_PROFILE_SCOPE("CompileShaderProgram");
+
+            std::vector<ShaderStage> stages = GetStages(*request);
+            bool isBuilt = ShaderProgramFunctions::Create(request->shaderProgram, stages, p_compiler.cache);
+
+            //The program must be complete before another context uses it
+            glFinish();
+
+            Complete(p_compiler, *request, isBuilt);
+        }
+
+        if (hasContext)
+        {
+            SDL_GL_MakeCurrent(p_compiler.workerWindow, nullptr);
+        }
+    }
+
+    //Called on the thread owning the current context of p_window. SharedContext falls back to Synchronous
+    //when the shared context cannot be created, p_compiler.mode tells which mode is used.
+    static bool Create(ShaderCompiler& p_compiler, SDL_Window* p_window, ShaderCompileMode p_mode, ShaderProgramCache* p_cache = nullptr)
+    {
+        p_compiler.mode = p_mode;
+        p_compiler.cache = p_cache;
+        p_compiler.window = p_window;
+
+        if (p_mode == ShaderCompileMode::ParallelExtension)
+        {
+            if (!GLAD_GL_KHR_parallel_shader_compile && !GLAD_GL_ARB_parallel_shader_compile)
+            {
+                SDL_Log("GL_KHR_parallel_shader_compile is not supported");
+                p_compiler.mode = ShaderCompileMode::Synchronous;
+                return false;
+            }
+
+            //Let the driver pick its thread count
+            if (GLAD_GL_KHR_parallel_shader_compile)
+            {
+                glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+            }
+            else
+            {
+                glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+            }
+        }
+        else if (p_mode == ShaderCompileMode::SharedContext)
+        {
+            //p_window stays current on the calling thread, EGL refuses to make one surface current on two threads
+            p_compiler.workerWindow = SDL_CreateWindow("Shader Compiler", 1, 1, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+
+            if (p_compiler.workerWindow == nullptr)
+            {
+                SDL_Log("Failed to create the shader compiler window : %s", SDL_GetError());
+                p_compiler.mode = ShaderCompileMode::Synchronous;
+                return false;
+            }
+
+            SDL_GLContext currentContext = SDL_GL_GetCurrentContext();
+
+            //Creating a context makes it current, the submitting context is restored right after
+            SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+            p_compiler.context = SDL_GL_CreateContext(p_compiler.workerWindow);
+            SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+            SDL_GL_MakeCurrent(p_window, currentContext);
+
+            if (p_compiler.context == nullptr)
+            {
+                SDL_Log("Failed to create the shader compiler context : %s", SDL_GetError());
+                SDL_DestroyWindow(p_compiler.workerWindow);
+                p_compiler.workerWindow = nullptr;
+                p_compiler.mode = ShaderCompileMode::Synchronous;
+                return false;
+            }
+
+            p_compiler.thread = std::thread(RunWorker, std::ref(p_compiler));
+        }
+
+        return true;
+    }
+
+    static void Submit(ShaderCompiler& p_compiler, ShaderCompileRequest& p_request)
+    {
+        p_compiler.submittedCount++;
+        p_compiler.pendingCount++;
+
+        switch (p_compiler.mode)
+        {
+        case ShaderCompileMode::Synchronous:
+        {
+            std::vector<ShaderStage> stages = GetStages(p_request);
+            Complete(p_compiler, p_request, ShaderProgramFunctions::Create(p_request.shaderProgram, stages, p_compiler.cache));
+            break;
+        }
+        case ShaderCompileMode::ParallelExtension:
+        {
+            std::vector<ShaderStage> stages = GetStages(p_request);
+
+            if (ShaderProgramFunctions::BeginCreate(p_request.shaderProgram, stages, p_compiler.cache, p_request.link))
+            {
+                Complete(p_compiler, p_request, true);
+            }
+            else
+            {
+                p_compiler.pendingLinks.push_back(&p_request);
+            }
+
+            break;
+        }
+        case ShaderCompileMode::SharedContext:
+        {
+            {
+                std::lock_guard<std::mutex> lock(p_compiler.mutex);
+                p_compiler.queuedRequests.push_back(&p_request);
+            }
+
+            p_compiler.condition.notify_one();
+            break;
+        }
+        }
+    }
+
+    //Once per frame, finishes the links the driver completed in ParallelExtension mode
+    static void Update(ShaderCompiler& p_compiler)
+    {
+        PACO_PROFILE_SCOPE("ShaderCompiler::Update");
+
+        for (size_t pending = 0; pending < p_compiler.pendingLinks.size();)
+        {
+            ShaderCompileRequest& request = *p_compiler.pendingLinks[pending];
+
+            if (!ShaderProgramFunctions::IsCreateComplete(request.shaderProgram))
+            {
+                pending++;
+                continue;
+            }
+
+            Complete(p_compiler, request, ShaderProgramFunctions::EndCreate(request.shaderProgram, p_compiler.cache, request.link));
+
+            p_compiler.pendingLinks[pending] = p_compiler.pendingLinks.back();
+            p_compiler.pendingLinks.pop_back();
+        }
+    }
+
+    //Blocks until p_request leaves Pending, meant for loading screens and not for the frame loop
+    static void Wait(ShaderCompiler& p_compiler, const ShaderCompileRequest& p_request)
+    {
+        while (p_request.state.load(std::memory_order_acquire) == ShaderCompileState::Pending)
+        {
+            Update(p_compiler);
+            std::this_thread::yield();
+        }
+    }
+
+    static ShaderCompilerStats GetStats(const ShaderCompiler& p_compiler)
+    {
+        ShaderCompilerStats stats;
+        stats.submittedCount = p_compiler.submittedCount;
+        stats.pendingCount = p_compiler.pendingCount.load();
+
+        return stats;
+    }
+
+    //Requests still queued stay Pending and are never built, in-flight links are finished first
+    static void Destroy(ShaderCompiler& p_compiler)
+    {
+        if (p_compiler.thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(p_compiler.mutex);
+                p_compiler.stopRequested = true;
+            }
+
+            p_compiler.condition.notify_one();
+            p_compiler.thread.join();
+        }
+
+        if (p_compiler.context != nullptr)
+        {
+            SDL_GL_DestroyContext(p_compiler.context);
+            p_compiler.context = nullptr;
+        }
+
+        if (p_compiler.workerWindow != nullptr)
+        {
+            SDL_DestroyWindow(p_compiler.workerWindow);
+            p_compiler.workerWindow = nullptr;
+        }
+
+        for (ShaderCompileRequest* request : p_compiler.pendingLinks)
+        {
+            Complete(p_compiler, *request, ShaderProgramFunctions::EndCreate(request->shaderProgram, p_compiler.cache, request->link));
+        }
+
+        p_compiler.pendingLinks.clear();
+        p_compiler.queuedRequests.clear();
+    }
+}
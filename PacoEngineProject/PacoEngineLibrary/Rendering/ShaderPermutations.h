@@ -0,0 +1,267 @@
+#pragma once
+
+//std
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL.h>
+#include <glad/glad/gl.h>
+#include <stb_include.h>
+
+//engine
+#include "Rendering/ShaderCompiler.h"
+#include "Rendering/ShaderProgram.h"
+
+
+struct ShaderPermutationStats
+{
+    //Distinct feature masks requested so far
+    unsigned int variantCount = 0;
+
+    //Programs actually built, variants whose preprocessed sources are identical share one
+    unsigned int programCount = 0;
+
+    //GetProgram calls answered with the fallback program because the variant was still compiling
+    unsigned int fallbackCount = 0;
+};
+
+//Variants of one shader selected by a feature mask, bit i of the mask defines features[i].
+//Stage sources mark with a #inject line, right after #version, where the variant #defines go,
+//and may #include "file" relative to the include directory. stb_include.h is compiled by the application :
+//exactly one of its sources defines STB_INCLUDE_IMPLEMENTATION and STB_INCLUDE_LINE_GLSL before including it.
+struct ShaderPermutations
+{
+    std::vector<std::string> features;
+    std::vector<GLenum> stageTypes;
+
+    //Stage sources with their includes resolved, the #inject line is kept for the defines
+    std::vector<std::string> resolvedSources;
+
+    std::unordered_map<uint32_t, ShaderCompileRequest*> variants;
+
+    //Programs sharing a hash are told apart by their stage sources
+    std::unordered_map<uint64_t, std::vector<ShaderCompileRequest*>> programsBySourceHash;
+
+    //Deque so requests keep their address while the compiler works on them
+    std::deque<ShaderCompileRequest> programs;
+
+    //Drawn with while a requested variant compiles, built when the permutations are created
+    ShaderCompileRequest* fallback = nullptr;
+
+    ShaderPermutationStats stats;
+};
+
+namespace ShaderPermutationFunctions
+{
+    constexpr const char* injectMarker = "#inject";
+
+    //One bit of the feature mask per feature
+    constexpr size_t maxFeatureCount = 32;
+
+    static bool ResolveIncludes(const char* p_source, const char* p_includeDirectory, std::string& p_outSource)
+    {
+        //stb_include takes mutable strings but only reads them
+        std::string source = p_source;
+        std::string includeDirectory = p_includeDirectory;
+        std::string inject = injectMarker;
+        char error[256] = {};
+
+        char* resolved = stb_include_string(source.data(), inject.data(), includeDirectory.data(), nullptr, error);
+
+        if (resolved == nullptr)
+        {
+            SDL_Log("Failed to resolve shader includes : %s", error);
+            return false;
+        }
+
+        p_outSource = resolved;
+        std::free(resolved);
+
+        if (p_outSource.find(injectMarker) == std::string::npos)
+        {
+            SDL_Log("Shader source has no %s line for its permutation defines", injectMarker);
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool IsIdentifierCharacter(char p_character)
+    {
+        return (p_character >= 'a' && p_character <= 'z') || (p_character >= 'A' && p_character <= 'Z') || (p_character >= '0' && p_character <= '9') || p_character == '_';
+    }
+
+    //Whole identifier search, so a stage that never tests a feature gets the same source with or without it
+    static bool UsesFeature(const std::string& p_source, const std::string& p_feature)
+    {
+        for (size_t position = p_source.find(p_feature); position != std::string::npos; position = p_source.find(p_feature, position + 1))
+        {
+            bool isStart = position == 0 || !IsIdentifierCharacter(p_source[position - 1]);
+            bool isEnd = position + p_feature.size() == p_source.size() || !IsIdentifierCharacter(p_source[position + p_feature.size()]);
+
+            if (isStart && isEnd)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    static std::string ExpandSource(const ShaderPermutations& p_permutations, size_t p_stage, uint32_t p_featureMask)
+    {
+        const std::string& resolvedSource = p_permutations.resolvedSources[p_stage];
+        std::string defines;
+
+        for (size_t feature = 0; feature < p_permutations.features.size(); feature++)
+        {
+            if ((p_featureMask & (1u << feature)) != 0 && UsesFeature(resolvedSource, p_permutations.features[feature]))
+            {
+                defines += "#define " + p_permutations.features[feature] + " 1\n";
+            }
+        }
+
+        //stb_include follows the marker with a #line directive, so the added lines do not shift error line numbers
+        std::string expanded = resolvedSource;
+        expanded.replace(expanded.find(injectMarker), std::strlen(injectMarker), defines);
+
+        return expanded;
+    }
+
+    //Returns the request building the variant, submitting it to p_compiler on first use.
+    //Never waits, the request may still be Pending.
+    static ShaderCompileRequest& Request(ShaderPermutations& p_permutations, ShaderCompiler& p_compiler, uint32_t p_featureMask)
+    {
+        auto variant = p_permutations.variants.find(p_featureMask);
+
+        if (variant != p_permutations.variants.end())
+        {
+            return *variant->second;
+        }
+
+        std::vector<std::string> sources;
+        std::vector<ShaderStage> stages;
+
+        for (size_t stage = 0; stage < p_permutations.stageTypes.size(); stage++)
+        {
+            sources.push_back(ExpandSource(p_permutations, stage, p_featureMask));
+        }
+
+        for (size_t stage = 0; stage < sources.size(); stage++)
+        {
+            stages.push_back({ p_permutations.stageTypes[stage], sources[stage].c_str() });
+        }
+
+        uint64_t sourceHash = ShaderProgramFunctions::ComputeSourceHash(stages);
+        p_permutations.stats.variantCount++;
+
+        std::vector<ShaderCompileRequest*>& sameHashPrograms = p_permutations.programsBySourceHash[sourceHash];
+
+        for (ShaderCompileRequest* existing : sameHashPrograms)
+        {
+            if (existing->stageSources == sources)
+            {
+                p_permutations.variants.emplace(p_featureMask, existing);
+                return *existing;
+            }
+        }
+
+        ShaderCompileRequest& request = p_permutations.programs.emplace_back();
+        request.stageTypes = p_permutations.stageTypes;
+        request.stageSources = std::move(sources);
+
+        p_permutations.variants.emplace(p_featureMask, &request);
+        sameHashPrograms.push_back(&request);
+        p_permutations.stats.programCount++;
+
+        ShaderCompilerFunctions::Submit(p_compiler, request);
+
+        return request;
+    }
+
+    //Resolves the includes of p_stages and builds the p_fallbackMask variant, waiting for it.
+    //Meant for load time, p_features holds at most maxFeatureCount names.
+    static bool Create(ShaderPermutations& p_permutations, ShaderCompiler& p_compiler, std::span<const ShaderStage> p_stages, std::span<const char* const> p_features,
+        const char* p_includeDirectory = ".", uint32_t p_fallbackMask = 0)
+    {
+        if (p_features.size() > maxFeatureCount)
+        {
+            SDL_Log("Shader permutations take at most %zu features, %zu given", maxFeatureCount, p_features.size());
+            return false;
+        }
+
+        p_permutations.features.assign(p_features.begin(), p_features.end());
+
+        for (const ShaderStage& stage : p_stages)
+        {
+            std::string resolvedSource;
+
+            if (!ResolveIncludes(stage.source, p_includeDirectory, resolvedSource))
+            {
+                return false;
+            }
+
+            p_permutations.stageTypes.push_back(stage.type);
+            p_permutations.resolvedSources.push_back(std::move(resolvedSource));
+        }
+
+        p_permutations.fallback = &Request(p_permutations, p_compiler, p_fallbackMask);
+        ShaderCompilerFunctions::Wait(p_compiler, *p_permutations.fallback);
+
+        return p_permutations.fallback->state.load(std::memory_order_acquire) == ShaderCompileState::Ready;
+    }
+
+    //Starts building variants ahead of their first use
+    static void Prewarm(ShaderPermutations& p_permutations, ShaderCompiler& p_compiler, std::span<const uint32_t> p_featureMasks)
+    {
+        for (uint32_t featureMask : p_featureMasks)
+        {
+            Request(p_permutations, p_compiler, featureMask);
+        }
+    }
+
+    //Program of the variant, or of the fallback variant while it compiles or if it failed to build. Never waits.
+    static GLuint GetProgram(ShaderPermutations& p_permutations, ShaderCompiler& p_compiler, uint32_t p_featureMask)
+    {
+        ShaderCompileRequest& request = Request(p_permutations, p_compiler, p_featureMask);
+
+        if (request.state.load(std::memory_order_acquire) == ShaderCompileState::Ready)
+        {
+            return request.shaderProgram.program;
+        }
+
+        p_permutations.stats.fallbackCount++;
+
+        return p_permutations.fallback->shaderProgram.program;
+    }
+
+    static const ShaderPermutationStats& GetStats(const ShaderPermutations& p_permutations)
+    {
+        return p_permutations.stats;
+    }
+
+    //p_compiler must not be building any of these programs anymore, call it after ShaderCompilerFunctions::Destroy
+    //or once the compiler has no pending request
+    static void Delete(ShaderPermutations& p_permutations)
+    {
+        for (ShaderCompileRequest& request : p_permutations.programs)
+        {
+            if (request.state.load(std::memory_order_acquire) == ShaderCompileState::Ready)
+            {
+                ShaderProgramFunctions::Delete(request.shaderProgram);
+            }
+        }
+
+        p_permutations.variants.clear();
+        p_permutations.programsBySourceHash.clear();
+        p_permutations.programs.clear();
+        p_permutations.fallback = nullptr;
+    }
+}
@@ -0,0 +1,375 @@
+#pragma once
+
+//std
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "Core/Hash.h"
+#include "Core/Profiler.h"
+
+
+struct ShaderStage
+{
+    GLenum type;
+    const char* source;
+};
+
+struct ShaderProgramCacheStats
+{
+    unsigned int binaryLoadCount = 0;
+    unsigned int sourceBuildCount = 0;
+
+    //Binaries found on disk but refused, by the header check or by glProgramBinary after a driver update
+    unsigned int rejectedBinaryCount = 0;
+
+    Uint64 binaryLoadNs = 0;
+    Uint64 sourceBuildNs = 0;
+};
+
+//On-disk cache of linked program binaries, one file per program named after the hash of its sources.
+//Binaries only work on the driver that produced them, the driver hash stored in every file rejects the others.
+struct ShaderProgramCache
+{
+    std::string directory;
+    uint64_t driverHash = 0;
+
+    //False when the driver exposes no binary format, programs are then always built from source
+    bool isEnabled = false;
+
+    ShaderProgramCacheStats stats;
+};
+
+struct ShaderProgram
+{
+    GLuint program = 0;
+    uint64_t sourceHash = 0;
+    bool isLoadedFromBinary = false;
+    Uint64 buildNs = 0;
+};
+
+//Shaders of a program whose link was issued but not checked yet, see BeginCreate
+struct ShaderProgramLink
+{
+    std::vector<GLuint> shaders;
+    Uint64 startNs = 0;
+};
+
+//Header of a cached binary file, followed by length bytes of binary
+struct ShaderProgramBinaryHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t driverHash;
+    uint32_t format;
+    uint32_t length;
+};
+
+namespace ShaderProgramFunctions
+{
+    constexpr uint32_t binaryMagic = 0x42535050; //"PPSB"
+    constexpr uint32_t binaryVersion = 1;
+
+    static uint64_t ComputeSourceHash(std::span<const ShaderStage> p_stages)
+    {
+        uint64_t hash = HashFunctions::fnvOffsetBasis;
+
+        for (const ShaderStage& stage : p_stages)
+        {
+            hash = HashFunctions::HashValue(hash, stage.type);
+            hash = HashFunctions::HashString(hash, stage.source);
+        }
+
+        return hash;
+    }
+
+    //Needs a current GL context, p_directory is created if missing
+    static bool CreateCache(ShaderProgramCache& p_cache, const char* p_directory)
+    {
+        p_cache = ShaderProgramCache{};
+        p_cache.directory = p_directory;
+
+        if (!p_cache.directory.empty() && p_cache.directory.back() != '/' && p_cache.directory.back() != '\\')
+        {
+            p_cache.directory += '/';
+        }
+
+        uint64_t hash = HashFunctions::fnvOffsetBasis;
+        hash = HashFunctions::HashString(hash, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+        hash = HashFunctions::HashString(hash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+        hash = HashFunctions::HashString(hash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+        p_cache.driverHash = hash;
+
+        GLint binaryFormatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+
+        if (binaryFormatCount == 0)
+        {
+            SDL_Log("Driver exposes no program binary format, shader programs will be built from source");
+            return false;
+        }
+
+        if (!SDL_CreateDirectory(p_cache.directory.c_str()))
+        {
+            SDL_Log("Failed to create shader cache directory %s : %s", p_cache.directory.c_str(), SDL_GetError());
+            return false;
+        }
+
+        p_cache.isEnabled = true;
+
+        return true;
+    }
+
+    static std::string GetBinaryPath(const ShaderProgramCache& p_cache, uint64_t p_sourceHash)
+    {
+        char fileName[32];
+        std::snprintf(fileName, sizeof(fileName), "%016llx.bin", static_cast<unsigned long long>(p_sourceHash));
+
+        return p_cache.directory + fileName;
+    }
+
+    //The compile status is not queried here, with GL_KHR_parallel_shader_compile that would wait for the compile
+    static GLuint CompileShader(const ShaderStage& p_stage)
+    {
+        GLuint shader = glCreateShader(p_stage.type);
+        glShaderSource(shader, 1, &p_stage.source, nullptr);
+        glCompileShader(shader);
+
+        return shader;
+    }
+
+    static void BeginLink(GLuint p_program, std::span<const ShaderStage> p_stages, bool p_isRetrievable, std::vector<GLuint>& p_outShaders)
+    {
+        for (const ShaderStage& stage : p_stages)
+        {
+            GLuint shader = CompileShader(stage);
+            glAttachShader(p_program, shader);
+            p_outShaders.push_back(shader);
+        }
+
+        //Without the hint some drivers return an empty or incomplete binary
+        glProgramParameteri(p_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, p_isRetrievable ? GL_TRUE : GL_FALSE);
+        glLinkProgram(p_program);
+    }
+
+    //Checks the link issued by BeginLink and releases its shaders, the logs of every stage are printed when it failed
+    static bool EndLink(GLuint p_program, std::vector<GLuint>& p_shaders)
+    {
+        GLint status = GL_FALSE;
+        glGetProgramiv(p_program, GL_LINK_STATUS, &status);
+
+        char log[1024];
+
+        if (status == GL_FALSE)
+        {
+            for (GLuint shader : p_shaders)
+            {
+                GLint compileStatus = GL_FALSE;
+                glGetShaderiv(shader, GL_COMPILE_STATUS, &compileStatus);
+
+                if (compileStatus == GL_FALSE)
+                {
+                    glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+                    SDL_Log("Shader failed to compile : %s", log);
+                }
+            }
+
+            glGetProgramInfoLog(p_program, sizeof(log), nullptr, log);
+            SDL_Log("Shader program failed to link : %s", log);
+        }
+
+        for (GLuint shader : p_shaders)
+        {
+            glDetachShader(p_program, shader);
+            glDeleteShader(shader);
+        }
+
+        p_shaders.clear();
+
+        return status == GL_TRUE;
+    }
+
+    //Returns false when there is no usable binary, a missing file is not counted as a rejection
+    static bool LoadBinary(ShaderProgramCache& p_cache, GLuint p_program, uint64_t p_sourceHash)
+    {
+        size_t fileSize = 0;
+        void* file = SDL_LoadFile(GetBinaryPath(p_cache, p_sourceHash).c_str(), &fileSize);
+
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        ShaderProgramBinaryHeader header = {};
+        bool isValid = fileSize >= sizeof(header);
+
+        if (isValid)
+        {
+            std::memcpy(&header, file, sizeof(header));
+            isValid = header.magic == binaryMagic && header.version == binaryVersion && header.sourceHash == p_sourceHash
+                && header.driverHash == p_cache.driverHash && fileSize == sizeof(header) + header.length;
+        }
+
+        if (isValid)
+        {
+            glProgramBinary(p_program, header.format, static_cast<const char*>(file) + sizeof(header), static_cast<GLsizei>(header.length));
+
+            GLint status = GL_FALSE;
+            glGetProgramiv(p_program, GL_LINK_STATUS, &status);
+            isValid = status == GL_TRUE;
+        }
+
+        SDL_free(file);
+
+        if (!isValid)
+        {
+            p_cache.stats.rejectedBinaryCount++;
+        }
+
+        return isValid;
+    }
+
+    static bool SaveBinary(const ShaderProgramCache& p_cache, GLuint p_program, uint64_t p_sourceHash)
+    {
+        GLint length = 0;
+        glGetProgramiv(p_program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+        if (length <= 0)
+        {
+            return false;
+        }
+
+        std::vector<char> file(sizeof(ShaderProgramBinaryHeader) + static_cast<size_t>(length));
+
+        ShaderProgramBinaryHeader header = {};
+        header.magic = binaryMagic;
+        header.version = binaryVersion;
+        header.sourceHash = p_sourceHash;
+        header.driverHash = p_cache.driverHash;
+
+        GLsizei writtenLength = 0;
+        glGetProgramBinary(p_program, length, &writtenLength, &header.format, file.data() + sizeof(header));
+        header.length = static_cast<uint32_t>(writtenLength);
+        std::memcpy(file.data(), &header, sizeof(header));
+
+        if (!SDL_SaveFile(GetBinaryPath(p_cache, p_sourceHash).c_str(), file.data(), sizeof(header) + header.length))
+        {
+            SDL_Log("Failed to save shader program binary : %s", SDL_GetError());
+            return false;
+        }
+
+        return true;
+    }
+
+    //True once the program can be queried without waiting, always true without GL_KHR_parallel_shader_compile
+    static bool IsCreateComplete(const ShaderProgram& p_shaderProgram)
+    {
+        if (!GLAD_GL_KHR_parallel_shader_compile && !GLAD_GL_ARB_parallel_shader_compile)
+        {
+            return true;
+        }
+
+        GLint isComplete = GL_TRUE;
+        glGetProgramiv(p_shaderProgram.program, GL_COMPLETION_STATUS_KHR, &isComplete);
+
+        return isComplete == GL_TRUE;
+    }
+
+    //First half of Create, returns true when the program was loaded from p_cache and is ready.
+    //Otherwise the link is issued and EndCreate finishes it, calling it once IsCreateComplete is true never waits.
+    static bool BeginCreate(ShaderProgram& p_shaderProgram, std::span<const ShaderStage> p_stages, ShaderProgramCache* p_cache, ShaderProgramLink& p_outLink)
+    {
+        PACO_PROFILE_SCOPE("ShaderProgram::BeginCreate");
+
+        p_outLink = ShaderProgramLink{};
+        p_outLink.startNs = SDL_GetTicksNS();
+
+        p_shaderProgram = ShaderProgram{};
+        p_shaderProgram.sourceHash = ComputeSourceHash(p_stages);
+        p_shaderProgram.program = glCreateProgram();
+
+        bool isCacheEnabled = p_cache != nullptr && p_cache->isEnabled;
+
+        if (isCacheEnabled && LoadBinary(*p_cache, p_shaderProgram.program, p_shaderProgram.sourceHash))
+        {
+            p_shaderProgram.isLoadedFromBinary = true;
+            p_shaderProgram.buildNs = SDL_GetTicksNS() - p_outLink.startNs;
+            p_cache->stats.binaryLoadCount++;
+            p_cache->stats.binaryLoadNs += p_shaderProgram.buildNs;
+            return true;
+        }
+
+        //A rejected binary may leave the program in a failed link state, start from a fresh one
+        if (isCacheEnabled)
+        {
+            glDeleteProgram(p_shaderProgram.program);
+            p_shaderProgram.program = glCreateProgram();
+        }
+
+        BeginLink(p_shaderProgram.program, p_stages, isCacheEnabled, p_outLink.shaders);
+
+        return false;
+    }
+
+    //buildNs of a program created in two halves includes the time spent between them
+    static bool EndCreate(ShaderProgram& p_shaderProgram, ShaderProgramCache* p_cache, ShaderProgramLink& p_link)
+    {
+        PACO_PROFILE_SCOPE("ShaderProgram::EndCreate");
+
+        if (!EndLink(p_shaderProgram.program, p_link.shaders))
+        {
+            glDeleteProgram(p_shaderProgram.program);
+            p_shaderProgram.program = 0;
+            return false;
+        }
+
+        if (p_cache != nullptr && p_cache->isEnabled)
+        {
+            SaveBinary(*p_cache, p_shaderProgram.program, p_shaderProgram.sourceHash);
+        }
+
+        p_shaderProgram.buildNs = SDL_GetTicksNS() - p_link.startNs;
+
+        if (p_cache != nullptr)
+        {
+            p_cache->stats.sourceBuildCount++;
+            p_cache->stats.sourceBuildNs += p_shaderProgram.buildNs;
+        }
+
+        return true;
+    }
+
+    //Loads the program from p_cache when it holds a binary for these sources and this driver,
+    //otherwise builds it from source and stores its binary. p_cache may be null to always build from source.
+    static bool Create(ShaderProgram& p_shaderProgram, std::span<const ShaderStage> p_stages, ShaderProgramCache* p_cache = nullptr)
+    {
+        ShaderProgramLink link;
+
+        if (BeginCreate(p_shaderProgram, p_stages, p_cache, link))
+        {
+            return true;
+        }
+
+        return EndCreate(p_shaderProgram, p_cache, link);
+    }
+
+    static const ShaderProgramCacheStats& GetStats(const ShaderProgramCache& p_cache)
+    {
+        return p_cache.stats;
+    }
+
+    static void Delete(ShaderProgram& p_shaderProgram)
+    {
+        glDeleteProgram(p_shaderProgram.program);
+        p_shaderProgram = ShaderProgram{};
+    }
+}
@@ -0,0 +1,265 @@
+#pragma once
+
+//std
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL_log.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "Core/Profiler.h"
+#include "Core/RadixSort.h"
+#include "Rendering/StreamingRenderComponent.h"
+#include "Rendering/TextureArrayAtlas.h"
+
+
+//layer is the texture array layer, shaders sampling a plain sampler2D read the uv as a vec2 and ignore it
+struct SpriteVertex
+{
+    float x, y;
+    float u, v, layer;
+    float r, g, b, a;
+
+    static const std::array<VertexAttribute, 3> attributes;
+};
+
+constexpr std::array<VertexAttribute, 3> SpriteVertex::attributes =
+{{
+    { 0, 2, GL_FLOAT, GL_FALSE, offsetof(SpriteVertex, x) },
+    { 1, 3, GL_FLOAT, GL_FALSE, offsetof(SpriteVertex, u) },
+    { 2, 4, GL_FLOAT, GL_FALSE, offsetof(SpriteVertex, r) },
+}};
+
+struct Sprite
+{
+    float x, y;
+    float width, height;
+    float u0, v0, u1, v1;
+    float layer;
+    float r, g, b, a;
+    GLuint texture;
+    GLuint program;
+};
+
+struct SpriteBatchStats
+{
+    unsigned int quadCount = 0;
+    unsigned int flushCount = 0;
+    unsigned int droppedQuadCount = 0;
+};
+
+//Collects the sprites of a frame, sorts them by program and texture and draws every run of
+//identical state with a single glDrawElements out of one shared StreamingRenderComponent.
+//Sprites sharing a program and texture keep their submission order.
+struct SpriteBatch
+{
+    StreamingRenderComponent streamingComponent;
+    unsigned int quadCapacity = 0;
+
+    std::vector<Sprite> sprites;
+    std::vector<uint64_t> sortKeys;
+    std::vector<uint32_t> sortIndices;
+    std::vector<uint64_t> sortScratchKeys;
+    std::vector<uint32_t> sortScratchIndices;
+
+    SpriteBatchStats frameStats;
+    SpriteBatchStats lastFrameStats;
+};
+
+namespace SpriteBatchFunctions
+{
+    //Quads addressable with 16 bit indices from one base vertex, larger batches are drawn in chunks of this size
+    constexpr unsigned int quadsPerIndexChunk = IndexTypeTraits<uint16_t>::maxVertexCount / 4;
+
+    //Every chunk reuses the same indices with a different base vertex, so the index buffer never exceeds one chunk.
+    //A quad is 4 consecutive vertices going around it.
+    static std::vector<uint16_t> CreateQuadIndices(unsigned int p_quadCapacity)
+    {
+        const unsigned int indexedQuadCount = p_quadCapacity < quadsPerIndexChunk ? p_quadCapacity : quadsPerIndexChunk;
+
+        std::vector<uint16_t> quadIndices(static_cast<size_t>(indexedQuadCount) * 6);
+
+        for (unsigned int quad = 0; quad < indexedQuadCount; quad++)
+        {
+            uint16_t firstVertex = static_cast<uint16_t>(quad * 4);
+            uint16_t* index = &quadIndices[static_cast<size_t>(quad) * 6];
+            index[0] = firstVertex;
+            index[1] = firstVertex + 1;
+            index[2] = firstVertex + 2;
+            index[3] = firstVertex + 2;
+            index[4] = firstVertex + 3;
+            index[5] = firstVertex;
+        }
+
+        return quadIndices;
+    }
+
+    //p_quadCapacity is the maximum number of sprites drawn in a single frame
+    static bool Create(SpriteBatch& p_spriteBatch, unsigned int p_quadCapacity)
+    {
+        std::vector<uint16_t> quadIndices = CreateQuadIndices(p_quadCapacity);
+
+        if (!StreamingRenderComponentFunctions::CreateWithStaticIndices<SpriteVertex>(p_spriteBatch.streamingComponent, p_quadCapacity * 4, quadIndices.data(), static_cast<unsigned int>(quadIndices.size())))
+        {
+            SDL_Log("Failed to create SpriteBatch with a capacity of %u quads", p_quadCapacity);
+            return false;
+        }
+
+        RenderComponentFunctions::SetAttributeFormats<SpriteVertex>(p_spriteBatch.streamingComponent.renderComponent);
+
+        p_spriteBatch.quadCapacity = p_quadCapacity;
+        p_spriteBatch.sprites.reserve(p_quadCapacity);
+        p_spriteBatch.sortKeys.reserve(p_quadCapacity);
+        p_spriteBatch.sortIndices.reserve(p_quadCapacity);
+        p_spriteBatch.sortScratchKeys.reserve(p_quadCapacity);
+        p_spriteBatch.sortScratchIndices.reserve(p_quadCapacity);
+
+        return true;
+    }
+
+    static void Begin(SpriteBatch& p_spriteBatch)
+    {
+        p_spriteBatch.sprites.clear();
+        p_spriteBatch.frameStats = SpriteBatchStats{};
+    }
+
+    static void Submit(SpriteBatch& p_spriteBatch, const Sprite& p_sprite)
+    {
+        if (p_spriteBatch.sprites.size() >= p_spriteBatch.quadCapacity)
+        {
+            p_spriteBatch.frameStats.droppedQuadCount++;
+            return;
+        }
+
+        p_spriteBatch.sprites.push_back(p_sprite);
+    }
+
+    //Points p_sprite at a texture packed in a TextureArrayAtlas, sprites of the same atlas batch together whatever their layer
+    static void SetAtlasRegion(Sprite& p_sprite, const TextureAtlasRegion& p_region)
+    {
+        p_sprite.texture = p_region.texture;
+        p_sprite.layer = static_cast<float>(p_region.layer);
+        p_sprite.u0 = p_region.u0;
+        p_sprite.v0 = p_region.v0;
+        p_sprite.u1 = p_region.u1;
+        p_sprite.v1 = p_region.v1;
+    }
+
+    static uint64_t MakeSortKey(const Sprite& p_sprite)
+    {
+        return (static_cast<uint64_t>(p_sprite.program) << 32) | p_sprite.texture;
+    }
+
+    static void WriteQuad(SpriteVertex* p_vertices, const Sprite& p_sprite)
+    {
+        float right = p_sprite.x + p_sprite.width;
+        float top = p_sprite.y + p_sprite.height;
+
+        p_vertices[0] = { p_sprite.x, p_sprite.y, p_sprite.u0, p_sprite.v0, p_sprite.layer, p_sprite.r, p_sprite.g, p_sprite.b, p_sprite.a };
+        p_vertices[1] = { right,      p_sprite.y, p_sprite.u1, p_sprite.v0, p_sprite.layer, p_sprite.r, p_sprite.g, p_sprite.b, p_sprite.a };
+        p_vertices[2] = { right,      top,        p_sprite.u1, p_sprite.v1, p_sprite.layer, p_sprite.r, p_sprite.g, p_sprite.b, p_sprite.a };
+        p_vertices[3] = { p_sprite.x, top,        p_sprite.u0, p_sprite.v1, p_sprite.layer, p_sprite.r, p_sprite.g, p_sprite.b, p_sprite.a };
+    }
+
+    //Draws quads of the bound stream region indexed with CreateQuadIndices
+    static void DrawQuads(GLStateCache& p_stateCache, GLuint p_program, GLuint p_texture, unsigned int p_firstQuad, unsigned int p_quadCount)
+    {
+        GLStateCacheFunctions::UseProgram(p_stateCache, p_program);
+        GLStateCacheFunctions::BindTextureUnit(p_stateCache, 0, p_texture);
+
+        //A run crossing a chunk boundary is split, each part is drawn from its chunk's base vertex
+        while (p_quadCount > 0)
+        {
+            unsigned int chunkFirstQuad = p_firstQuad - p_firstQuad % quadsPerIndexChunk;
+            unsigned int localFirstQuad = p_firstQuad - chunkFirstQuad;
+            unsigned int drawnQuadCount = quadsPerIndexChunk - localFirstQuad;
+
+            if (drawnQuadCount > p_quadCount)
+            {
+                drawnQuadCount = p_quadCount;
+            }
+
+            glDrawElementsBaseVertex(GL_TRIANGLES, drawnQuadCount * 6, GL_UNSIGNED_SHORT, IndexTypeFunctions::GetOffset(GL_UNSIGNED_SHORT, localFirstQuad * 6), chunkFirstQuad * 4);
+
+            p_firstQuad += drawnQuadCount;
+            p_quadCount -= drawnQuadCount;
+        }
+    }
+
+    //Sorts the submitted sprites, writes them straight into the mapped stream region and issues one draw per state run.
+    //Uniforms of the programs used (view projection for example) must be set before calling End.
+    static void End(SpriteBatch& p_spriteBatch, GLStateCache& p_stateCache)
+    {
+        PACO_PROFILE_SCOPE("SpriteBatch::End");
+        PACO_PROFILE_GPU_SCOPE("SpriteBatch::End");
+
+        std::vector<Sprite>& sprites = p_spriteBatch.sprites;
+        const unsigned int spriteCount = static_cast<unsigned int>(sprites.size());
+
+        p_spriteBatch.frameStats.quadCount = spriteCount;
+
+        if (spriteCount == 0)
+        {
+            p_spriteBatch.lastFrameStats = p_spriteBatch.frameStats;
+            return;
+        }
+
+        p_spriteBatch.sortKeys.resize(spriteCount);
+        p_spriteBatch.sortIndices.resize(spriteCount);
+
+        for (unsigned int sprite = 0; sprite < spriteCount; sprite++)
+        {
+            p_spriteBatch.sortKeys[sprite] = MakeSortKey(sprites[sprite]);
+            p_spriteBatch.sortIndices[sprite] = sprite;
+        }
+
+        RadixSortFunctions::SortKeyValues(p_spriteBatch.sortKeys, p_spriteBatch.sortIndices, p_spriteBatch.sortScratchKeys, p_spriteBatch.sortScratchIndices);
+
+        StreamingRenderComponent& streamingComponent = p_spriteBatch.streamingComponent;
+
+        StreamingRenderComponentFunctions::BeginFrame(streamingComponent);
+
+        GLint firstVertex = 0;
+        SpriteVertex* vertices = StreamingRenderComponentFunctions::AllocateVertices<SpriteVertex>(streamingComponent, spriteCount * 4, firstVertex);
+
+        for (unsigned int sprite = 0; sprite < spriteCount; sprite++)
+        {
+            WriteQuad(vertices + static_cast<size_t>(sprite) * 4, sprites[p_spriteBatch.sortIndices[sprite]]);
+        }
+
+        RenderComponentFunctions::Bind(streamingComponent.renderComponent, p_stateCache);
+
+        unsigned int runStart = 0;
+
+        for (unsigned int sprite = 1; sprite <= spriteCount; sprite++)
+        {
+            if (sprite == spriteCount || p_spriteBatch.sortKeys[sprite] != p_spriteBatch.sortKeys[runStart])
+            {
+                const Sprite& runSprite = sprites[p_spriteBatch.sortIndices[runStart]];
+                DrawQuads(p_stateCache, runSprite.program, runSprite.texture, runStart, sprite - runStart);
+                p_spriteBatch.frameStats.flushCount++;
+                runStart = sprite;
+            }
+        }
+
+        StreamingRenderComponentFunctions::EndFrame(streamingComponent);
+
+        p_spriteBatch.lastFrameStats = p_spriteBatch.frameStats;
+    }
+
+    //Counters of the last finished frame
+    static const SpriteBatchStats& GetStats(const SpriteBatch& p_spriteBatch)
+    {
+        return p_spriteBatch.lastFrameStats;
+    }
+
+    static void Delete(SpriteBatch& p_spriteBatch)
+    {
+        StreamingRenderComponentFunctions::Delete(p_spriteBatch.streamingComponent);
+        p_spriteBatch = SpriteBatch{};
+    }
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+//std
+#include <cstring>
+
+//vendor
+#include <SDL3/SDL_log.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "PacoEngineDefines.h"
+
+
+//Persistently mapped buffer split into one region per frame in flight.
+//The CPU writes the current region while the GPU reads the previous ones, every region is guarded by a fence.
+struct StreamBuffer
+{
+    GLuint buffer = 0;
+    unsigned char* mappedData = nullptr;
+    GLsizeiptr regionSize = 0;
+    unsigned int regionCount = 0;
+    unsigned int currentRegion = 0;
+    GLsizeiptr regionWriteOffset = 0;
+    GLsync regionFences[PACO_MAX_FRAMES_IN_FLIGHT] = {};
+
+    //Number of BeginFrame calls that had to wait on the GPU, should stay at 0
+    unsigned int stallCount = 0;
+};
+
+namespace StreamBufferFunctions
+{
+    static bool Create(StreamBuffer& p_streamBuffer, GLsizeiptr p_regionSize, unsigned int p_regionCount = PACO_MAX_FRAMES_IN_FLIGHT)
+    {
+        if (p_regionCount == 0 || p_regionCount > PACO_MAX_FRAMES_IN_FLIGHT)
+        {
+            SDL_Log("StreamBuffer region count must be between 1 and %d, got %u", PACO_MAX_FRAMES_IN_FLIGHT, p_regionCount);
+            return false;
+        }
+
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        GLsizeiptr totalSize = p_regionSize * p_regionCount;
+
+        glCreateBuffers(1, &p_streamBuffer.buffer);
+        glNamedBufferStorage(p_streamBuffer.buffer, totalSize, nullptr, flags);
+
+        p_streamBuffer.mappedData = static_cast<unsigned char*>(glMapNamedBufferRange(p_streamBuffer.buffer, 0, totalSize, flags));
+
+        if (p_streamBuffer.mappedData == nullptr)
+        {
+            SDL_Log("Failed to persistently map StreamBuffer of %lld bytes", static_cast<long long>(totalSize));
+            glDeleteBuffers(1, &p_streamBuffer.buffer);
+            p_streamBuffer.buffer = 0;
+            return false;
+        }
+
+        p_streamBuffer.regionSize = p_regionSize;
+        p_streamBuffer.regionCount = p_regionCount;
+        p_streamBuffer.currentRegion = 0;
+        p_streamBuffer.regionWriteOffset = 0;
+        p_streamBuffer.stallCount = 0;
+
+        return true;
+    }
+
+    //Byte offset of the current region inside the buffer
+    static GLintptr GetRegionOffset(const StreamBuffer& p_streamBuffer)
+    {
+        return p_streamBuffer.regionSize * p_streamBuffer.currentRegion;
+    }
+
+    //Makes sure the GPU is done with the current region before the CPU writes into it again
+    static void BeginFrame(StreamBuffer& p_streamBuffer)
+    {
+        GLsync& fence = p_streamBuffer.regionFences[p_streamBuffer.currentRegion];
+
+        if (fence != nullptr)
+        {
+            GLenum waitResult = glClientWaitSync(fence, 0, 0);
+
+            if (waitResult == GL_TIMEOUT_EXPIRED)
+            {
+                p_streamBuffer.stallCount++;
+
+                while (waitResult == GL_TIMEOUT_EXPIRED)
+                {
+                    waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, PACO_STREAM_FENCE_TIMEOUT_NS);
+                }
+            }
+
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        p_streamBuffer.regionWriteOffset = 0;
+    }
+
+    //Reserves p_size bytes in the current region, returns nullptr when the region is full.
+    //p_outOffset receives the byte offset of the reservation inside the whole buffer.
+    static void* Allocate(StreamBuffer& p_streamBuffer, GLsizeiptr p_size, GLsizeiptr p_alignment, GLintptr& p_outOffset)
+    {
+        GLsizeiptr alignedOffset = (p_streamBuffer.regionWriteOffset + p_alignment - 1) / p_alignment * p_alignment;
+
+        if (alignedOffset + p_size > p_streamBuffer.regionSize)
+        {
+            return nullptr;
+        }
+
+        p_streamBuffer.regionWriteOffset = alignedOffset + p_size;
+        p_outOffset = GetRegionOffset(p_streamBuffer) + alignedOffset;
+
+        return p_streamBuffer.mappedData + p_outOffset;
+    }
+
+    //Copies p_data into the current region, returns the byte offset inside the whole buffer or -1 when the region is full
+    static GLintptr Write(StreamBuffer& p_streamBuffer, const void* p_data, GLsizeiptr p_size, GLsizeiptr p_alignment = 1)
+    {
+        GLintptr offset = -1;
+        void* destination = Allocate(p_streamBuffer, p_size, p_alignment, offset);
+
+        if (destination == nullptr)
+        {
+            return -1;
+        }
+
+        memcpy(destination, p_data, p_size);
+
+        return offset;
+    }
+
+    //Call after the last draw reading the current region was submitted
+    static void EndFrame(StreamBuffer& p_streamBuffer)
+    {
+        p_streamBuffer.regionFences[p_streamBuffer.currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        p_streamBuffer.currentRegion = (p_streamBuffer.currentRegion + 1) % p_streamBuffer.regionCount;
+    }
+
+    static void Delete(StreamBuffer& p_streamBuffer)
+    {
+        for (GLsync& fence : p_streamBuffer.regionFences)
+        {
+            if (fence != nullptr)
+            {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+
+        if (p_streamBuffer.buffer != 0)
+        {
+            glUnmapNamedBuffer(p_streamBuffer.buffer);
+            glDeleteBuffers(1, &p_streamBuffer.buffer);
+        }
+
+        p_streamBuffer = StreamBuffer{};
+    }
+}
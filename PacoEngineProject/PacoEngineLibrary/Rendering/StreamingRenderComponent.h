@@ -0,0 +1,162 @@
+#pragma once
+
+//engine
+#include "Rendering/RenderComponent.h"
+#include "Rendering/StreamBuffer.h"
+
+
+//RenderComponent whose vertex and index data is rewritten every frame, the index data may also be static.
+//renderComponent.vbo and renderComponent.ebo point at the stream buffers, so the
+//existing RenderComponentFunctions (SetAttributeFormats, Bind, Unbind) work on it unchanged.
+struct StreamingRenderComponent
+{
+    RenderComponent renderComponent;
+    StreamBuffer vertexStream;
+    StreamBuffer indexStream;
+    GLsizei vertexStride = 0;
+};
+
+namespace StreamingRenderComponentFunctions
+{
+    static void CreateVertexArray(StreamingRenderComponent& p_streamingComponent, GLuint p_indexBuffer, GLsizei p_vertexStride)
+    {
+        RenderComponent& renderComponent = p_streamingComponent.renderComponent;
+
+        renderComponent.vbo = p_streamingComponent.vertexStream.buffer;
+        renderComponent.ebo = p_indexBuffer;
+        glCreateVertexArrays(1, &renderComponent.vao);
+
+        renderComponent.vertexStride = p_vertexStride;
+        p_streamingComponent.vertexStride = p_vertexStride;
+
+        glVertexArrayVertexBuffer(renderComponent.vao, 0, renderComponent.vbo, 0, p_streamingComponent.vertexStride);
+        glVertexArrayElementBuffer(renderComponent.vao, renderComponent.ebo);
+    }
+
+    template<typename TVertexType, typename TIndexType = uint32_t>
+    static bool Create(StreamingRenderComponent& p_streamingComponent, unsigned int p_vertexCapacity, unsigned int p_indexCapacity, unsigned int p_regionCount = PACO_MAX_FRAMES_IN_FLIGHT)
+    {
+        if (!StreamBufferFunctions::Create(p_streamingComponent.vertexStream, sizeof(TVertexType) * p_vertexCapacity, p_regionCount))
+        {
+            return false;
+        }
+
+        if (!StreamBufferFunctions::Create(p_streamingComponent.indexStream, sizeof(TIndexType) * p_indexCapacity, p_regionCount))
+        {
+            StreamBufferFunctions::Delete(p_streamingComponent.vertexStream);
+            return false;
+        }
+
+        CreateVertexArray(p_streamingComponent, p_streamingComponent.indexStream.buffer, sizeof(TVertexType));
+        p_streamingComponent.renderComponent.indexType = IndexTypeTraits<TIndexType>::glType;
+
+        return true;
+    }
+
+    //Only the vertices are streamed, p_indices is uploaded once into an immutable index buffer.
+    //Used when every frame draws the same index pattern, quads for example.
+    template<typename TVertexType, typename TIndexType>
+    static bool CreateWithStaticIndices(StreamingRenderComponent& p_streamingComponent, unsigned int p_vertexCapacity, const TIndexType* p_indices, unsigned int p_indexCount, unsigned int p_regionCount = PACO_MAX_FRAMES_IN_FLIGHT)
+    {
+        if (!StreamBufferFunctions::Create(p_streamingComponent.vertexStream, sizeof(TVertexType) * p_vertexCapacity, p_regionCount))
+        {
+            return false;
+        }
+
+        GLuint staticIndexBuffer = 0;
+        glCreateBuffers(1, &staticIndexBuffer);
+        glNamedBufferStorage(staticIndexBuffer, sizeof(TIndexType) * p_indexCount, p_indices, 0);
+
+        CreateVertexArray(p_streamingComponent, staticIndexBuffer, sizeof(TVertexType));
+        p_streamingComponent.renderComponent.indexType = IndexTypeTraits<TIndexType>::glType;
+
+        return true;
+    }
+
+    static bool HasStaticIndices(const StreamingRenderComponent& p_streamingComponent)
+    {
+        return p_streamingComponent.indexStream.buffer == 0;
+    }
+
+    //Waits for the frame regions to be free and points the vertex binding at the current region,
+    //vertex indices written this frame are therefore relative to the start of the region
+    static void BeginFrame(StreamingRenderComponent& p_streamingComponent)
+    {
+        StreamBufferFunctions::BeginFrame(p_streamingComponent.vertexStream);
+
+        if (!HasStaticIndices(p_streamingComponent))
+        {
+            StreamBufferFunctions::BeginFrame(p_streamingComponent.indexStream);
+        }
+
+        GLintptr regionOffset = StreamBufferFunctions::GetRegionOffset(p_streamingComponent.vertexStream);
+
+        glVertexArrayVertexBuffer(p_streamingComponent.renderComponent.vao, 0, p_streamingComponent.renderComponent.vbo, regionOffset, p_streamingComponent.vertexStride);
+    }
+
+    //Appends vertices to the current region, returns the index of the first written vertex or -1 when the region is full
+    template<typename TVertexType>
+    static GLint UpdateVertexBufferData(StreamingRenderComponent& p_streamingComponent, const void* p_data, unsigned int p_vertexCount)
+    {
+        GLintptr offset = StreamBufferFunctions::Write(p_streamingComponent.vertexStream, p_data, sizeof(TVertexType) * p_vertexCount, sizeof(TVertexType));
+
+        if (offset < 0)
+        {
+            return -1;
+        }
+
+        return static_cast<GLint>((offset - StreamBufferFunctions::GetRegionOffset(p_streamingComponent.vertexStream)) / sizeof(TVertexType));
+    }
+
+    //Reserves p_vertexCount vertices in the current region to be written in place, returns nullptr when the region is full.
+    //p_outFirstVertex receives the index of the first reserved vertex.
+    template<typename TVertexType>
+    static TVertexType* AllocateVertices(StreamingRenderComponent& p_streamingComponent, unsigned int p_vertexCount, GLint& p_outFirstVertex)
+    {
+        GLintptr offset = 0;
+        void* vertices = StreamBufferFunctions::Allocate(p_streamingComponent.vertexStream, sizeof(TVertexType) * p_vertexCount, sizeof(TVertexType), offset);
+
+        if (vertices == nullptr)
+        {
+            return nullptr;
+        }
+
+        p_outFirstVertex = static_cast<GLint>((offset - StreamBufferFunctions::GetRegionOffset(p_streamingComponent.vertexStream)) / sizeof(TVertexType));
+
+        return static_cast<TVertexType*>(vertices);
+    }
+
+    //Appends indices to the current region, returns the byte offset to hand to glDrawElements or -1 when the region is full.
+    //TIndexType must be the index type the component was created with.
+    template<typename TIndexType = uint32_t>
+    static GLintptr UpdateIndexBufferData(StreamingRenderComponent& p_streamingComponent, const void* p_data, unsigned int p_indexCount)
+    {
+        return StreamBufferFunctions::Write(p_streamingComponent.indexStream, p_data, sizeof(TIndexType) * p_indexCount, sizeof(TIndexType));
+    }
+
+    //Call once every draw reading this frame's data was submitted
+    static void EndFrame(StreamingRenderComponent& p_streamingComponent)
+    {
+        StreamBufferFunctions::EndFrame(p_streamingComponent.vertexStream);
+
+        if (!HasStaticIndices(p_streamingComponent))
+        {
+            StreamBufferFunctions::EndFrame(p_streamingComponent.indexStream);
+        }
+    }
+
+    static void Delete(StreamingRenderComponent& p_streamingComponent)
+    {
+        glDeleteVertexArrays(1, &p_streamingComponent.renderComponent.vao);
+
+        if (HasStaticIndices(p_streamingComponent))
+        {
+            glDeleteBuffers(1, &p_streamingComponent.renderComponent.ebo);
+        }
+
+        StreamBufferFunctions::Delete(p_streamingComponent.vertexStream);
+        StreamBufferFunctions::Delete(p_streamingComponent.indexStream);
+
+        p_streamingComponent = StreamingRenderComponent{};
+    }
+}
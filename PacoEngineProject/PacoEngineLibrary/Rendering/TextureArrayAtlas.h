@@ -0,0 +1,237 @@
+#pragma once
+
+//std
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL_log.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "Core/Profiler.h"
+
+
+//Where a texture ended up : sample texture, a GL_TEXTURE_2D_ARRAY, at vec3(uv, layer) with uv inside [u0, u1] x [v0, v1]
+struct TextureAtlasRegion
+{
+    GLuint texture = 0;
+    unsigned int layer = 0;
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 0.0f;
+    float v1 = 0.0f;
+};
+
+//Row of a layer holding textures of similar height side by side
+struct TextureAtlasShelf
+{
+    GLsizei y = 0;
+    GLsizei height = 0;
+    GLsizei nextX = 0;
+};
+
+struct TextureAtlasLayer
+{
+    std::vector<TextureAtlasShelf> shelves;
+    GLsizei nextShelfY = 0;
+    uint64_t usedPixels = 0;
+};
+
+//RGBA8 GL_TEXTURE_2D_ARRAY whose layers are shelf packed. A texture of exactly the layer size takes a whole layer,
+//smaller ones share layers with textures of similar height. Every packed texture is surrounded by padding texels
+//copied from its edges so bilinear filtering never reads a neighbour. There is a single mip level, lower mips
+//would blend neighbours together. Textures cannot be removed, an atlas is rebuilt when its content changes.
+struct TextureArrayAtlas
+{
+    GLuint texture = 0;
+    GLsizei layerWidth = 0;
+    GLsizei layerHeight = 0;
+    GLsizei layerCapacity = 0;
+    GLsizei padding = 0;
+
+    std::vector<TextureAtlasLayer> layers;
+    unsigned int regionCount = 0;
+};
+
+namespace TextureArrayAtlasFunctions
+{
+    //A shelf is reused for textures at most this much shorter than it, shorter ones open a new shelf
+    constexpr GLsizei shelfHeightTolerancePercent = 25;
+
+    static bool Create(TextureArrayAtlas& p_atlas, GLsizei p_layerWidth, GLsizei p_layerHeight, GLsizei p_layerCapacity, GLsizei p_padding = 1)
+    {
+        GLint maxLayers = 0;
+        glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+
+        if (p_layerCapacity <= 0 || p_layerCapacity > maxLayers)
+        {
+            SDL_Log("TextureArrayAtlas layer count must be between 1 and %d, got %d", maxLayers, p_layerCapacity);
+            return false;
+        }
+
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &p_atlas.texture);
+        glTextureStorage3D(p_atlas.texture, 1, GL_RGBA8, p_layerWidth, p_layerHeight, p_layerCapacity);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        p_atlas.layerWidth = p_layerWidth;
+        p_atlas.layerHeight = p_layerHeight;
+        p_atlas.layerCapacity = p_layerCapacity;
+        p_atlas.padding = p_padding;
+        p_atlas.layers.clear();
+        p_atlas.regionCount = 0;
+
+        return true;
+    }
+
+    static GLsizeiptr GetAllocatedBytes(const TextureArrayAtlas& p_atlas)
+    {
+        return static_cast<GLsizeiptr>(p_atlas.layerWidth) * p_atlas.layerHeight * p_atlas.layerCapacity * 4;
+    }
+
+    //Finds room for a p_width x p_height rectangle, padding included, and reserves it
+    static bool Reserve(TextureArrayAtlas& p_atlas, GLsizei p_width, GLsizei p_height, unsigned int& p_outLayer, GLsizei& p_outX, GLsizei& p_outY)
+    {
+        //Best fitting shelf : the shortest one tall enough and not too tall
+        TextureAtlasShelf* bestShelf = nullptr;
+        unsigned int bestLayer = 0;
+
+        for (unsigned int layer = 0; layer < p_atlas.layers.size(); layer++)
+        {
+            for (TextureAtlasShelf& shelf : p_atlas.layers[layer].shelves)
+            {
+                bool fits = shelf.height >= p_height && shelf.nextX + p_width <= p_atlas.layerWidth
+                    && (shelf.height - p_height) * 100 <= shelf.height * shelfHeightTolerancePercent;
+
+                if (fits && (bestShelf == nullptr || shelf.height < bestShelf->height))
+                {
+                    bestShelf = &shelf;
+                    bestLayer = layer;
+                }
+            }
+        }
+
+        if (bestShelf == nullptr)
+        {
+            //New shelf at the bottom of the first layer with enough height left, or in a new layer
+            for (unsigned int layer = 0; layer <= p_atlas.layers.size() && bestShelf == nullptr; layer++)
+            {
+                if (layer == p_atlas.layers.size())
+                {
+                    if (static_cast<GLsizei>(p_atlas.layers.size()) >= p_atlas.layerCapacity)
+                    {
+                        return false;
+                    }
+
+                    p_atlas.layers.emplace_back();
+                }
+
+                TextureAtlasLayer& atlasLayer = p_atlas.layers[layer];
+
+                if (atlasLayer.nextShelfY + p_height <= p_atlas.layerHeight)
+                {
+                    atlasLayer.shelves.push_back({ atlasLayer.nextShelfY, p_height, 0 });
+                    atlasLayer.nextShelfY += p_height;
+                    bestShelf = &atlasLayer.shelves.back();
+                    bestLayer = layer;
+                }
+            }
+        }
+
+        p_outLayer = bestLayer;
+        p_outX = bestShelf->nextX;
+        p_outY = bestShelf->y;
+        bestShelf->nextX += p_width;
+
+        return true;
+    }
+
+    //Writes RGBA8 p_pixels at p_x + p_padding, p_y + p_padding in p_layer of the array p_texture,
+    //with its edge texels repeated p_padding times around it
+    static void UploadPadded(GLuint p_texture, unsigned int p_layer, GLsizei p_x, GLsizei p_y, const uint8_t* p_pixels, GLsizei p_width, GLsizei p_height, GLsizei p_padding)
+    {
+        if (p_padding == 0)
+        {
+            glTextureSubImage3D(p_texture, 0, p_x, p_y, static_cast<GLint>(p_layer), p_width, p_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, p_pixels);
+            return;
+        }
+
+        GLsizei paddedWidth = p_width + p_padding * 2;
+        GLsizei paddedHeight = p_height + p_padding * 2;
+        std::vector<uint8_t> padded(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+
+        for (GLsizei row = 0; row < paddedHeight; row++)
+        {
+            GLsizei sourceRow = row - p_padding < 0 ? 0 : (row - p_padding >= p_height ? p_height - 1 : row - p_padding);
+
+            for (GLsizei column = 0; column < paddedWidth; column++)
+            {
+                GLsizei sourceColumn = column - p_padding < 0 ? 0 : (column - p_padding >= p_width ? p_width - 1 : column - p_padding);
+                std::memcpy(&padded[(static_cast<size_t>(row) * paddedWidth + column) * 4], &p_pixels[(static_cast<size_t>(sourceRow) * p_width + sourceColumn) * 4], 4);
+            }
+        }
+
+        glTextureSubImage3D(p_texture, 0, p_x, p_y, static_cast<GLint>(p_layer), paddedWidth, paddedHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, padded.data());
+    }
+
+    //Copies RGBA8 p_pixels into the atlas, returns false when it is larger than a layer or the atlas is full
+    static bool Add(TextureArrayAtlas& p_atlas, const uint8_t* p_pixels, GLsizei p_width, GLsizei p_height, TextureAtlasRegion& p_outRegion)
+    {
+        PACO_PROFILE_SCOPE("TextureArrayAtlas::Add");
+
+        //Layer sized textures need no padding, clamping to the layer edge already keeps filtering inside them
+        bool isWholeLayer = p_width == p_atlas.layerWidth && p_height == p_atlas.layerHeight;
+        GLsizei padding = isWholeLayer ? 0 : p_atlas.padding;
+        GLsizei paddedWidth = p_width + padding * 2;
+        GLsizei paddedHeight = p_height + padding * 2;
+
+        if (paddedWidth > p_atlas.layerWidth || paddedHeight > p_atlas.layerHeight)
+        {
+            return false;
+        }
+
+        unsigned int layer = 0;
+        GLsizei x = 0;
+        GLsizei y = 0;
+
+        if (isWholeLayer)
+        {
+            if (static_cast<GLsizei>(p_atlas.layers.size()) >= p_atlas.layerCapacity)
+            {
+                return false;
+            }
+
+            layer = static_cast<unsigned int>(p_atlas.layers.size());
+            p_atlas.layers.emplace_back();
+            p_atlas.layers.back().nextShelfY = p_atlas.layerHeight;
+        }
+        else if (!Reserve(p_atlas, paddedWidth, paddedHeight, layer, x, y))
+        {
+            return false;
+        }
+
+        UploadPadded(p_atlas.texture, layer, x, y, p_pixels, p_width, p_height, padding);
+
+        p_outRegion.texture = p_atlas.texture;
+        p_outRegion.layer = layer;
+        p_outRegion.u0 = static_cast<float>(x + padding) / static_cast<float>(p_atlas.layerWidth);
+        p_outRegion.v0 = static_cast<float>(y + padding) / static_cast<float>(p_atlas.layerHeight);
+        p_outRegion.u1 = static_cast<float>(x + padding + p_width) / static_cast<float>(p_atlas.layerWidth);
+        p_outRegion.v1 = static_cast<float>(y + padding + p_height) / static_cast<float>(p_atlas.layerHeight);
+
+        p_atlas.layers[layer].usedPixels += static_cast<uint64_t>(p_width) * p_height;
+        p_atlas.regionCount++;
+
+        return true;
+    }
+
+    static void Delete(TextureArrayAtlas& p_atlas)
+    {
+        glDeleteTextures(1, &p_atlas.texture);
+        p_atlas = TextureArrayAtlas{};
+    }
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+//std
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL_log.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "Rendering/TextureArrayAtlas.h"
+
+
+struct TextureAtlasReport
+{
+    unsigned int atlasCount = 0;
+    unsigned int regionCount = 0;
+    unsigned int usedLayerCount = 0;
+    unsigned int allocatedLayerCount = 0;
+
+    //Textures that fit in no atlas, the caller keeps them as separate textures
+    unsigned int rejectedCount = 0;
+
+    GLsizeiptr allocatedBytes = 0;
+    GLsizeiptr budgetBytes = 0;
+
+    //Texels covered by textures over the texels of the layers in use, padding counts as unused
+    float occupancy = 0.0f;
+};
+
+//Owns the texture array atlases of a scene. Each atlas has its own layer size, a texture goes to the atlas
+//with the smallest layers it fits in so small textures do not fragment the large layers.
+//Every sprite drawn from the same atlas shares one texture bind, whatever its layer.
+struct TextureAtlasManager
+{
+    std::vector<TextureArrayAtlas> atlases;
+    GLsizeiptr budgetBytes = 0;
+    GLsizeiptr allocatedBytes = 0;
+    unsigned int rejectedCount = 0;
+};
+
+namespace TextureAtlasManagerFunctions
+{
+    //p_budgetBytes bounds the video memory of all atlases together
+    static void Create(TextureAtlasManager& p_manager, GLsizeiptr p_budgetBytes)
+    {
+        p_manager.budgetBytes = p_budgetBytes;
+    }
+
+    //Storage is allocated up front, returns false when it would exceed the budget
+    static bool AddAtlas(TextureAtlasManager& p_manager, GLsizei p_layerWidth, GLsizei p_layerHeight, GLsizei p_layerCount, GLsizei p_padding = 1)
+    {
+        GLsizeiptr atlasBytes = static_cast<GLsizeiptr>(p_layerWidth) * p_layerHeight * p_layerCount * 4;
+
+        if (p_manager.allocatedBytes + atlasBytes > p_manager.budgetBytes)
+        {
+            SDL_Log("TextureAtlasManager budget of %lld bytes exceeded by a %dx%dx%d atlas", static_cast<long long>(p_manager.budgetBytes), p_layerWidth, p_layerHeight, p_layerCount);
+            return false;
+        }
+
+        TextureArrayAtlas atlas;
+
+        if (!TextureArrayAtlasFunctions::Create(atlas, p_layerWidth, p_layerHeight, p_layerCount, p_padding))
+        {
+            return false;
+        }
+
+        //Kept sorted by layer area so Add tries the smallest layers first
+        auto position = p_manager.atlases.begin();
+
+        while (position != p_manager.atlases.end() && position->layerWidth * position->layerHeight <= p_layerWidth * p_layerHeight)
+        {
+            position++;
+        }
+
+        p_manager.atlases.insert(position, std::move(atlas));
+        p_manager.allocatedBytes += atlasBytes;
+
+        return true;
+    }
+
+    static bool Add(TextureAtlasManager& p_manager, const uint8_t* p_pixels, GLsizei p_width, GLsizei p_height, TextureAtlasRegion& p_outRegion)
+    {
+        for (TextureArrayAtlas& atlas : p_manager.atlases)
+        {
+            if (TextureArrayAtlasFunctions::Add(atlas, p_pixels, p_width, p_height, p_outRegion))
+            {
+                return true;
+            }
+        }
+
+        p_manager.rejectedCount++;
+
+        return false;
+    }
+
+    static TextureAtlasReport GetReport(const TextureAtlasManager& p_manager)
+    {
+        TextureAtlasReport report;
+        report.atlasCount = static_cast<unsigned int>(p_manager.atlases.size());
+        report.rejectedCount = p_manager.rejectedCount;
+        report.allocatedBytes = p_manager.allocatedBytes;
+        report.budgetBytes = p_manager.budgetBytes;
+
+        uint64_t usedPixels = 0;
+        uint64_t layerPixels = 0;
+
+        for (const TextureArrayAtlas& atlas : p_manager.atlases)
+        {
+            report.regionCount += atlas.regionCount;
+            report.usedLayerCount += static_cast<unsigned int>(atlas.layers.size());
+            report.allocatedLayerCount += static_cast<unsigned int>(atlas.layerCapacity);
+
+            for (const TextureAtlasLayer& layer : atlas.layers)
+            {
+                usedPixels += layer.usedPixels;
+            }
+
+            layerPixels += static_cast<uint64_t>(atlas.layerWidth) * atlas.layerHeight * atlas.layers.size();
+        }
+
+        report.occupancy = layerPixels > 0 ? static_cast<float>(static_cast<double>(usedPixels) / static_cast<double>(layerPixels)) : 0.0f;
+
+        return report;
+    }
+
+    static void LogReport(const TextureAtlasManager& p_manager)
+    {
+        TextureAtlasReport report = GetReport(p_manager);
+
+        SDL_Log("Texture atlases : %u atlases, %u textures, %u rejected, %u/%u layers used, %.1f%% occupancy, %.2f/%.2f MiB",
+            report.atlasCount, report.regionCount, report.rejectedCount, report.usedLayerCount, report.allocatedLayerCount, report.occupancy * 100.0f,
+            static_cast<double>(report.allocatedBytes) / (1024.0 * 1024.0), static_cast<double>(report.budgetBytes) / (1024.0 * 1024.0));
+    }
+
+    static void Delete(TextureAtlasManager& p_manager)
+    {
+        for (TextureArrayAtlas& atlas : p_manager.atlases)
+        {
+            TextureArrayAtlasFunctions::Delete(atlas);
+        }
+
+        p_manager = TextureAtlasManager{};
+    }
+}
@@ -0,0 +1,402 @@
+#pragma once
+
+//std
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL.h>
+#include <glad/glad/gl.h>
+#include <stb_image.h>
+
+//engine
+#include "Core/Profiler.h"
+#include "Rendering/StreamBuffer.h"
+
+
+enum class TextureLoadState
+{
+    Pending,
+    Ready,
+    Failed,
+};
+
+//One texture file loaded in the background, owned by the render thread. A worker only reads the path
+//and fills in the decoded pixels before handing the request back. texture may only be sampled once the state is Ready.
+struct TextureLoadRequest
+{
+    std::string path;
+    TextureLoadState state = TextureLoadState::Pending;
+
+    GLuint texture = 0;
+    GLsizei width = 0;
+    GLsizei height = 0;
+
+    //RGBA8 rows decoded by stb_image, freed once the last row is uploaded
+    stbi_uc* pixels = nullptr;
+    GLsizei uploadedRowCount = 0;
+
+    Uint64 requestNs = 0;
+    Uint64 readyNs = 0;
+};
+
+struct TextureLoaderStats
+{
+    //Requests waiting for a worker, being decoded or decoded since the last Update
+    unsigned int decodeQueueDepth = 0;
+
+    //Decoded requests waiting for upload budget, the front one may be partially uploaded
+    unsigned int uploadQueueDepth = 0;
+
+    unsigned int readyCount = 0;
+    unsigned int failedCount = 0;
+
+    //Bytes copied to the pixel unpack buffer during the last Update
+    GLsizeiptr uploadedBytes = 0;
+
+    //From Load to Ready
+    Uint64 averageLatencyNs = 0;
+    Uint64 maxLatencyNs = 0;
+};
+
+//Loads texture files without stalling the render thread. Worker threads read and decode files with stb_image,
+//Update uploads the decoded rows through a persistently mapped pixel unpack buffer, at most a budget of bytes
+//per frame, large images are spread over several frames. Until a texture is Ready GetTexture returns a placeholder.
+//stb_image.h is compiled by the application : exactly one of its sources defines STB_IMAGE_IMPLEMENTATION before including it.
+struct TextureLoader
+{
+    GLuint placeholderTexture = 0;
+
+    //Pixel unpack buffer, each frame region is the upload budget of a frame
+    StreamBuffer uploadBuffer;
+
+    //Deque so requests keep their address while workers decode them
+    std::deque<TextureLoadRequest> requests;
+    std::unordered_map<std::string, TextureLoadRequest*> requestsByPath;
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<TextureLoadRequest*> queuedRequests;
+    std::deque<TextureLoadRequest*> decodedRequests;
+
+    //File contents are read into these before decoding, reused to avoid an allocation per file
+    std::vector<std::vector<uint8_t>> freeFileBuffers;
+    bool stopRequested = false;
+
+    //Render thread only
+    std::deque<TextureLoadRequest*> uploadQueue;
+    unsigned int pendingCount = 0;
+    unsigned int readyCount = 0;
+    unsigned int failedCount = 0;
+    Uint64 totalLatencyNs = 0;
+    Uint64 maxLatencyNs = 0;
+    GLsizeiptr lastUploadedBytes = 0;
+};
+
+namespace TextureLoaderFunctions
+{
+    static bool ReadFile(const std::string& p_path, std::vector<uint8_t>& p_outBytes)
+    {
+        SDL_IOStream* stream = SDL_IOFromFile(p_path.c_str(), "rb");
+
+        if (stream == nullptr)
+        {
+            return false;
+        }
+
+        Sint64 size = SDL_GetIOSize(stream);
+        bool isRead = size > 0;
+
+        if (isRead)
+        {
+            p_outBytes.resize(static_cast<size_t>(size));
+            isRead = SDL_ReadIO(stream, p_outBytes.data(), p_outBytes.size()) == p_outBytes.size();
+        }
+
+        SDL_CloseIO(stream);
+
+        return isRead;
+    }
+
+    static void RunWorker(TextureLoader& p_loader)
+    {
+        PACO_PROFILE_THREAD_NAME("Texture Loader");
+
+        while (true)
+        {
+            TextureLoadRequest* request = nullptr;
+            std::vector<uint8_t> fileBytes;
+
+            {
+                std::unique_lock<std::mutex> lock(p_loader.mutex);
+                p_loader.condition.wait(lock, [&p_loader]() { return p_loader.stopRequested || !p_loader.queuedRequests.empty(); });
+
+                if (p_loader.stopRequested)
+                {
+                    break;
+                }
+
+                request = p_loader.queuedRequests.front();
+                p_loader.queuedRequests.pop_front();
+
+                if (!p_loader.freeFileBuffers.empty())
+                {
+                    fileBytes = std::move(p_loader.freeFileBuffers.back());
+                    p_loader.freeFileBuffers.pop_back();
+                }
+            }
+
+            PACO_PROFILE_SCOPE("DecodeTexture");
+
+            int width = 0;
+            int height = 0;
+            int channelCount = 0;
+            stbi_uc* pixels = nullptr;
+
+            if (!ReadFile(request->path, fileBytes))
+            {
+                SDL_Log("Failed to read texture %s : %s", request->path.c_str(), SDL_GetError());
+            }
+            else if ((pixels = stbi_load_from_memory(fileBytes.data(), static_cast<int>(fileBytes.size()), &width, &height, &channelCount, 4)) == nullptr)
+            {
+                SDL_Log("Failed to decode texture %s : %s", request->path.c_str(), stbi_failure_reason());
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(p_loader.mutex);
+                request->pixels = pixels;
+                request->width = width;
+                request->height = height;
+                p_loader.decodedRequests.push_back(request);
+                p_loader.freeFileBuffers.push_back(std::move(fileBytes));
+            }
+        }
+    }
+
+    //Called on the thread owning the GL context. p_uploadBudget is the number of bytes uploaded per frame at most,
+    //it must hold at least one row of the widest texture loaded.
+    static bool Create(TextureLoader& p_loader, GLsizeiptr p_uploadBudget, unsigned int p_threadCount = 2)
+    {
+        if (!StreamBufferFunctions::Create(p_loader.uploadBuffer, p_uploadBudget))
+        {
+            return false;
+        }
+
+        //Magenta and black checkerboard, obvious on screen if a texture never finishes loading
+        const uint8_t placeholderPixels[16] = { 255, 0, 255, 255, 0, 0, 0, 255, 0, 0, 0, 255, 255, 0, 255, 255 };
+
+        glCreateTextures(GL_TEXTURE_2D, 1, &p_loader.placeholderTexture);
+        glTextureStorage2D(p_loader.placeholderTexture, 1, GL_RGBA8, 2, 2);
+        glTextureSubImage2D(p_loader.placeholderTexture, 0, 0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, placeholderPixels);
+        glTextureParameteri(p_loader.placeholderTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(p_loader.placeholderTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        for (unsigned int thread = 0; thread < p_threadCount; thread++)
+        {
+            p_loader.threads.emplace_back(RunWorker, std::ref(p_loader));
+        }
+
+        return true;
+    }
+
+    //Returns the request of p_path, queuing it for decoding on first use. Never waits.
+    static TextureLoadRequest& Load(TextureLoader& p_loader, const std::string& p_path)
+    {
+        auto existing = p_loader.requestsByPath.find(p_path);
+
+        if (existing != p_loader.requestsByPath.end())
+        {
+            return *existing->second;
+        }
+
+        TextureLoadRequest& request = p_loader.requests.emplace_back();
+        request.path = p_path;
+        request.requestNs = SDL_GetTicksNS();
+        p_loader.requestsByPath.emplace(p_path, &request);
+
+        p_loader.pendingCount++;
+
+        {
+            std::lock_guard<std::mutex> lock(p_loader.mutex);
+            p_loader.queuedRequests.push_back(&request);
+        }
+
+        p_loader.condition.notify_one();
+
+        return request;
+    }
+
+    static void Fail(TextureLoader& p_loader, TextureLoadRequest& p_request)
+    {
+        stbi_image_free(p_request.pixels);
+        p_request.pixels = nullptr;
+        p_request.state = TextureLoadState::Failed;
+        p_loader.pendingCount--;
+        p_loader.failedCount++;
+    }
+
+    static void Finish(TextureLoader& p_loader, TextureLoadRequest& p_request)
+    {
+        glGenerateTextureMipmap(p_request.texture);
+
+        stbi_image_free(p_request.pixels);
+        p_request.pixels = nullptr;
+        p_request.state = TextureLoadState::Ready;
+        p_request.readyNs = SDL_GetTicksNS();
+
+        Uint64 latencyNs = p_request.readyNs - p_request.requestNs;
+        p_loader.totalLatencyNs += latencyNs;
+        p_loader.maxLatencyNs = latencyNs > p_loader.maxLatencyNs ? latencyNs : p_loader.maxLatencyNs;
+        p_loader.pendingCount--;
+        p_loader.readyCount++;
+    }
+
+    static GLsizei GetMipLevelCount(GLsizei p_width, GLsizei p_height)
+    {
+        GLsizei levelCount = 1;
+
+        for (GLsizei size = p_width > p_height ? p_width : p_height; size > 1; size /= 2)
+        {
+            levelCount++;
+        }
+
+        return levelCount;
+    }
+
+    //Once per frame on the render thread, uploads decoded rows up to the budget in request order
+    static void Update(TextureLoader& p_loader)
+    {
+        PACO_PROFILE_SCOPE("TextureLoader::Update");
+
+        {
+            std::lock_guard<std::mutex> lock(p_loader.mutex);
+            p_loader.uploadQueue.insert(p_loader.uploadQueue.end(), p_loader.decodedRequests.begin(), p_loader.decodedRequests.end());
+            p_loader.decodedRequests.clear();
+        }
+
+        StreamBuffer& uploadBuffer = p_loader.uploadBuffer;
+
+        StreamBufferFunctions::BeginFrame(uploadBuffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer.buffer);
+
+        while (!p_loader.uploadQueue.empty())
+        {
+            TextureLoadRequest& request = *p_loader.uploadQueue.front();
+            GLsizeiptr rowSize = static_cast<GLsizeiptr>(request.width) * 4;
+
+            if (request.pixels == nullptr || rowSize > uploadBuffer.regionSize)
+            {
+                if (request.pixels != nullptr)
+                {
+                    SDL_Log("Texture %s is %d texels wide, a row exceeds the upload budget", request.path.c_str(), request.width);
+                }
+
+                Fail(p_loader, request);
+                p_loader.uploadQueue.pop_front();
+                continue;
+            }
+
+            GLsizei rowCount = static_cast<GLsizei>((uploadBuffer.regionSize - uploadBuffer.regionWriteOffset) / rowSize);
+
+            if (rowCount > request.height - request.uploadedRowCount)
+            {
+                rowCount = request.height - request.uploadedRowCount;
+            }
+
+            if (rowCount == 0)
+            {
+                break;
+            }
+
+            if (request.texture == 0)
+            {
+                glCreateTextures(GL_TEXTURE_2D, 1, &request.texture);
+                glTextureStorage2D(request.texture, GetMipLevelCount(request.width, request.height), GL_RGBA8, request.width, request.height);
+                glTextureParameteri(request.texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+                glTextureParameteri(request.texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            }
+
+            //Rows are whole multiples of 4 bytes, the default unpack alignment holds
+            GLintptr offset = StreamBufferFunctions::Write(uploadBuffer, request.pixels + rowSize * request.uploadedRowCount, rowSize * rowCount, 4);
+            glTextureSubImage2D(request.texture, 0, 0, request.uploadedRowCount, request.width, rowCount, GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(offset));
+
+            request.uploadedRowCount += rowCount;
+
+            if (request.uploadedRowCount == request.height)
+            {
+                Finish(p_loader, request);
+                p_loader.uploadQueue.pop_front();
+            }
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        p_loader.lastUploadedBytes = uploadBuffer.regionWriteOffset;
+        StreamBufferFunctions::EndFrame(uploadBuffer);
+    }
+
+    //Texture to bind for p_request : the loaded one once Ready, the placeholder before and if loading failed
+    static GLuint GetTexture(const TextureLoader& p_loader, const TextureLoadRequest& p_request)
+    {
+        return p_request.state == TextureLoadState::Ready ? p_request.texture : p_loader.placeholderTexture;
+    }
+
+    static TextureLoaderStats GetStats(const TextureLoader& p_loader)
+    {
+        TextureLoaderStats stats;
+        stats.uploadQueueDepth = static_cast<unsigned int>(p_loader.uploadQueue.size());
+        stats.decodeQueueDepth = p_loader.pendingCount - stats.uploadQueueDepth;
+        stats.readyCount = p_loader.readyCount;
+        stats.failedCount = p_loader.failedCount;
+        stats.uploadedBytes = p_loader.lastUploadedBytes;
+        stats.averageLatencyNs = p_loader.readyCount > 0 ? p_loader.totalLatencyNs / p_loader.readyCount : 0;
+        stats.maxLatencyNs = p_loader.maxLatencyNs;
+
+        return stats;
+    }
+
+    //Requests still queued are dropped, decoded pixels not uploaded yet are freed
+    static void Destroy(TextureLoader& p_loader)
+    {
+        {
+            std::lock_guard<std::mutex> lock(p_loader.mutex);
+            p_loader.stopRequested = true;
+        }
+
+        p_loader.condition.notify_all();
+
+        for (std::thread& thread : p_loader.threads)
+        {
+            thread.join();
+        }
+
+        for (TextureLoadRequest& request : p_loader.requests)
+        {
+            stbi_image_free(request.pixels);
+
+            if (request.texture != 0)
+            {
+                glDeleteTextures(1, &request.texture);
+            }
+        }
+
+        glDeleteTextures(1, &p_loader.placeholderTexture);
+        StreamBufferFunctions::Delete(p_loader.uploadBuffer);
+
+        p_loader.threads.clear();
+        p_loader.requests.clear();
+        p_loader.requestsByPath.clear();
+        p_loader.queuedRequests.clear();
+        p_loader.decodedRequests.clear();
+        p_loader.uploadQueue.clear();
+        p_loader.freeFileBuffers.clear();
+    }
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+//std
+#include <cstring>
+
+//vendor
+#include <SDL3/SDL_log.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "Core/Profiler.h"
+#include "Rendering/StreamBuffer.h"
+
+
+//Range of the arena written by one draw, valid until the end of the frame it was allocated in
+struct UniformAllocation
+{
+    void* data = nullptr;
+    GLintptr offset = 0;
+    GLsizeiptr size = 0;
+};
+
+struct UniformArenaStats
+{
+    unsigned int allocationCount = 0;
+    unsigned int failedAllocationCount = 0;
+    unsigned int bindCount = 0;
+
+    //Bytes used in the frame's region, alignment padding included
+    GLsizeiptr usedBytes = 0;
+};
+
+//Per-frame uniform and storage data bump allocated from one persistently mapped StreamBuffer.
+//Every draw writes its constants into a fresh range and binds it with glBindBufferRange,
+//no glUniform* call and no buffer allocation per draw. Ranges are aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT,
+//often 256 bytes, so draws with very small blocks waste most of their range.
+struct UniformArena
+{
+    StreamBuffer streamBuffer;
+    GLsizeiptr uniformAlignment = 256;
+    GLsizeiptr storageAlignment = 256;
+    GLsizeiptr maxUniformBlockSize = 16384;
+
+    UniformArenaStats frameStats;
+    UniformArenaStats lastFrameStats;
+};
+
+namespace UniformArenaFunctions
+{
+    //p_frameSize is the bytes available to one frame, the buffer holds one such region per frame in flight
+    static bool Create(UniformArena& p_arena, GLsizeiptr p_frameSize)
+    {
+        GLint uniformAlignment = 0;
+        GLint storageAlignment = 0;
+        GLint maxUniformBlockSize = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+        glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &maxUniformBlockSize);
+
+        p_arena.uniformAlignment = uniformAlignment > 0 ? uniformAlignment : 256;
+        p_arena.storageAlignment = storageAlignment > 0 ? storageAlignment : 256;
+        p_arena.maxUniformBlockSize = maxUniformBlockSize;
+
+        //Every region starts aligned for both kinds of binding
+        GLsizeiptr regionAlignment = p_arena.uniformAlignment > p_arena.storageAlignment ? p_arena.uniformAlignment : p_arena.storageAlignment;
+        GLsizeiptr regionSize = (p_frameSize + regionAlignment - 1) / regionAlignment * regionAlignment;
+
+        return StreamBufferFunctions::Create(p_arena.streamBuffer, regionSize);
+    }
+
+    //Waits for the GPU to release the region of this frame, see StreamBufferFunctions::BeginFrame
+    static void BeginFrame(UniformArena& p_arena)
+    {
+        PACO_PROFILE_SCOPE("UniformArena::BeginFrame");
+
+        StreamBufferFunctions::BeginFrame(p_arena.streamBuffer);
+        p_arena.frameStats = UniformArenaStats{};
+    }
+
+    static bool Allocate(UniformArena& p_arena, GLsizeiptr p_size, GLsizeiptr p_alignment, UniformAllocation& p_outAllocation)
+    {
+        GLintptr offset = 0;
+        void* data = StreamBufferFunctions::Allocate(p_arena.streamBuffer, p_size, p_alignment, offset);
+
+        if (data == nullptr)
+        {
+            p_arena.frameStats.failedAllocationCount++;
+            return false;
+        }
+
+        p_outAllocation.data = data;
+        p_outAllocation.offset = offset;
+        p_outAllocation.size = p_size;
+
+        p_arena.frameStats.allocationCount++;
+        p_arena.frameStats.usedBytes = p_arena.streamBuffer.regionWriteOffset;
+
+        return true;
+    }
+
+    //Returns false when the frame's region is full or p_size exceeds GL_MAX_UNIFORM_BLOCK_SIZE
+    static bool AllocateUniform(UniformArena& p_arena, GLsizeiptr p_size, UniformAllocation& p_outAllocation)
+    {
+        if (p_size > p_arena.maxUniformBlockSize)
+        {
+            SDL_Log("Uniform block of %lld bytes exceeds GL_MAX_UNIFORM_BLOCK_SIZE", static_cast<long long>(p_size));
+            p_arena.frameStats.failedAllocationCount++;
+            return false;
+        }
+
+        return Allocate(p_arena, p_size, p_arena.uniformAlignment, p_outAllocation);
+    }
+
+    static bool AllocateStorage(UniformArena& p_arena, GLsizeiptr p_size, UniformAllocation& p_outAllocation)
+    {
+        return Allocate(p_arena, p_size, p_arena.storageAlignment, p_outAllocation);
+    }
+
+    //Copies p_value into a new uniform range, TValueType must follow the std140 layout of the block it feeds
+    template<typename TValueType>
+    static bool PushUniform(UniformArena& p_arena, const TValueType& p_value, UniformAllocation& p_outAllocation)
+    {
+        if (!AllocateUniform(p_arena, sizeof(TValueType), p_outAllocation))
+        {
+            return false;
+        }
+
+        std::memcpy(p_outAllocation.data, &p_value, sizeof(TValueType));
+
+        return true;
+    }
+
+    static void BindUniform(UniformArena& p_arena, GLuint p_bindingIndex, const UniformAllocation& p_allocation)
+    {
+        glBindBufferRange(GL_UNIFORM_BUFFER, p_bindingIndex, p_arena.streamBuffer.buffer, p_allocation.offset, p_allocation.size);
+        p_arena.frameStats.bindCount++;
+    }
+
+    static void BindStorage(UniformArena& p_arena, GLuint p_bindingIndex, const UniformAllocation& p_allocation)
+    {
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, p_bindingIndex, p_arena.streamBuffer.buffer, p_allocation.offset, p_allocation.size);
+        p_arena.frameStats.bindCount++;
+    }
+
+    //Call after the last draw reading this frame's allocations was submitted
+    static void EndFrame(UniformArena& p_arena)
+    {
+        StreamBufferFunctions::EndFrame(p_arena.streamBuffer);
+        p_arena.lastFrameStats = p_arena.frameStats;
+    }
+
+    static const UniformArenaStats& GetStats(const UniformArena& p_arena)
+    {
+        return p_arena.lastFrameStats;
+    }
+
+    static void Delete(UniformArena& p_arena)
+    {
+        StreamBufferFunctions::Delete(p_arena.streamBuffer);
+        p_arena = UniformArena{};
+    }
+}
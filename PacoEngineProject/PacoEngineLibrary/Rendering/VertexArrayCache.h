@@ -0,0 +1,79 @@
+#pragma once
+
+//std
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+//vendor
+#include <glad/glad/gl.h>
+
+//engine
+#include "Rendering/VertexLayout.h"
+
+
+//Layout a cached VAO was described with, the attribute arrays are the constexpr ones of the vertex types
+struct CachedVertexArray
+{
+    std::span<const VertexAttribute> attributes;
+    GLsizei stride = 0;
+    GLuint vao = 0;
+};
+
+//One VAO per distinct vertex layout, shared by every RenderComponent using that layout.
+//The VAO only stores the attribute formats, buffers are attached through GLStateCacheFunctions::BindVertexBuffers
+//when a component is bound. Layouts with the same hash are compared and get their own VAO when they differ.
+struct VertexArrayCache
+{
+    std::unordered_map<uint64_t, std::vector<CachedVertexArray>> vertexArrays;
+    unsigned int hitCount = 0;
+    unsigned int missCount = 0;
+};
+
+namespace VertexArrayCacheFunctions
+{
+    template<typename TVertexType>
+    static GLuint GetOrCreate(VertexArrayCache& p_cache)
+    {
+        constexpr uint64_t layoutHash = VertexLayoutFunctions::GetHash<TVertexType>();
+        constexpr GLsizei stride = sizeof(TVertexType);
+        const std::span<const VertexAttribute> attributes = VertexLayout<TVertexType>::attributes;
+
+        std::vector<CachedVertexArray>& candidates = p_cache.vertexArrays[layoutHash];
+
+        for (const CachedVertexArray& candidate : candidates)
+        {
+            if (VertexLayoutFunctions::AreEqual(candidate.attributes, candidate.stride, attributes, stride))
+            {
+                p_cache.hitCount++;
+                return candidate.vao;
+            }
+        }
+
+        p_cache.missCount++;
+
+        CachedVertexArray cached;
+        cached.attributes = attributes;
+        cached.stride = stride;
+        glCreateVertexArrays(1, &cached.vao);
+        VertexLayoutFunctions::ApplyAttributeFormats(cached.vao, attributes);
+
+        candidates.push_back(cached);
+
+        return cached.vao;
+    }
+
+    static void Delete(VertexArrayCache& p_cache)
+    {
+        for (const auto& [layoutHash, candidates] : p_cache.vertexArrays)
+        {
+            for (const CachedVertexArray& cached : candidates)
+            {
+                glDeleteVertexArrays(1, &cached.vao);
+            }
+        }
+
+        p_cache = VertexArrayCache{};
+    }
+}
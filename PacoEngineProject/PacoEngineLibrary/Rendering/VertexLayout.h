@@ -0,0 +1,105 @@
+#pragma once
+
+//std
+#include <array>
+#include <cstdint>
+#include <span>
+
+//vendor
+#include <glad/glad/gl.h>
+
+//engine
+#include "Core/Hash.h"
+
+
+//RenderBuffer Objects
+struct VertexAttribute {
+    GLuint index;          // The attribute location in the vertex shader (0, 1, 2, etc.)
+    GLint size;            // The number of components (1, 2, 3, 4, etc.)
+    GLenum type;           // The OpenGL data type (e.g., GL_FLOAT, GL_INT)
+    GLboolean normalized;  // Whether the attribute should be normalized (GL_TRUE/GL_FALSE)
+    GLuint offset;         // Offset of the attribute in the struct (in bytes)
+};
+
+//Vertex types describe themselves at compile time with a constexpr attribute array.
+//offsetof needs the complete type, so the array is declared in the struct and defined right after it :
+//
+//    struct BaseVertex
+//    {
+//        float x, y, z;
+//        float u, v;
+//        static const std::array<VertexAttribute, 2> attributes;
+//    };
+//
+//    constexpr std::array<VertexAttribute, 2> BaseVertex::attributes =
+//    {{
+//        { 0, 3, GL_FLOAT, GL_FALSE, offsetof(BaseVertex, x) },
+//        { 1, 2, GL_FLOAT, GL_FALSE, offsetof(BaseVertex, u) },
+//    }};
+//
+//VertexLayout can also be specialized for vertex types that cannot be modified.
+template<typename TVertexType>
+struct VertexLayout
+{
+    static constexpr const auto& attributes = TVertexType::attributes;
+};
+
+namespace VertexLayoutFunctions
+{
+    //FNV-1a over every attribute and the stride, equal layouts hash equal whatever struct declared them
+    constexpr uint64_t ComputeHash(std::span<const VertexAttribute> p_attributes, GLsizei p_stride)
+    {
+        uint64_t hash = HashFunctions::HashValue(HashFunctions::fnvOffsetBasis, static_cast<uint64_t>(p_stride));
+
+        for (const VertexAttribute& attribute : p_attributes)
+        {
+            hash = HashFunctions::HashValue(hash, attribute.index);
+            hash = HashFunctions::HashValue(hash, static_cast<uint64_t>(attribute.size));
+            hash = HashFunctions::HashValue(hash, attribute.type);
+            hash = HashFunctions::HashValue(hash, attribute.normalized);
+            hash = HashFunctions::HashValue(hash, attribute.offset);
+        }
+
+        return hash;
+    }
+
+    template<typename TVertexType>
+    constexpr uint64_t GetHash()
+    {
+        return ComputeHash(VertexLayout<TVertexType>::attributes, sizeof(TVertexType));
+    }
+
+    //Hash collisions are told apart with this field by field comparison
+    constexpr bool AreEqual(std::span<const VertexAttribute> p_attributes, GLsizei p_stride, std::span<const VertexAttribute> p_otherAttributes, GLsizei p_otherStride)
+    {
+        if (p_stride != p_otherStride || p_attributes.size() != p_otherAttributes.size())
+        {
+            return false;
+        }
+
+        for (size_t attribute = 0; attribute < p_attributes.size(); attribute++)
+        {
+            const VertexAttribute& first = p_attributes[attribute];
+            const VertexAttribute& second = p_otherAttributes[attribute];
+
+            if (first.index != second.index || first.size != second.size || first.type != second.type || first.normalized != second.normalized || first.offset != second.offset)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //Enables and describes every attribute on p_vao, all of them sourced from the buffer at p_bindingIndex
+    static void ApplyAttributeFormats(GLuint p_vao, std::span<const VertexAttribute> p_attributes, GLuint p_bindingIndex = 0)
+    {
+        for (const VertexAttribute& attribute : p_attributes) {
+
+            glEnableVertexArrayAttrib(p_vao, attribute.index);
+            glVertexArrayAttribBinding(p_vao, attribute.index, p_bindingIndex);
+            glVertexArrayAttribFormat(p_vao, attribute.index, attribute.size, attribute.type, attribute.normalized, attribute.offset);
+
+        }
+    }
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+//std
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+//vendor
+#include <glad/glad/gl.h>
+
+//engine
+#include "Rendering/VertexLayout.h"
+
+
+//CPU side encoders of the packed attribute types GL reads natively.
+//Normalized integers are declared with normalized = GL_TRUE so the shader still receives floats,
+//snorm maps [-1, 1] and unorm maps [0, 1] onto the full integer range.
+namespace VertexPackingFunctions
+{
+    //IEEE 754 binary16, round to nearest even, overflow becomes infinity and NaN stays NaN
+    static uint16_t FloatToHalf(float p_value)
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &p_value, sizeof(bits));
+
+        uint32_t sign = (bits >> 16) & 0x8000;
+        uint32_t exponent = (bits >> 23) & 0xFF;
+        uint32_t mantissa = bits & 0x7FFFFF;
+
+        if (exponent == 0xFF)
+        {
+            return static_cast<uint16_t>(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+        }
+
+        int halfExponent = static_cast<int>(exponent) - 127 + 15;
+
+        if (halfExponent >= 0x1F)
+        {
+            return static_cast<uint16_t>(sign | 0x7C00);
+        }
+
+        if (halfExponent <= 0)
+        {
+            //Subnormal half or zero, the implicit leading bit becomes explicit before shifting
+            if (halfExponent < -10)
+            {
+                return static_cast<uint16_t>(sign);
+            }
+
+            mantissa |= 0x800000;
+            uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+            uint32_t halfMantissa = mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1);
+            uint32_t halfway = 1u << (shift - 1);
+
+            if (remainder > halfway || (remainder == halfway && (halfMantissa & 1) != 0))
+            {
+                halfMantissa++;
+            }
+
+            return static_cast<uint16_t>(sign | halfMantissa);
+        }
+
+        uint32_t half = sign | (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+        uint32_t remainder = mantissa & 0x1FFF;
+
+        //A carry out of the mantissa correctly bumps the exponent, up to infinity
+        if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1) != 0))
+        {
+            half++;
+        }
+
+        return static_cast<uint16_t>(half);
+    }
+
+    static float HalfToFloat(uint16_t p_half)
+    {
+        uint32_t sign = static_cast<uint32_t>(p_half & 0x8000) << 16;
+        uint32_t exponent = (p_half >> 10) & 0x1F;
+        uint32_t mantissa = p_half & 0x3FF;
+        uint32_t bits = 0;
+
+        if (exponent == 0x1F)
+        {
+            bits = sign | 0x7F800000 | (mantissa << 13);
+        }
+        else if (exponent != 0)
+        {
+            bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+        }
+        else if (mantissa != 0)
+        {
+            //Subnormal half, normalized as a float
+            int shiftedExponent = -1;
+
+            do
+            {
+                shiftedExponent++;
+                mantissa <<= 1;
+            } while ((mantissa & 0x400) == 0);
+
+            bits = sign | (static_cast<uint32_t>(127 - 15 - shiftedExponent) << 23) | ((mantissa & 0x3FF) << 13);
+        }
+        else
+        {
+            bits = sign;
+        }
+
+        float value = 0.0f;
+        std::memcpy(&value, &bits, sizeof(value));
+
+        return value;
+    }
+
+    static float Clamp(float p_value, float p_min, float p_max)
+    {
+        return p_value < p_min ? p_min : (p_value > p_max ? p_max : p_value);
+    }
+
+    static int16_t PackSnorm16(float p_value)
+    {
+        return static_cast<int16_t>(std::lround(Clamp(p_value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    static uint16_t PackUnorm16(float p_value)
+    {
+        return static_cast<uint16_t>(std::lround(Clamp(p_value, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    static int8_t PackSnorm8(float p_value)
+    {
+        return static_cast<int8_t>(std::lround(Clamp(p_value, -1.0f, 1.0f) * 127.0f));
+    }
+
+    static uint8_t PackUnorm8(float p_value)
+    {
+        return static_cast<uint8_t>(std::lround(Clamp(p_value, 0.0f, 1.0f) * 255.0f));
+    }
+
+    //GL_INT_2_10_10_10_REV, normalized : x in bits 0-9, y in 10-19, z in 20-29, w in 30-31, all signed
+    static uint32_t PackSnorm2101010Rev(float p_x, float p_y, float p_z, float p_w = 0.0f)
+    {
+        uint32_t x = static_cast<uint32_t>(std::lround(Clamp(p_x, -1.0f, 1.0f) * 511.0f)) & 0x3FF;
+        uint32_t y = static_cast<uint32_t>(std::lround(Clamp(p_y, -1.0f, 1.0f) * 511.0f)) & 0x3FF;
+        uint32_t z = static_cast<uint32_t>(std::lround(Clamp(p_z, -1.0f, 1.0f) * 511.0f)) & 0x3FF;
+        uint32_t w = static_cast<uint32_t>(std::lround(Clamp(p_w, -1.0f, 1.0f))) & 0x3;
+
+        return x | (y << 10) | (z << 20) | (w << 30);
+    }
+
+    //Inverse of PackSnorm2101010Rev for one component, p_component is 0 for x, 1 for y, 2 for z
+    static float UnpackSnorm2101010Rev(uint32_t p_packed, unsigned int p_component)
+    {
+        int32_t value = static_cast<int32_t>((p_packed >> (p_component * 10)) & 0x3FF);
+
+        if (value >= 512)
+        {
+            value -= 1024;
+        }
+
+        float unpacked = static_cast<float>(value) / 511.0f;
+
+        return unpacked < -1.0f ? -1.0f : unpacked;
+    }
+}
+
+//Full precision mesh vertex, 48 bytes
+struct MeshVertex
+{
+    float px, py, pz;
+    float nx, ny, nz;
+    float u, v;
+    float r, g, b, a;
+
+    static const std::array<VertexAttribute, 4> attributes;
+};
+
+constexpr std::array<VertexAttribute, 4> MeshVertex::attributes =
+{{
+    { 0, 3, GL_FLOAT, GL_FALSE, offsetof(MeshVertex, px) },
+    { 1, 3, GL_FLOAT, GL_FALSE, offsetof(MeshVertex, nx) },
+    { 2, 2, GL_FLOAT, GL_FALSE, offsetof(MeshVertex, u) },
+    { 3, 4, GL_FLOAT, GL_FALSE, offsetof(MeshVertex, r) },
+}};
+
+//Same attributes as MeshVertex packed into 20 bytes, the shader is unchanged.
+//Position : half floats, the fourth half pads to 8 bytes. Normal : snorm 2_10_10_10.
+//UV : unorm16, so UVs must lie in [0, 1]. Color : unorm8.
+struct PackedMeshVertex
+{
+    uint16_t position[4];
+    uint32_t normal;
+    uint16_t uv[2];
+    uint8_t color[4];
+
+    static const std::array<VertexAttribute, 4> attributes;
+};
+
+constexpr std::array<VertexAttribute, 4> PackedMeshVertex::attributes =
+{{
+    { 0, 3, GL_HALF_FLOAT, GL_FALSE, offsetof(PackedMeshVertex, position) },
+    { 1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, offsetof(PackedMeshVertex, normal) },
+    { 2, 2, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(PackedMeshVertex, uv) },
+    { 3, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(PackedMeshVertex, color) },
+}};
+
+namespace VertexPackingFunctions
+{
+    static PackedMeshVertex Pack(const MeshVertex& p_vertex)
+    {
+        PackedMeshVertex packed = {};
+        packed.position[0] = FloatToHalf(p_vertex.px);
+        packed.position[1] = FloatToHalf(p_vertex.py);
+        packed.position[2] = FloatToHalf(p_vertex.pz);
+        packed.position[3] = FloatToHalf(1.0f);
+        packed.normal = PackSnorm2101010Rev(p_vertex.nx, p_vertex.ny, p_vertex.nz);
+        packed.uv[0] = PackUnorm16(p_vertex.u);
+        packed.uv[1] = PackUnorm16(p_vertex.v);
+        packed.color[0] = PackUnorm8(p_vertex.r);
+        packed.color[1] = PackUnorm8(p_vertex.g);
+        packed.color[2] = PackUnorm8(p_vertex.b);
+        packed.color[3] = PackUnorm8(p_vertex.a);
+
+        return packed;
+    }
+
+    static void Pack(const MeshVertex* p_vertices, size_t p_vertexCount, PackedMeshVertex* p_outVertices)
+    {
+        for (size_t vertex = 0; vertex < p_vertexCount; vertex++)
+        {
+            p_outVertices[vertex] = Pack(p_vertices[vertex]);
+        }
+    }
+}
@@ -0,0 +1,463 @@
+#pragma once
+
+//std
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL_log.h>
+#include <entt.hpp>
+#include <glad/glad/gl.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+//engine
+#include "Core/Profiler.h"
+#include "Rendering/RenderComponent.h"
+#include "Rendering/SpriteBatch.h"
+
+
+//Relative to the parent entity. Call SceneFunctions::MarkTransformDirty after changing position, rotation or scale.
+struct TransformComponent
+{
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+
+    //Local to world, written by SceneFunctions::UpdateWorldMatrices and read by the extraction
+    glm::mat4 world = glm::mat4(1.0f);
+};
+
+//Tree links of an entity, changed only through SceneFunctions so the depth-first order can be rebuilt
+struct HierarchyComponent
+{
+    entt::entity parent = entt::null;
+    entt::entity firstChild = entt::null;
+    entt::entity nextSibling = entt::null;
+
+    //Position in the depth-first order of the last rebuild, the subtree of a node is [order, order + subtreeSize)
+    uint32_t order = 0;
+    uint32_t parentOrder = 0;
+    uint32_t subtreeSize = 1;
+
+    //Queued for the next UpdateWorldMatrices
+    bool isDirty = false;
+};
+
+//Drawn through a SpriteBatch at the world position of the entity, which is the bottom left corner of the quad
+struct SpriteComponent
+{
+    float width = 0.0f;
+    float height = 0.0f;
+    float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+    float layer = 0.0f;
+    float r = 1.0f, g = 1.0f, b = 1.0f, a = 1.0f;
+    GLuint texture = 0;
+    GLuint program = 0;
+};
+
+//One indexed draw of a RenderComponent with the world matrix of the entity, the component must outlive the entity
+struct MeshComponent
+{
+    const RenderComponent* renderComponent = nullptr;
+    GLuint program = 0;
+    GLuint texture = 0;
+    GLsizei indexCount = 0;
+    uint32_t firstIndex = 0;
+    GLint baseVertex = 0;
+    uint8_t layer = 0;
+};
+
+//Tag of the entities drawn this frame, set by culling or gameplay code through SceneFunctions::SetVisible
+struct VisibleComponent
+{
+};
+
+struct SceneMeshInstance
+{
+    glm::mat4 world;
+    MeshComponent mesh;
+};
+
+//Flat render data of the visible entities, filled by SceneFunctions::Extract and owned by the renderer.
+//The sprites are ready for SpriteBatchFunctions::Submit, the meshes for a RenderQueue with their world matrix in a UniformArena.
+struct SceneRenderData
+{
+    std::vector<Sprite> sprites;
+    std::vector<SceneMeshInstance> meshes;
+};
+
+struct SceneStats
+{
+    unsigned int entityCount = 0;
+    unsigned int spriteCount = 0;
+    unsigned int meshCount = 0;
+
+    //World matrices computed by the last UpdateWorldMatrices, which rebuilt the depth-first order when the tree changed
+    unsigned int updatedTransformCount = 0;
+    bool isHierarchyRebuilt = false;
+
+    //Entities copied by the last Extract
+    unsigned int extractedSpriteCount = 0;
+    unsigned int extractedMeshCount = 0;
+};
+
+//Entities and their components in an entt registry. Sprites and meshes each live in an owning group that also requires
+//VisibleComponent : entt keeps the components of the entities matching every type packed at the front of the owned storage,
+//so Extract walks exactly the visible entities in memory order whatever the number of hidden ones.
+//A type can be owned by one group only, TransformComponent is shared by both and read through them, which also leaves
+//its storage free to be ordered by the transform hierarchy. The groups are created in Create, before any component exists.
+//
+//Transforms form a tree. Whenever it changes the hierarchy and transform storages are reordered depth-first, so parents
+//precede their children and every subtree is a contiguous range of both. UpdateWorldMatrices then recomputes the subtrees
+//of the transforms marked dirty only, each range in two flat loops : local matrices, then parent world times local.
+struct Scene
+{
+    entt::registry registry;
+
+    bool isHierarchyChanged = false;
+    std::vector<entt::entity> dirtyEntities;
+
+    //Reused between updates
+    std::vector<entt::entity> orderedEntities;
+    std::vector<entt::entity> traversalStack;
+    std::vector<uint32_t> dirtyOrders;
+    std::vector<glm::mat4> localMatrices;
+
+    SceneStats lastStats;
+};
+
+namespace SceneFunctions
+{
+    using SpriteGroup = decltype(std::declval<entt::registry&>().group<SpriteComponent>(entt::get<TransformComponent, VisibleComponent>));
+    using MeshGroup = decltype(std::declval<entt::registry&>().group<MeshComponent>(entt::get<TransformComponent, VisibleComponent>));
+
+    static SpriteGroup GetSpriteGroup(Scene& p_scene)
+    {
+        return p_scene.registry.group<SpriteComponent>(entt::get<TransformComponent, VisibleComponent>);
+    }
+
+    static MeshGroup GetMeshGroup(Scene& p_scene)
+    {
+        return p_scene.registry.group<MeshComponent>(entt::get<TransformComponent, VisibleComponent>);
+    }
+
+    static void Create(Scene& p_scene)
+    {
+        GetSpriteGroup(p_scene);
+        GetMeshGroup(p_scene);
+    }
+
+    //Queues the world matrices of the entity and its descendants for the next UpdateWorldMatrices
+    static void MarkTransformDirty(Scene& p_scene, entt::entity p_entity)
+    {
+        HierarchyComponent& node = p_scene.registry.get<HierarchyComponent>(p_entity);
+
+        if (!node.isDirty)
+        {
+            node.isDirty = true;
+            p_scene.dirtyEntities.push_back(p_entity);
+        }
+    }
+
+    static void Unlink(Scene& p_scene, entt::entity p_entity, HierarchyComponent& p_node)
+    {
+        if (p_node.parent == entt::null)
+        {
+            return;
+        }
+
+        entt::entity* link = &p_scene.registry.get<HierarchyComponent>(p_node.parent).firstChild;
+
+        while (*link != p_entity)
+        {
+            link = &p_scene.registry.get<HierarchyComponent>(*link).nextSibling;
+        }
+
+        *link = p_node.nextSibling;
+        p_node.parent = entt::null;
+        p_node.nextSibling = entt::null;
+    }
+
+    //Keeps the local transform, the entity moves with its new parent. Returns false when p_parent is p_entity or one of its descendants.
+    static bool SetParent(Scene& p_scene, entt::entity p_entity, entt::entity p_parent)
+    {
+        for (entt::entity ancestor = p_parent; ancestor != entt::null; ancestor = p_scene.registry.get<HierarchyComponent>(ancestor).parent)
+        {
+            if (ancestor == p_entity)
+            {
+                SDL_Log("Cannot parent an entity to itself or to one of its descendants");
+                return false;
+            }
+        }
+
+        HierarchyComponent& node = p_scene.registry.get<HierarchyComponent>(p_entity);
+        Unlink(p_scene, p_entity, node);
+
+        if (p_parent != entt::null)
+        {
+            HierarchyComponent& parentNode = p_scene.registry.get<HierarchyComponent>(p_parent);
+            node.parent = p_parent;
+            node.nextSibling = parentNode.firstChild;
+            parentNode.firstChild = p_entity;
+        }
+
+        p_scene.isHierarchyChanged = true;
+        MarkTransformDirty(p_scene, p_entity);
+
+        return true;
+    }
+
+    //New entities have a TransformComponent and a HierarchyComponent and are visible
+    static entt::entity CreateEntity(Scene& p_scene, const TransformComponent& p_transform = TransformComponent{}, entt::entity p_parent = entt::null)
+    {
+        entt::entity entity = p_scene.registry.create();
+        p_scene.registry.emplace<TransformComponent>(entity, p_transform);
+        p_scene.registry.emplace<HierarchyComponent>(entity);
+        p_scene.registry.emplace<VisibleComponent>(entity);
+
+        SetParent(p_scene, entity, p_parent);
+
+        return entity;
+    }
+
+    //Destroys the descendants too
+    static void DestroyEntity(Scene& p_scene, entt::entity p_entity)
+    {
+        Unlink(p_scene, p_entity, p_scene.registry.get<HierarchyComponent>(p_entity));
+
+        std::vector<entt::entity>& stack = p_scene.traversalStack;
+        stack.assign(1, p_entity);
+
+        while (!stack.empty())
+        {
+            entt::entity entity = stack.back();
+            stack.pop_back();
+
+            for (entt::entity child = p_scene.registry.get<HierarchyComponent>(entity).firstChild; child != entt::null; child = p_scene.registry.get<HierarchyComponent>(child).nextSibling)
+            {
+                stack.push_back(child);
+            }
+
+            p_scene.registry.destroy(entity);
+        }
+
+        p_scene.isHierarchyChanged = true;
+    }
+
+    //Moves the entity in or out of the render groups, a swap in each owned storage
+    static void SetVisible(Scene& p_scene, entt::entity p_entity, bool p_isVisible)
+    {
+        if (p_isVisible)
+        {
+            p_scene.registry.emplace_or_replace<VisibleComponent>(p_entity);
+        }
+        else
+        {
+            p_scene.registry.remove<VisibleComponent>(p_entity);
+        }
+    }
+
+    static glm::mat4 ComputeLocalMatrix(const TransformComponent& p_transform)
+    {
+        glm::mat4 matrix = glm::mat4_cast(p_transform.rotation);
+        matrix[0] *= p_transform.scale.x;
+        matrix[1] *= p_transform.scale.y;
+        matrix[2] *= p_transform.scale.z;
+        matrix[3] = glm::vec4(p_transform.position, 1.0f);
+
+        return matrix;
+    }
+
+    //Orders both storages depth-first with sort_as, what registry::sort<To, From> applies, from a walk of the tree
+    //instead of a comparison sort. Entities iterate in that order, so order is also the index of an iterator.
+    static void RebuildHierarchy(Scene& p_scene)
+    {
+        PACO_PROFILE_SCOPE("Scene::RebuildHierarchy");
+
+        auto& hierarchyStorage = p_scene.registry.storage<HierarchyComponent>();
+        std::vector<entt::entity>& orderedEntities = p_scene.orderedEntities;
+        std::vector<entt::entity>& stack = p_scene.traversalStack;
+
+        orderedEntities.clear();
+
+        for (auto [root, rootNode] : hierarchyStorage.each())
+        {
+            if (rootNode.parent != entt::null)
+            {
+                continue;
+            }
+
+            stack.assign(1, root);
+
+            while (!stack.empty())
+            {
+                entt::entity entity = stack.back();
+                stack.pop_back();
+
+                HierarchyComponent& node = hierarchyStorage.get(entity);
+                node.order = static_cast<uint32_t>(orderedEntities.size());
+                node.parentOrder = node.parent != entt::null ? hierarchyStorage.get(node.parent).order : node.order;
+                node.subtreeSize = 1;
+                orderedEntities.push_back(entity);
+
+                for (entt::entity child = node.firstChild; child != entt::null; child = hierarchyStorage.get(child).nextSibling)
+                {
+                    stack.push_back(child);
+                }
+            }
+        }
+
+        hierarchyStorage.sort_as(orderedEntities.begin(), orderedEntities.end());
+        p_scene.registry.storage<TransformComponent>().sort_as(orderedEntities.begin(), orderedEntities.end());
+
+        //Children follow their parent, sizes accumulate from the last node back
+        auto nodes = hierarchyStorage.begin();
+
+        for (uint32_t order = static_cast<uint32_t>(orderedEntities.size()); order-- > 0;)
+        {
+            if (nodes[order].parentOrder != order)
+            {
+                nodes[nodes[order].parentOrder].subtreeSize += nodes[order].subtreeSize;
+            }
+        }
+
+        p_scene.isHierarchyChanged = false;
+    }
+
+    //World matrices of the nodes [p_first, p_end) in depth-first order, parents outside the range must be up to date
+    static void UpdateRange(Scene& p_scene, uint32_t p_first, uint32_t p_end)
+    {
+        auto transforms = p_scene.registry.storage<TransformComponent>().begin();
+        auto nodes = p_scene.registry.storage<HierarchyComponent>().begin();
+
+        std::vector<glm::mat4>& localMatrices = p_scene.localMatrices;
+        localMatrices.resize(p_end - p_first);
+
+        for (uint32_t order = p_first; order < p_end; order++)
+        {
+            localMatrices[order - p_first] = ComputeLocalMatrix(transforms[order]);
+        }
+
+        for (uint32_t order = p_first; order < p_end; order++)
+        {
+            const uint32_t parentOrder = nodes[order].parentOrder;
+            transforms[order].world = parentOrder != order ? transforms[parentOrder].world * localMatrices[order - p_first] : localMatrices[order - p_first];
+        }
+    }
+
+    //Reorders the storages when the tree changed, then recomputes the subtrees of the dirty transforms only
+    static void UpdateWorldMatrices(Scene& p_scene)
+    {
+        PACO_PROFILE_SCOPE("Scene::UpdateWorldMatrices");
+
+        p_scene.lastStats.isHierarchyRebuilt = p_scene.isHierarchyChanged;
+        p_scene.lastStats.updatedTransformCount = 0;
+
+        if (p_scene.isHierarchyChanged)
+        {
+            RebuildHierarchy(p_scene);
+        }
+
+        std::vector<uint32_t>& dirtyOrders = p_scene.dirtyOrders;
+        dirtyOrders.clear();
+
+        for (entt::entity entity : p_scene.dirtyEntities)
+        {
+            if (p_scene.registry.valid(entity))
+            {
+                HierarchyComponent& node = p_scene.registry.get<HierarchyComponent>(entity);
+                node.isDirty = false;
+                dirtyOrders.push_back(node.order);
+            }
+        }
+
+        p_scene.dirtyEntities.clear();
+        std::sort(dirtyOrders.begin(), dirtyOrders.end());
+
+        //A dirty node inside a subtree already updated is skipped
+        auto nodes = p_scene.registry.storage<HierarchyComponent>().begin();
+        uint32_t updatedEnd = 0;
+
+        for (uint32_t order : dirtyOrders)
+        {
+            if (order < updatedEnd)
+            {
+                continue;
+            }
+
+            updatedEnd = order + nodes[order].subtreeSize;
+            UpdateRange(p_scene, order, updatedEnd);
+            p_scene.lastStats.updatedTransformCount += updatedEnd - order;
+        }
+    }
+
+    //Replaces the content of p_outData with the visible sprites and meshes, the vectors keep their capacity between frames
+    static void Extract(Scene& p_scene, SceneRenderData& p_outData)
+    {
+        PACO_PROFILE_SCOPE("Scene::Extract");
+
+        SpriteGroup spriteGroup = GetSpriteGroup(p_scene);
+        MeshGroup meshGroup = GetMeshGroup(p_scene);
+
+        p_outData.sprites.resize(spriteGroup.size());
+        p_outData.meshes.resize(meshGroup.size());
+
+        Sprite* sprite = p_outData.sprites.data();
+
+        for (auto [entity, spriteComponent, transform] : spriteGroup.each())
+        {
+            sprite->x = transform.world[3].x;
+            sprite->y = transform.world[3].y;
+            sprite->width = spriteComponent.width;
+            sprite->height = spriteComponent.height;
+            sprite->u0 = spriteComponent.u0;
+            sprite->v0 = spriteComponent.v0;
+            sprite->u1 = spriteComponent.u1;
+            sprite->v1 = spriteComponent.v1;
+            sprite->layer = spriteComponent.layer;
+            sprite->r = spriteComponent.r;
+            sprite->g = spriteComponent.g;
+            sprite->b = spriteComponent.b;
+            sprite->a = spriteComponent.a;
+            sprite->texture = spriteComponent.texture;
+            sprite->program = spriteComponent.program;
+            sprite++;
+        }
+
+        SceneMeshInstance* instance = p_outData.meshes.data();
+
+        for (auto [entity, meshComponent, transform] : meshGroup.each())
+        {
+            instance->world = transform.world;
+            instance->mesh = meshComponent;
+            instance++;
+        }
+
+        p_scene.lastStats.entityCount = static_cast<unsigned int>(p_scene.registry.storage<entt::entity>().free_list());
+        p_scene.lastStats.spriteCount = static_cast<unsigned int>(p_scene.registry.storage<SpriteComponent>().size());
+        p_scene.lastStats.meshCount = static_cast<unsigned int>(p_scene.registry.storage<MeshComponent>().size());
+        p_scene.lastStats.extractedSpriteCount = static_cast<unsigned int>(p_outData.sprites.size());
+        p_scene.lastStats.extractedMeshCount = static_cast<unsigned int>(p_outData.meshes.size());
+    }
+
+    //Counters of the last Extract
+    static const SceneStats& GetStats(const Scene& p_scene)
+    {
+        return p_scene.lastStats;
+    }
+
+    static void Destroy(Scene& p_scene)
+    {
+        p_scene.registry.clear();
+        p_scene.isHierarchyChanged = false;
+        p_scene.dirtyEntities.clear();
+        p_scene.orderedEntities.clear();
+        p_scene.traversalStack.clear();
+        p_scene.dirtyOrders.clear();
+        p_scene.localMatrices.clear();
+        p_scene.lastStats = SceneStats{};
+    }
+}
@@ -0,0 +1,647 @@
+#pragma once
+
+//std
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL.h>
+#include <glad/glad/gl.h>
+#include <stb_rect_pack.h>
+#include <stb_truetype.h>
+
+//The vendored msdfgen comes without the msdfgen-config.h its CMake build generates, which only defines this for a static build
+#ifndef MSDFGEN_PUBLIC
+#define MSDFGEN_PUBLIC
+#endif
+#include <core/ShapeDistanceFinder.h>
+#include <core/edge-coloring.h>
+#include <core/msdf-error-correction.h>
+
+//engine
+#include "Core/Hash.h"
+#include "Core/MappedFile.h"
+#include "Core/Profiler.h"
+
+
+//Every field is part of the cache key, changing one bakes the font again
+struct FontAtlasSettings
+{
+    //Texels per em in the atlas
+    float glyphSize = 32.0f;
+
+    //Width in texels of the distance range around the outlines, text scales up to about glyphSize * distanceRange / 2 pixels per em cleanly
+    float distanceRange = 4.0f;
+
+    uint32_t firstCodepoint = 32;
+    uint32_t lastCodepoint = 126;
+
+    //Multiple of 4 so RGB rows stay 4 byte aligned, the height is what the glyphs need
+    int32_t atlasWidth = 1024;
+};
+
+struct FontGlyph
+{
+    uint32_t codepoint = 0;
+
+    //Pen advance, in ems
+    float advance = 0.0f;
+
+    //Quad around the pen position on the baseline, in ems with y up. Empty for glyphs without outline such as the space.
+    float planeLeft = 0.0f;
+    float planeBottom = 0.0f;
+    float planeRight = 0.0f;
+    float planeTop = 0.0f;
+
+    //Texels of the quad in the atlas, row 0 is the bottom row as with GL texture coordinates
+    int32_t atlasX = 0;
+    int32_t atlasY = 0;
+    int32_t atlasWidth = 0;
+    int32_t atlasHeight = 0;
+};
+
+struct FontKerning
+{
+    uint32_t firstCodepoint = 0;
+    uint32_t secondCodepoint = 0;
+
+    //Added to the advance of the first glyph, in ems
+    float advance = 0.0f;
+};
+
+//File layout of a cached atlas :
+//    FontAtlasCacheHeader
+//    FontGlyph[glyphCount] sorted by codepoint
+//    FontKerning[kerningCount] sorted by codepoint pair
+//    RGB8 texels, width * height * 3 bytes, bottom row first
+struct FontAtlasCacheHeader
+{
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t key = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    uint32_t glyphCount = 0;
+    uint32_t kerningCount = 0;
+    float ascender = 0.0f;
+    float descender = 0.0f;
+    float lineHeight = 0.0f;
+    uint32_t pixelSize = 0;
+};
+
+static_assert(sizeof(FontGlyph) == 40 && sizeof(FontKerning) == 12 && sizeof(FontAtlasCacheHeader) == 48, "Cached font atlas layout must not depend on the compiler");
+
+//Multi-channel signed distance field of one glyph, RGB8 with row 0 at the bottom
+struct FontBakedGlyph
+{
+    FontGlyph glyph;
+    std::vector<uint8_t> pixels;
+};
+
+//MSDF atlas of a range of codepoints, drawn with the median of the three channels so corners stay sharp at any scale.
+//Glyphs are generated on every core and packed with stb_rect_pack, then the atlas and its metrics are written to a cache
+//file named after the hash of the font file and the settings, so later runs map that file and upload it as is.
+//stb_truetype.h and stb_rect_pack.h are compiled by the application, as are the msdfgen core sources.
+struct FontAtlas
+{
+    GLuint texture = 0;
+    GLsizei width = 0;
+    GLsizei height = 0;
+    FontAtlasSettings settings;
+
+    //In ems, the descender is negative
+    float ascender = 0.0f;
+    float descender = 0.0f;
+    float lineHeight = 0.0f;
+
+    std::vector<FontGlyph> glyphs;
+    std::vector<FontKerning> kernings;
+
+    //Bumped whenever glyphs change after loading, layouts cached from an older revision are stale
+    uint64_t revision = 0;
+
+    bool isLoadedFromCache = false;
+    Uint64 loadNs = 0;
+};
+
+namespace FontAtlasFunctions
+{
+    constexpr uint32_t cacheMagic = 0x544E4650; //"PFNT"
+    constexpr uint32_t cacheVersion = 1;
+
+    //Corners sharper than this angle, in radians, get edges of different colors
+    constexpr double cornerAngleThreshold = 3.0;
+
+    static uint64_t ComputeKey(const uint8_t* p_fontData, size_t p_fontSize, const FontAtlasSettings& p_settings)
+    {
+        uint64_t hash = HashFunctions::HashValue(HashFunctions::fnvOffsetBasis, cacheVersion);
+        hash = HashFunctions::HashBytes(hash, p_fontData, p_fontSize);
+
+        uint32_t glyphSizeBits = 0;
+        uint32_t distanceRangeBits = 0;
+        std::memcpy(&glyphSizeBits, &p_settings.glyphSize, sizeof(glyphSizeBits));
+        std::memcpy(&distanceRangeBits, &p_settings.distanceRange, sizeof(distanceRangeBits));
+
+        hash = HashFunctions::HashValue(hash, glyphSizeBits);
+        hash = HashFunctions::HashValue(hash, distanceRangeBits);
+        hash = HashFunctions::HashValue(hash, p_settings.firstCodepoint);
+        hash = HashFunctions::HashValue(hash, p_settings.lastCodepoint);
+        hash = HashFunctions::HashValue(hash, static_cast<uint32_t>(p_settings.atlasWidth));
+
+        return hash;
+    }
+
+    static std::string GetCachePath(const char* p_cacheDirectory, uint64_t p_key)
+    {
+        std::string path = p_cacheDirectory;
+
+        if (!path.empty() && path.back() != '/' && path.back() != '\\')
+        {
+            path += '/';
+        }
+
+        char fileName[32];
+        std::snprintf(fileName, sizeof(fileName), "%016llx.font", static_cast<unsigned long long>(p_key));
+
+        return path + fileName;
+    }
+
+    //Returns false for glyphs without outline
+    static bool LoadShape(const stbtt_fontinfo& p_font, int p_glyphIndex, msdfgen::Shape& p_outShape)
+    {
+        stbtt_vertex* vertices = nullptr;
+        int vertexCount = stbtt_GetGlyphShape(&p_font, p_glyphIndex, &vertices);
+
+        msdfgen::Contour* contour = nullptr;
+        msdfgen::Point2 position;
+
+        for (int vertex = 0; vertex < vertexCount; vertex++)
+        {
+            const stbtt_vertex& current = vertices[vertex];
+            msdfgen::Point2 point(current.x, current.y);
+
+            if (current.type == STBTT_vmove)
+            {
+                contour = &p_outShape.addContour();
+            }
+            else if (contour != nullptr && current.type == STBTT_vline && point != position)
+            {
+                contour->addEdge(msdfgen::EdgeHolder(position, point));
+            }
+            else if (contour != nullptr && current.type == STBTT_vcurve)
+            {
+                contour->addEdge(msdfgen::EdgeHolder(position, msdfgen::Point2(current.cx, current.cy), point));
+            }
+            else if (contour != nullptr && current.type == STBTT_vcubic)
+            {
+                contour->addEdge(msdfgen::EdgeHolder(position, msdfgen::Point2(current.cx, current.cy), msdfgen::Point2(current.cx1, current.cy1), point));
+            }
+
+            position = point;
+        }
+
+        stbtt_FreeShape(&p_font, vertices);
+
+        //Splits the contours of a single edge so they can get three colors
+        p_outShape.normalize();
+
+        return p_outShape.edgeCount() > 0;
+    }
+
+    //Thread safe, glyphs of one font can be baked from several threads at once
+    static void BakeGlyph(const stbtt_fontinfo& p_font, uint32_t p_codepoint, const FontAtlasSettings& p_settings, FontBakedGlyph& p_outGlyph)
+    {
+        PACO_PROFILE_SCOPE("FontAtlas::BakeGlyph");
+
+        int glyphIndex = stbtt_FindGlyphIndex(&p_font, static_cast<int>(p_codepoint));
+        double emScale = stbtt_ScaleForMappingEmToPixels(&p_font, 1.0f);
+
+        int advanceWidth = 0;
+        stbtt_GetGlyphHMetrics(&p_font, glyphIndex, &advanceWidth, nullptr);
+
+        p_outGlyph.glyph = FontGlyph{};
+        p_outGlyph.glyph.codepoint = p_codepoint;
+        p_outGlyph.glyph.advance = static_cast<float>(advanceWidth * emScale);
+        p_outGlyph.pixels.clear();
+
+        msdfgen::Shape shape;
+
+        if (!LoadShape(p_font, glyphIndex, shape))
+        {
+            return;
+        }
+
+        msdfgen::edgeColoringSimple(shape, cornerAngleThreshold);
+
+        //Texel box around the outline and half the distance range, in atlas texels from the pen position
+        double texelScale = emScale * p_settings.glyphSize;
+        double border = 0.5 * p_settings.distanceRange;
+        msdfgen::Shape::Bounds bounds = shape.getBounds();
+
+        int left = static_cast<int>(std::floor(bounds.l * texelScale - border));
+        int bottom = static_cast<int>(std::floor(bounds.b * texelScale - border));
+        int right = static_cast<int>(std::ceil(bounds.r * texelScale + border));
+        int top = static_cast<int>(std::ceil(bounds.t * texelScale + border));
+        int width = right - left;
+        int height = top - bottom;
+
+        //Font units to texels of the glyph bitmap, and the distance range in font units
+        msdfgen::Projection projection(msdfgen::Vector2(texelScale), msdfgen::Vector2(-left / texelScale, -bottom / texelScale));
+        msdfgen::SDFTransformation transformation(projection, msdfgen::DistanceMapping(msdfgen::Range(p_settings.distanceRange / texelScale)));
+
+        std::vector<float> distances(static_cast<size_t>(width) * height * 3);
+        msdfgen::BitmapRef<float, 3> bitmap(distances.data(), width, height);
+
+        //Overlapping contours are common in fonts, variable fonts in particular
+        msdfgen::ShapeDistanceFinder<msdfgen::OverlappingContourCombiner<msdfgen::MultiDistanceSelector>> distanceFinder(shape);
+
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                msdfgen::MultiDistance distance = distanceFinder.distance(transformation.unproject(msdfgen::Point2(x + 0.5, y + 0.5)));
+                float* texel = bitmap(x, y);
+                texel[0] = static_cast<float>(transformation.distanceMapping(distance.r));
+                texel[1] = static_cast<float>(transformation.distanceMapping(distance.g));
+                texel[2] = static_cast<float>(transformation.distanceMapping(distance.b));
+            }
+        }
+
+        msdfgen::msdfErrorCorrection(bitmap, shape, transformation, msdfgen::MSDFGeneratorConfig(true));
+
+        p_outGlyph.pixels.resize(distances.size());
+
+        for (size_t channel = 0; channel < distances.size(); channel++)
+        {
+            p_outGlyph.pixels[channel] = static_cast<uint8_t>(std::clamp(distances[channel] * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+
+        p_outGlyph.glyph.planeLeft = static_cast<float>(left) / p_settings.glyphSize;
+        p_outGlyph.glyph.planeBottom = static_cast<float>(bottom) / p_settings.glyphSize;
+        p_outGlyph.glyph.planeRight = static_cast<float>(right) / p_settings.glyphSize;
+        p_outGlyph.glyph.planeTop = static_cast<float>(top) / p_settings.glyphSize;
+        p_outGlyph.glyph.atlasWidth = width;
+        p_outGlyph.glyph.atlasHeight = height;
+    }
+
+    //Packs the baked glyphs one texel apart, so bilinear filtering at the quad edges reads no other glyph
+    static bool Pack(std::vector<FontBakedGlyph>& p_bakedGlyphs, int32_t p_atlasWidth, int32_t& p_outHeight)
+    {
+        PACO_PROFILE_SCOPE("FontAtlas::Pack");
+
+        const int maxHeight = 16384;
+
+        std::vector<stbrp_rect> rects;
+
+        for (size_t glyph = 0; glyph < p_bakedGlyphs.size(); glyph++)
+        {
+            if (!p_bakedGlyphs[glyph].pixels.empty())
+            {
+                stbrp_rect rect = {};
+                rect.id = static_cast<int>(glyph);
+                rect.w = p_bakedGlyphs[glyph].glyph.atlasWidth + 1;
+                rect.h = p_bakedGlyphs[glyph].glyph.atlasHeight + 1;
+                rects.push_back(rect);
+            }
+        }
+
+        std::vector<stbrp_node> nodes(static_cast<size_t>(p_atlasWidth));
+        stbrp_context context = {};
+        stbrp_init_target(&context, p_atlasWidth, maxHeight, nodes.data(), p_atlasWidth);
+
+        if (stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size())) != 1)
+        {
+            return false;
+        }
+
+        p_outHeight = 1;
+
+        for (const stbrp_rect& rect : rects)
+        {
+            FontGlyph& glyph = p_bakedGlyphs[rect.id].glyph;
+            glyph.atlasX = rect.x;
+            glyph.atlasY = rect.y;
+            p_outHeight = std::max(p_outHeight, rect.y + rect.h);
+        }
+
+        return true;
+    }
+
+    //Bakes every codepoint of p_settings found in the font on p_threadCount threads, p_outPixels receives the RGB8 atlas
+    static bool Bake(FontAtlas& p_atlas, const uint8_t* p_fontData, const FontAtlasSettings& p_settings, unsigned int p_threadCount, std::vector<uint8_t>& p_outPixels)
+    {
+        PACO_PROFILE_SCOPE("FontAtlas::Bake");
+
+        stbtt_fontinfo font = {};
+
+        if (!stbtt_InitFont(&font, p_fontData, stbtt_GetFontOffsetForIndex(p_fontData, 0)))
+        {
+            SDL_Log("Failed to parse font");
+            return false;
+        }
+
+        std::vector<uint32_t> codepoints;
+
+        for (uint32_t codepoint = p_settings.firstCodepoint; codepoint <= p_settings.lastCodepoint; codepoint++)
+        {
+            if (stbtt_FindGlyphIndex(&font, static_cast<int>(codepoint)) != 0)
+            {
+                codepoints.push_back(codepoint);
+            }
+        }
+
+        std::vector<FontBakedGlyph> bakedGlyphs(codepoints.size());
+        std::atomic<size_t> nextGlyph = 0;
+
+        auto bakeGlyphs = [&]()
+        {
+            for (size_t glyph = nextGlyph++; glyph < codepoints.size(); glyph = nextGlyph++)
+            {
+                BakeGlyph(font, codepoints[glyph], p_settings, bakedGlyphs[glyph]);
+            }
+        };
+
+        //The calling thread bakes too but keeps its own name in the trace
+        auto runBaker = [&bakeGlyphs]()
+        {
+            PACO_PROFILE_THREAD_NAME("Font Baker");
+            bakeGlyphs();
+        };
+
+        std::vector<std::thread> threads;
+
+        for (unsigned int thread = 1; thread < std::max(p_threadCount, 1u); thread++)
+        {
+            threads.emplace_back(runBaker);
+        }
+
+        bakeGlyphs();
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        int32_t height = 0;
+
+        if (!Pack(bakedGlyphs, p_settings.atlasWidth, height))
+        {
+            SDL_Log("Font glyphs do not fit in an atlas %d texels wide", p_settings.atlasWidth);
+            return false;
+        }
+
+        p_outPixels.assign(static_cast<size_t>(p_settings.atlasWidth) * height * 3, 0);
+        p_atlas.glyphs.clear();
+
+        for (const FontBakedGlyph& bakedGlyph : bakedGlyphs)
+        {
+            const FontGlyph& glyph = bakedGlyph.glyph;
+
+            for (int32_t row = 0; row < glyph.atlasHeight && !bakedGlyph.pixels.empty(); row++)
+            {
+                std::memcpy(&p_outPixels[(static_cast<size_t>(glyph.atlasY + row) * p_settings.atlasWidth + glyph.atlasX) * 3],
+                    &bakedGlyph.pixels[static_cast<size_t>(row) * glyph.atlasWidth * 3], static_cast<size_t>(glyph.atlasWidth) * 3);
+            }
+
+            p_atlas.glyphs.push_back(glyph);
+        }
+
+        float emScale = stbtt_ScaleForMappingEmToPixels(&font, 1.0f);
+        int ascender = 0;
+        int descender = 0;
+        int lineGap = 0;
+        stbtt_GetFontVMetrics(&font, &ascender, &descender, &lineGap);
+
+        p_atlas.width = p_settings.atlasWidth;
+        p_atlas.height = height;
+        p_atlas.ascender = ascender * emScale;
+        p_atlas.descender = descender * emScale;
+        p_atlas.lineHeight = (ascender - descender + lineGap) * emScale;
+
+        //Only the pairs of the 'kern' table, fonts with GPOS kerning alone get none
+        std::vector<stbtt_kerningentry> kerningTable(static_cast<size_t>(stbtt_GetKerningTableLength(&font)));
+        kerningTable.resize(static_cast<size_t>(stbtt_GetKerningTable(&font, kerningTable.data(), static_cast<int>(kerningTable.size()))));
+
+        //Glyph index of every baked codepoint, several codepoints may share a glyph
+        std::vector<std::pair<int, uint32_t>> codepointsByGlyph;
+
+        for (uint32_t codepoint : codepoints)
+        {
+            codepointsByGlyph.emplace_back(stbtt_FindGlyphIndex(&font, static_cast<int>(codepoint)), codepoint);
+        }
+
+        std::sort(codepointsByGlyph.begin(), codepointsByGlyph.end());
+
+        auto findCodepoints = [&codepointsByGlyph](int p_glyphIndex)
+        {
+            return std::equal_range(codepointsByGlyph.begin(), codepointsByGlyph.end(), std::make_pair(p_glyphIndex, 0u),
+                [](const std::pair<int, uint32_t>& p_left, const std::pair<int, uint32_t>& p_right) { return p_left.first < p_right.first; });
+        };
+
+        p_atlas.kernings.clear();
+
+        for (const stbtt_kerningentry& entry : kerningTable)
+        {
+            auto firsts = findCodepoints(entry.glyph1);
+            auto seconds = findCodepoints(entry.glyph2);
+
+            for (auto first = firsts.first; first != firsts.second && entry.advance != 0; first++)
+            {
+                for (auto second = seconds.first; second != seconds.second; second++)
+                {
+                    p_atlas.kernings.push_back({ first->second, second->second, entry.advance * emScale });
+                }
+            }
+        }
+
+        std::sort(p_atlas.kernings.begin(), p_atlas.kernings.end(), [](const FontKerning& p_left, const FontKerning& p_right)
+            { return std::make_pair(p_left.firstCodepoint, p_left.secondCodepoint) < std::make_pair(p_right.firstCodepoint, p_right.secondCodepoint); });
+
+        return true;
+    }
+
+    static void CreateTexture(FontAtlas& p_atlas, const uint8_t* p_pixels)
+    {
+        glCreateTextures(GL_TEXTURE_2D, 1, &p_atlas.texture);
+        glTextureStorage2D(p_atlas.texture, 1, GL_RGB8, p_atlas.width, p_atlas.height);
+        glTextureSubImage2D(p_atlas.texture, 0, 0, 0, p_atlas.width, p_atlas.height, GL_RGB, GL_UNSIGNED_BYTE, p_pixels);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(p_atlas.texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    //Returns false when there is no valid cache file for p_key, the texels are uploaded straight from the mapped file
+    static bool LoadCache(FontAtlas& p_atlas, const std::string& p_path, uint64_t p_key)
+    {
+        PACO_PROFILE_SCOPE("FontAtlas::LoadCache");
+
+        MappedFile mappedFile;
+
+        if (!MappedFileFunctions::Open(mappedFile, p_path.c_str()))
+        {
+            return false;
+        }
+
+        FontAtlasCacheHeader header = {};
+        bool isValid = mappedFile.size >= sizeof(header);
+
+        if (isValid)
+        {
+            std::memcpy(&header, mappedFile.data, sizeof(header));
+
+            uint64_t expectedSize = sizeof(header) + static_cast<uint64_t>(header.glyphCount) * sizeof(FontGlyph)
+                + static_cast<uint64_t>(header.kerningCount) * sizeof(FontKerning) + header.pixelSize;
+
+            isValid = header.magic == cacheMagic && header.version == cacheVersion && header.key == p_key && header.width > 0 && header.height > 0
+                && header.pixelSize == static_cast<uint64_t>(header.width) * header.height * 3 && mappedFile.size == expectedSize;
+        }
+
+        if (isValid)
+        {
+            const uint8_t* glyphs = mappedFile.data + sizeof(header);
+            const uint8_t* kernings = glyphs + header.glyphCount * sizeof(FontGlyph);
+            const uint8_t* pixels = kernings + header.kerningCount * sizeof(FontKerning);
+
+            p_atlas.glyphs.resize(header.glyphCount);
+            p_atlas.kernings.resize(header.kerningCount);
+            std::memcpy(p_atlas.glyphs.data(), glyphs, header.glyphCount * sizeof(FontGlyph));
+            std::memcpy(p_atlas.kernings.data(), kernings, header.kerningCount * sizeof(FontKerning));
+
+            p_atlas.width = header.width;
+            p_atlas.height = header.height;
+            p_atlas.ascender = header.ascender;
+            p_atlas.descender = header.descender;
+            p_atlas.lineHeight = header.lineHeight;
+
+            CreateTexture(p_atlas, pixels);
+        }
+
+        MappedFileFunctions::Close(mappedFile);
+
+        return isValid;
+    }
+
+    static bool SaveCache(const FontAtlas& p_atlas, const std::string& p_path, uint64_t p_key, const std::vector<uint8_t>& p_pixels)
+    {
+        FontAtlasCacheHeader header;
+        header.magic = cacheMagic;
+        header.version = cacheVersion;
+        header.key = p_key;
+        header.width = p_atlas.width;
+        header.height = p_atlas.height;
+        header.glyphCount = static_cast<uint32_t>(p_atlas.glyphs.size());
+        header.kerningCount = static_cast<uint32_t>(p_atlas.kernings.size());
+        header.ascender = p_atlas.ascender;
+        header.descender = p_atlas.descender;
+        header.lineHeight = p_atlas.lineHeight;
+        header.pixelSize = static_cast<uint32_t>(p_pixels.size());
+
+        std::vector<uint8_t> file(sizeof(header) + p_atlas.glyphs.size() * sizeof(FontGlyph) + p_atlas.kernings.size() * sizeof(FontKerning) + p_pixels.size());
+        uint8_t* cursor = file.data();
+
+        std::memcpy(cursor, &header, sizeof(header));
+        cursor += sizeof(header);
+        std::memcpy(cursor, p_atlas.glyphs.data(), p_atlas.glyphs.size() * sizeof(FontGlyph));
+        cursor += p_atlas.glyphs.size() * sizeof(FontGlyph);
+        std::memcpy(cursor, p_atlas.kernings.data(), p_atlas.kernings.size() * sizeof(FontKerning));
+        cursor += p_atlas.kernings.size() * sizeof(FontKerning);
+        std::memcpy(cursor, p_pixels.data(), p_pixels.size());
+
+        if (!SDL_SaveFile(p_path.c_str(), file.data(), file.size()))
+        {
+            SDL_Log("Failed to save font atlas %s : %s", p_path.c_str(), SDL_GetError());
+            return false;
+        }
+
+        return true;
+    }
+
+    //Loads the atlas from p_cacheDirectory, or bakes it on p_threadCount threads and saves it there.
+    //p_cacheDirectory may be nullptr to always bake, a thread count of 0 uses every core. Needs a current GL context.
+    static bool Load(FontAtlas& p_atlas, const char* p_fontPath, const FontAtlasSettings& p_settings, const char* p_cacheDirectory, unsigned int p_threadCount = 0)
+    {
+        PACO_PROFILE_SCOPE("FontAtlas::Load");
+
+        Uint64 startNs = SDL_GetTicksNS();
+
+        if (p_settings.atlasWidth <= 0 || p_settings.atlasWidth % 4 != 0 || p_settings.firstCodepoint > p_settings.lastCodepoint)
+        {
+            SDL_Log("Invalid font atlas settings, the atlas width must be a multiple of 4 and the codepoint range not empty");
+            return false;
+        }
+
+        MappedFile fontFile;
+
+        if (!MappedFileFunctions::Open(fontFile, p_fontPath))
+        {
+            SDL_Log("Failed to open font %s", p_fontPath);
+            return false;
+        }
+
+        p_atlas.settings = p_settings;
+
+        uint64_t key = ComputeKey(fontFile.data, fontFile.size, p_settings);
+        std::string cachePath = p_cacheDirectory != nullptr ? GetCachePath(p_cacheDirectory, key) : std::string();
+
+        p_atlas.isLoadedFromCache = p_cacheDirectory != nullptr && LoadCache(p_atlas, cachePath, key);
+
+        if (!p_atlas.isLoadedFromCache)
+        {
+            std::vector<uint8_t> pixels;
+            unsigned int threadCount = p_threadCount > 0 ? p_threadCount : std::thread::hardware_concurrency();
+
+            if (!Bake(p_atlas, fontFile.data, p_settings, threadCount, pixels))
+            {
+                SDL_Log("Failed to bake font %s", p_fontPath);
+                MappedFileFunctions::Close(fontFile);
+                return false;
+            }
+
+            CreateTexture(p_atlas, pixels.data());
+
+            if (p_cacheDirectory != nullptr && SDL_CreateDirectory(p_cacheDirectory))
+            {
+                SaveCache(p_atlas, cachePath, key, pixels);
+            }
+        }
+
+        MappedFileFunctions::Close(fontFile);
+
+        p_atlas.loadNs = SDL_GetTicksNS() - startNs;
+
+        return true;
+    }
+
+    //Returns nullptr when the codepoint was not baked
+    static const FontGlyph* FindGlyph(const FontAtlas& p_atlas, uint32_t p_codepoint)
+    {
+        auto glyph = std::lower_bound(p_atlas.glyphs.begin(), p_atlas.glyphs.end(), p_codepoint,
+            [](const FontGlyph& p_glyph, uint32_t p_value) { return p_glyph.codepoint < p_value; });
+
+        return glyph != p_atlas.glyphs.end() && glyph->codepoint == p_codepoint ? &*glyph : nullptr;
+    }
+
+    //In ems, 0 for pairs without kerning
+    static float GetKerning(const FontAtlas& p_atlas, uint32_t p_first, uint32_t p_second)
+    {
+        auto kerning = std::lower_bound(p_atlas.kernings.begin(), p_atlas.kernings.end(), std::make_pair(p_first, p_second),
+            [](const FontKerning& p_kerning, const std::pair<uint32_t, uint32_t>& p_pair) { return std::make_pair(p_kerning.firstCodepoint, p_kerning.secondCodepoint) < p_pair; });
+
+        return kerning != p_atlas.kernings.end() && kerning->firstCodepoint == p_first && kerning->secondCodepoint == p_second ? kerning->advance : 0.0f;
+    }
+
+    static void Delete(FontAtlas& p_atlas)
+    {
+        glDeleteTextures(1, &p_atlas.texture);
+        p_atlas = FontAtlas{};
+    }
+}
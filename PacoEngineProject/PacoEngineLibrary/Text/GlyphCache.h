@@ -0,0 +1,613 @@
+#pragma once
+
+//std
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL.h>
+#include <glad/glad/gl.h>
+#include <stb_rect_pack.h>
+#include <stb_truetype.h>
+
+//engine
+#include "Core/MappedFile.h"
+#include "Core/Profiler.h"
+#include "Rendering/DynamicAtlas.h"
+#include "Text/FontAtlas.h"
+#include "Text/TextLayout.h"
+
+
+enum class GlyphCacheState
+{
+    Queued,
+    Ready,
+
+    //Larger than a page or missing from the font, drawn with the fallback glyph for good
+    Failed,
+};
+
+struct GlyphCacheEntry
+{
+    GlyphCacheState state = GlyphCacheState::Queued;
+
+    //Page holding the texels, -1 while queued and for glyphs without outline
+    int32_t page = -1;
+
+    Uint64 requestNs = 0;
+};
+
+//Square tile of the cache texture, packed with stb_rect_pack and evicted as a whole
+struct GlyphCachePage
+{
+    std::unique_ptr<DynamicAtlasPacker> packer;
+    GLint x = 0;
+    GLint y = 0;
+    uint32_t lastUsedFrame = 0;
+    std::vector<uint32_t> codepoints;
+
+    //Holds the fallback glyph, never evicted
+    bool isPinned = false;
+};
+
+//Glyph rasterized by a worker, pixels are RGBA8 with row 0 at the bottom
+struct GlyphCacheResult
+{
+    FontBakedGlyph bakedGlyph;
+};
+
+struct GlyphCacheStats
+{
+    //Codepoints looked up by RequestText during the last frame
+    unsigned int hitCount = 0;
+    unsigned int missCount = 0;
+    float hitRate = 0.0f;
+
+    //Glyphs queued or being rasterized
+    unsigned int pendingCount = 0;
+    unsigned int residentGlyphCount = 0;
+    unsigned int failedGlyphCount = 0;
+    unsigned int rasterizedCount = 0;
+    unsigned int evictedPageCount = 0;
+    unsigned int evictedGlyphCount = 0;
+
+    //From the first request to the glyph being drawable
+    Uint64 averageLatencyNs = 0;
+    Uint64 maxLatencyNs = 0;
+};
+
+//MSDF glyphs rasterized on demand, for character sets far too large to bake up front such as CJK.
+//RequestText queues the codepoints of a string that are not resident, worker threads rasterize them with msdfgen
+//and Update packs the results into pages of one texture. The cache never grows past its memory budget : when no page
+//has room the least recently used page is emptied, its glyphs are requested again the next time they are drawn.
+//Until a glyph arrives it is drawn as the fallback glyph with its own advance, so lines do not shift when it does.
+//atlas is an ordinary FontAtlas for TextLayout and TextRenderer, its revision changes with every glyph added or evicted.
+struct GlyphCache
+{
+    FontAtlas atlas;
+    GLsizei pageSize = 0;
+    std::vector<GlyphCachePage> pages;
+    std::unordered_map<uint32_t, GlyphCacheEntry> entries;
+    uint32_t frame = 0;
+
+    //The font file stays mapped while workers read outlines from it
+    MappedFile fontFile;
+    stbtt_fontinfo font = {};
+    FontGlyph fallbackGlyph;
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<uint32_t> queuedCodepoints;
+    std::vector<GlyphCacheResult> finishedResults;
+    bool stopRequested = false;
+
+    //Render thread only
+    std::vector<GlyphCacheResult> uploadResults;
+    unsigned int pendingCount = 0;
+    unsigned int failedCount = 0;
+    unsigned int rasterizedCount = 0;
+    unsigned int evictedPageCount = 0;
+    unsigned int evictedGlyphCount = 0;
+    Uint64 totalLatencyNs = 0;
+    Uint64 maxLatencyNs = 0;
+
+    GlyphCacheStats frameStats;
+    GlyphCacheStats lastFrameStats;
+};
+
+namespace GlyphCacheFunctions
+{
+    //Expands RGB8 texels in place, so rows of any width upload with the default unpack alignment
+    static void ExpandToRgba(std::vector<uint8_t>& p_pixels)
+    {
+        const size_t texelCount = p_pixels.size() / 3;
+        p_pixels.resize(texelCount * 4);
+
+        for (size_t texel = texelCount; texel-- > 0;)
+        {
+            p_pixels[texel * 4 + 3] = 255;
+            p_pixels[texel * 4 + 2] = p_pixels[texel * 3 + 2];
+            p_pixels[texel * 4 + 1] = p_pixels[texel * 3 + 1];
+            p_pixels[texel * 4 + 0] = p_pixels[texel * 3 + 0];
+        }
+    }
+
+    static void RunWorker(GlyphCache& p_cache)
+    {
+        PACO_PROFILE_THREAD_NAME("Glyph Cache");
+
+        while (true)
+        {
+            uint32_t codepoint = 0;
+
+            {
+                std::unique_lock<std::mutex> lock(p_cache.mutex);
+                p_cache.condition.wait(lock, [&p_cache]() { return p_cache.stopRequested || !p_cache.queuedCodepoints.empty(); });
+
+                if (p_cache.stopRequested)
+                {
+                    break;
+                }
+
+                codepoint = p_cache.queuedCodepoints.front();
+                p_cache.queuedCodepoints.pop_front();
+            }
+
+            GlyphCacheResult result;
+            FontAtlasFunctions::BakeGlyph(p_cache.font, codepoint, p_cache.atlas.settings, result.bakedGlyph);
+            ExpandToRgba(result.bakedGlyph.pixels);
+
+            {
+                std::lock_guard<std::mutex> lock(p_cache.mutex);
+                p_cache.finishedResults.push_back(std::move(result));
+            }
+        }
+    }
+
+    //Keeps atlas.glyphs sorted by codepoint, replacing the glyph already there
+    static void SetAtlasGlyph(GlyphCache& p_cache, const FontGlyph& p_glyph)
+    {
+        std::vector<FontGlyph>& glyphs = p_cache.atlas.glyphs;
+
+        auto glyph = std::lower_bound(glyphs.begin(), glyphs.end(), p_glyph.codepoint,
+            [](const FontGlyph& p_existing, uint32_t p_value) { return p_existing.codepoint < p_value; });
+
+        if (glyph != glyphs.end() && glyph->codepoint == p_glyph.codepoint)
+        {
+            *glyph = p_glyph;
+        }
+        else
+        {
+            glyphs.insert(glyph, p_glyph);
+        }
+
+        p_cache.atlas.revision++;
+    }
+
+    //Glyphs are packed one texel apart, so bilinear filtering at the quad edges reads no other glyph
+    static bool FitsInPage(const GlyphCache& p_cache, const FontGlyph& p_glyph)
+    {
+        return p_glyph.atlasWidth + 1 <= p_cache.pageSize && p_glyph.atlasHeight + 1 <= p_cache.pageSize;
+    }
+
+    //Returns false when every page is full and was filled or used this frame, p_glyph must fit in a page
+    static bool Insert(GlyphCache& p_cache, FontGlyph& p_glyph, int32_t& p_outPage)
+    {
+        stbrp_rect rect = {};
+        rect.w = p_glyph.atlasWidth + 1;
+        rect.h = p_glyph.atlasHeight + 1;
+
+        int32_t leastRecentPage = -1;
+
+        for (int32_t page = 0; page < static_cast<int32_t>(p_cache.pages.size()); page++)
+        {
+            GlyphCachePage& cachePage = p_cache.pages[page];
+
+            if (stbrp_pack_rects(&cachePage.packer->context, &rect, 1) == 1)
+            {
+                p_glyph.atlasX = cachePage.x + rect.x;
+                p_glyph.atlasY = cachePage.y + rect.y;
+                p_outPage = page;
+                return true;
+            }
+
+            if (!cachePage.isPinned && cachePage.lastUsedFrame != p_cache.frame && (leastRecentPage < 0 || cachePage.lastUsedFrame < p_cache.pages[leastRecentPage].lastUsedFrame))
+            {
+                leastRecentPage = page;
+            }
+        }
+
+        if (leastRecentPage < 0)
+        {
+            return false;
+        }
+
+        //Empties the page, its glyphs leave the atlas and are requested again by the next text drawing them
+        GlyphCachePage& evictedPage = p_cache.pages[leastRecentPage];
+
+        for (uint32_t codepoint : evictedPage.codepoints)
+        {
+            p_cache.entries.erase(codepoint);
+
+            std::vector<FontGlyph>& glyphs = p_cache.atlas.glyphs;
+            auto glyph = std::lower_bound(glyphs.begin(), glyphs.end(), codepoint,
+                [](const FontGlyph& p_existing, uint32_t p_value) { return p_existing.codepoint < p_value; });
+            glyphs.erase(glyph);
+        }
+
+        p_cache.evictedGlyphCount += static_cast<unsigned int>(evictedPage.codepoints.size());
+        p_cache.evictedPageCount++;
+        p_cache.atlas.revision++;
+
+        evictedPage.codepoints.clear();
+        evictedPage.packer = DynamicAtlasFunctions::CreatePacker(p_cache.pageSize);
+        stbrp_pack_rects(&evictedPage.packer->context, &rect, 1);
+
+        p_glyph.atlasX = evictedPage.x + rect.x;
+        p_glyph.atlasY = evictedPage.y + rect.y;
+        p_outPage = leastRecentPage;
+
+        return true;
+    }
+
+    static void Upload(GlyphCache& p_cache, const FontBakedGlyph& p_bakedGlyph)
+    {
+        const FontGlyph& glyph = p_bakedGlyph.glyph;
+        glTextureSubImage2D(p_cache.atlas.texture, 0, glyph.atlasX, glyph.atlasY, glyph.atlasWidth, glyph.atlasHeight, GL_RGBA, GL_UNSIGNED_BYTE, p_bakedGlyph.pixels.data());
+    }
+
+    //In ems
+    static float GetAdvance(const GlyphCache& p_cache, int p_glyphIndex)
+    {
+        int advanceWidth = 0;
+        stbtt_GetGlyphHMetrics(&p_cache.font, p_glyphIndex, &advanceWidth, nullptr);
+
+        return advanceWidth * stbtt_ScaleForMappingEmToPixels(&p_cache.font, 1.0f);
+    }
+
+    //Glyph drawn in place of p_codepoint until it is resident
+    static FontGlyph MakePlaceholderGlyph(const GlyphCache& p_cache, uint32_t p_codepoint, int p_glyphIndex)
+    {
+        FontGlyph glyph = p_cache.fallbackGlyph;
+        glyph.codepoint = p_codepoint;
+        glyph.advance = GetAdvance(p_cache, p_glyphIndex);
+
+        return glyph;
+    }
+
+    //p_budgetBytes is the size of the RGBA8 cache texture, it is split in pages of p_pageSize texels square.
+    //Only glyphSize and distanceRange of p_settings are used. Needs a current GL context.
+    static bool Create(GlyphCache& p_cache, const char* p_fontPath, const FontAtlasSettings& p_settings, size_t p_budgetBytes, GLsizei p_pageSize = 256, unsigned int p_threadCount = 2)
+    {
+        PACO_PROFILE_SCOPE("GlyphCache::Create");
+
+        const size_t pageBytes = p_pageSize > 0 ? static_cast<size_t>(p_pageSize) * p_pageSize * 4 : 0;
+        const unsigned int budgetPageCount = pageBytes > 0 ? static_cast<unsigned int>(p_budgetBytes / pageBytes) : 0;
+
+        //One page for the fallback glyph and the glyphs sharing it, at least one to rotate through
+        if (budgetPageCount < 2)
+        {
+            SDL_Log("Glyph cache budget of %zu bytes holds fewer than 2 pages of %d texels", p_budgetBytes, p_pageSize);
+            return false;
+        }
+
+        GLint maxTextureSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+
+        //Close to square grid of whole pages that stays within the budget
+        unsigned int columnCount = 1;
+
+        while ((columnCount + 1) * (columnCount + 1) <= budgetPageCount)
+        {
+            columnCount++;
+        }
+
+        const unsigned int rowCount = budgetPageCount / columnCount;
+        const unsigned int pageCount = columnCount * rowCount;
+
+        if (static_cast<GLint>(rowCount * p_pageSize) > maxTextureSize)
+        {
+            SDL_Log("Glyph cache budget of %zu bytes exceeds the maximum texture size of %d", p_budgetBytes, maxTextureSize);
+            return false;
+        }
+
+        if (!MappedFileFunctions::Open(p_cache.fontFile, p_fontPath))
+        {
+            SDL_Log("Failed to open font %s", p_fontPath);
+            return false;
+        }
+
+        if (!stbtt_InitFont(&p_cache.font, p_cache.fontFile.data, stbtt_GetFontOffsetForIndex(p_cache.fontFile.data, 0)))
+        {
+            SDL_Log("Failed to parse font %s", p_fontPath);
+            MappedFileFunctions::Close(p_cache.fontFile);
+            return false;
+        }
+
+        p_cache.pageSize = p_pageSize;
+
+        //Rasterized right away on this thread so there is always something to draw
+        FontBakedGlyph fallback;
+        FontAtlasFunctions::BakeGlyph(p_cache.font, TextLayoutFunctions::replacementCodepoint, p_settings, fallback);
+        ExpandToRgba(fallback.pixels);
+
+        if (!FitsInPage(p_cache, fallback.glyph))
+        {
+            SDL_Log("Fallback glyph of %s does not fit in a glyph cache page of %d texels", p_fontPath, p_pageSize);
+            MappedFileFunctions::Close(p_cache.fontFile);
+            return false;
+        }
+
+        FontAtlas& atlas = p_cache.atlas;
+        atlas.settings = p_settings;
+        atlas.width = static_cast<GLsizei>(columnCount * p_pageSize);
+        atlas.height = static_cast<GLsizei>(rowCount * p_pageSize);
+
+        float emScale = stbtt_ScaleForMappingEmToPixels(&p_cache.font, 1.0f);
+        int ascender = 0;
+        int descender = 0;
+        int lineGap = 0;
+        stbtt_GetFontVMetrics(&p_cache.font, &ascender, &descender, &lineGap);
+
+        atlas.ascender = ascender * emScale;
+        atlas.descender = descender * emScale;
+        atlas.lineHeight = (ascender - descender + lineGap) * emScale;
+
+        glCreateTextures(GL_TEXTURE_2D, 1, &atlas.texture);
+        glTextureStorage2D(atlas.texture, 1, GL_RGBA8, atlas.width, atlas.height);
+        glTextureParameteri(atlas.texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(atlas.texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(atlas.texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(atlas.texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        p_cache.pages.resize(pageCount);
+
+        for (unsigned int page = 0; page < pageCount; page++)
+        {
+            p_cache.pages[page].packer = DynamicAtlasFunctions::CreatePacker(p_pageSize);
+            p_cache.pages[page].x = static_cast<GLint>(page % columnCount * p_pageSize);
+            p_cache.pages[page].y = static_cast<GLint>(page / columnCount * p_pageSize);
+        }
+
+        //The fallback is placed first in the empty pages, its page is never evicted
+        GlyphCacheEntry& fallbackEntry = p_cache.entries[fallback.glyph.codepoint];
+        fallbackEntry.state = GlyphCacheState::Ready;
+
+        if (!fallback.pixels.empty() && Insert(p_cache, fallback.glyph, fallbackEntry.page))
+        {
+            Upload(p_cache, fallback);
+            p_cache.pages[fallbackEntry.page].codepoints.push_back(fallback.glyph.codepoint);
+            p_cache.pages[fallbackEntry.page].isPinned = true;
+        }
+
+        p_cache.fallbackGlyph = fallback.glyph;
+        SetAtlasGlyph(p_cache, fallback.glyph);
+
+        for (unsigned int thread = 0; thread < p_threadCount; thread++)
+        {
+            p_cache.threads.emplace_back(RunWorker, std::ref(p_cache));
+        }
+
+        return true;
+    }
+
+    //Marks the glyphs of UTF-8 p_text as used this frame and queues the missing ones. Never waits.
+    //Call it for every string drawn with the cache, before laying the string out.
+    static void RequestText(GlyphCache& p_cache, std::string_view p_text)
+    {
+        const char* cursor = p_text.data();
+        const char* end = cursor + p_text.size();
+        bool isQueued = false;
+
+        while (cursor < end)
+        {
+            uint32_t codepoint = TextLayoutFunctions::DecodeUtf8(cursor, end);
+
+            if (codepoint == '\n')
+            {
+                continue;
+            }
+
+            auto found = p_cache.entries.find(codepoint);
+
+            if (found != p_cache.entries.end())
+            {
+                if (found->second.page >= 0)
+                {
+                    p_cache.pages[found->second.page].lastUsedFrame = p_cache.frame;
+                }
+
+                if (found->second.state == GlyphCacheState::Queued)
+                {
+                    p_cache.frameStats.missCount++;
+                }
+                else
+                {
+                    p_cache.frameStats.hitCount++;
+                }
+
+                continue;
+            }
+
+            p_cache.frameStats.missCount++;
+
+            const int glyphIndex = stbtt_FindGlyphIndex(&p_cache.font, static_cast<int>(codepoint));
+            GlyphCacheEntry& entry = p_cache.entries[codepoint];
+
+            //Codepoints the font lacks resolve to the replacement glyph in TextLayout, the entry keeps them from being looked up again
+            if (glyphIndex == 0)
+            {
+                entry.state = GlyphCacheState::Failed;
+                p_cache.failedCount++;
+                continue;
+            }
+
+            //Glyphs without outline such as spaces are final right away, only their advance matters
+            if (stbtt_IsGlyphEmpty(&p_cache.font, glyphIndex))
+            {
+                FontGlyph glyph;
+                glyph.codepoint = codepoint;
+                glyph.advance = GetAdvance(p_cache, glyphIndex);
+
+                entry.state = GlyphCacheState::Ready;
+                SetAtlasGlyph(p_cache, glyph);
+                continue;
+            }
+
+            entry.requestNs = SDL_GetTicksNS();
+            p_cache.pendingCount++;
+
+            SetAtlasGlyph(p_cache, MakePlaceholderGlyph(p_cache, codepoint, glyphIndex));
+
+            {
+                std::lock_guard<std::mutex> lock(p_cache.mutex);
+                p_cache.queuedCodepoints.push_back(codepoint);
+            }
+
+            isQueued = true;
+        }
+
+        if (isQueued)
+        {
+            p_cache.condition.notify_all();
+        }
+    }
+
+    //Once per frame on the render thread before any text is laid out, packs and uploads the glyphs rasterized since the last call
+    static void Update(GlyphCache& p_cache)
+    {
+        PACO_PROFILE_SCOPE("GlyphCache::Update");
+
+        p_cache.frameStats.pendingCount = p_cache.pendingCount;
+        p_cache.frameStats.residentGlyphCount = static_cast<unsigned int>(p_cache.entries.size()) - p_cache.pendingCount - p_cache.failedCount;
+        p_cache.frameStats.failedGlyphCount = p_cache.failedCount;
+        p_cache.frameStats.rasterizedCount = p_cache.rasterizedCount;
+        p_cache.frameStats.evictedPageCount = p_cache.evictedPageCount;
+        p_cache.frameStats.evictedGlyphCount = p_cache.evictedGlyphCount;
+        p_cache.frameStats.averageLatencyNs = p_cache.rasterizedCount > 0 ? p_cache.totalLatencyNs / p_cache.rasterizedCount : 0;
+        p_cache.frameStats.maxLatencyNs = p_cache.maxLatencyNs;
+
+        const unsigned int lookupCount = p_cache.frameStats.hitCount + p_cache.frameStats.missCount;
+        p_cache.frameStats.hitRate = lookupCount > 0 ? static_cast<float>(p_cache.frameStats.hitCount) / lookupCount : 1.0f;
+
+        p_cache.lastFrameStats = p_cache.frameStats;
+        p_cache.frameStats = GlyphCacheStats{};
+        p_cache.frame++;
+
+        {
+            std::lock_guard<std::mutex> lock(p_cache.mutex);
+            std::swap(p_cache.uploadResults, p_cache.finishedResults);
+        }
+
+        Uint64 nowNs = SDL_GetTicksNS();
+        size_t deferredCount = 0;
+
+        for (GlyphCacheResult& result : p_cache.uploadResults)
+        {
+            FontGlyph& glyph = result.bakedGlyph.glyph;
+            GlyphCacheEntry& entry = p_cache.entries[glyph.codepoint];
+
+            if (!result.bakedGlyph.pixels.empty() && !FitsInPage(p_cache, glyph))
+            {
+                SDL_Log("Glyph U+%04X of %dx%d texels does not fit in a glyph cache page", glyph.codepoint, glyph.atlasWidth, glyph.atlasHeight);
+                entry.state = GlyphCacheState::Failed;
+                p_cache.failedCount++;
+            }
+            else if (!result.bakedGlyph.pixels.empty())
+            {
+                //Every page took glyphs this frame already, the glyph waits for the next Update
+                if (!Insert(p_cache, glyph, entry.page))
+                {
+                    p_cache.uploadResults[deferredCount++] = std::move(result);
+                    continue;
+                }
+
+                Upload(p_cache, result.bakedGlyph);
+                p_cache.pages[entry.page].codepoints.push_back(glyph.codepoint);
+                p_cache.pages[entry.page].lastUsedFrame = p_cache.frame;
+                entry.state = GlyphCacheState::Ready;
+                SetAtlasGlyph(p_cache, glyph);
+            }
+            else
+            {
+                entry.state = GlyphCacheState::Ready;
+                SetAtlasGlyph(p_cache, glyph);
+            }
+
+            Uint64 latencyNs = nowNs - entry.requestNs;
+            p_cache.totalLatencyNs += latencyNs;
+            p_cache.maxLatencyNs = std::max(p_cache.maxLatencyNs, latencyNs);
+            p_cache.rasterizedCount++;
+            p_cache.pendingCount--;
+        }
+
+        p_cache.uploadResults.resize(deferredCount);
+
+        if (deferredCount > 0)
+        {
+            std::lock_guard<std::mutex> lock(p_cache.mutex);
+            p_cache.finishedResults.insert(p_cache.finishedResults.begin(), std::make_move_iterator(p_cache.uploadResults.begin()), std::make_move_iterator(p_cache.uploadResults.end()));
+        }
+
+        p_cache.uploadResults.clear();
+    }
+
+    //Counters of the last finished frame, the totals count since Create
+    static const GlyphCacheStats& GetStats(const GlyphCache& p_cache)
+    {
+        return p_cache.lastFrameStats;
+    }
+
+    //Codepoints still queued are dropped
+    static void Destroy(GlyphCache& p_cache)
+    {
+        {
+            std::lock_guard<std::mutex> lock(p_cache.mutex);
+            p_cache.stopRequested = true;
+        }
+
+        p_cache.condition.notify_all();
+
+        for (std::thread& thread : p_cache.threads)
+        {
+            thread.join();
+        }
+
+        glDeleteTextures(1, &p_cache.atlas.texture);
+        MappedFileFunctions::Close(p_cache.fontFile);
+
+        p_cache.atlas = FontAtlas{};
+        p_cache.pages.clear();
+        p_cache.entries.clear();
+        p_cache.threads.clear();
+        p_cache.queuedCodepoints.clear();
+        p_cache.finishedResults.clear();
+        p_cache.uploadResults.clear();
+        p_cache.fontFile = MappedFile{};
+        p_cache.font = stbtt_fontinfo{};
+        p_cache.fallbackGlyph = FontGlyph{};
+        p_cache.stopRequested = false;
+        p_cache.frame = 0;
+        p_cache.pendingCount = 0;
+        p_cache.failedCount = 0;
+        p_cache.rasterizedCount = 0;
+        p_cache.evictedPageCount = 0;
+        p_cache.evictedGlyphCount = 0;
+        p_cache.totalLatencyNs = 0;
+        p_cache.maxLatencyNs = 0;
+        p_cache.frameStats = GlyphCacheStats{};
+        p_cache.lastFrameStats = GlyphCacheStats{};
+    }
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+//std
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+//engine
+#include "Text/FontAtlas.h"
+
+
+//One glyph of laid out text, in pixels from the top left corner of the text with y pointing down
+struct TextGlyphQuad
+{
+    float left, top, right, bottom;
+
+    //Atlas texture coordinates of the left top and right bottom corners
+    float u0, v0, u1, v1;
+};
+
+namespace TextLayoutFunctions
+{
+    //Drawn for codepoints missing from the atlas, U+FFFD included
+    constexpr uint32_t replacementCodepoint = '?';
+
+    //Advance of a space the atlas has no glyph for, in ems
+    constexpr float missingSpaceAdvance = 0.25f;
+
+    //Reads one codepoint and advances p_cursor. Malformed sequences, overlong encodings, surrogates and
+    //codepoints past U+10FFFF decode as U+FFFD one byte at a time, which Layout draws as replacementCodepoint.
+    static uint32_t DecodeUtf8(const char*& p_cursor, const char* p_end)
+    {
+        const unsigned char lead = static_cast<unsigned char>(*p_cursor++);
+
+        if (lead < 0x80)
+        {
+            return lead;
+        }
+
+        int continuationCount = lead >= 0xF8 ? -1 : lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC2 ? 1 : -1;
+
+        if (continuationCount < 0 || p_end - p_cursor < continuationCount)
+        {
+            return 0xFFFD;
+        }
+
+        uint32_t codepoint = lead & (0x3F >> continuationCount);
+
+        for (int continuation = 0; continuation < continuationCount; continuation++)
+        {
+            const unsigned char byte = static_cast<unsigned char>(p_cursor[continuation]);
+
+            if ((byte & 0xC0) != 0x80)
+            {
+                return 0xFFFD;
+            }
+
+            codepoint = (codepoint << 6) | (byte & 0x3F);
+        }
+
+        const uint32_t minimumCodepoint = continuationCount == 3 ? 0x10000 : continuationCount == 2 ? 0x800 : 0x80;
+
+        if (codepoint < minimumCodepoint || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+        {
+            return 0xFFFD;
+        }
+
+        p_cursor += continuationCount;
+
+        return codepoint;
+    }
+
+    //Lays out UTF-8 p_text at p_size pixels per em into p_outQuads, with kerning and '\n' starting a new line.
+    //A non zero p_maxWidth wraps lines at the last space that keeps them narrower, words wider than that overflow.
+    //Codepoints missing from the atlas are drawn as '?' when the atlas has it, a missing space still advances and breaks lines. p_outWidth and p_outHeight receive the bounds.
+    static void Layout(const FontAtlas& p_font, std::string_view p_text, float p_size, float p_maxWidth, std::vector<TextGlyphQuad>& p_outQuads, float& p_outWidth, float& p_outHeight)
+    {
+        p_outQuads.clear();
+
+        const float atlasWidth = static_cast<float>(p_font.width);
+        const float atlasHeight = static_cast<float>(p_font.height);
+        const float lineHeight = p_font.lineHeight * p_size;
+
+        float penX = 0.0f;
+        float baseline = p_font.ascender * p_size;
+        unsigned int lineCount = 1;
+
+        //Where the current line may be broken : first quad of the next word and where that word starts
+        size_t lineFirstQuad = 0;
+        size_t breakQuad = 0;
+        float breakPenX = 0.0f;
+        bool hasBreak = false;
+
+        uint32_t previousCodepoint = 0;
+        const char* cursor = p_text.data();
+        const char* end = cursor + p_text.size();
+
+        while (cursor < end)
+        {
+            uint32_t codepoint = DecodeUtf8(cursor, end);
+
+            if (codepoint == '\n')
+            {
+                penX = 0.0f;
+                baseline += lineHeight;
+                lineCount++;
+                lineFirstQuad = p_outQuads.size();
+                hasBreak = false;
+                previousCodepoint = 0;
+                continue;
+            }
+
+            const FontGlyph* glyph = FontAtlasFunctions::FindGlyph(p_font, codepoint);
+
+            if (glyph == nullptr && codepoint != ' ')
+            {
+                codepoint = replacementCodepoint;
+                glyph = FontAtlasFunctions::FindGlyph(p_font, codepoint);
+
+                if (glyph == nullptr)
+                {
+                    continue;
+                }
+            }
+
+            if (previousCodepoint != 0)
+            {
+                penX += FontAtlasFunctions::GetKerning(p_font, previousCodepoint, codepoint) * p_size;
+            }
+
+            previousCodepoint = codepoint;
+
+            if (codepoint == ' ')
+            {
+                penX += (glyph != nullptr ? glyph->advance : missingSpaceAdvance) * p_size;
+                breakQuad = p_outQuads.size();
+                breakPenX = penX;
+                hasBreak = breakQuad > lineFirstQuad;
+                continue;
+            }
+
+            float right = penX + glyph->planeRight * p_size;
+
+            //Moves the word being written to a new line
+            if (p_maxWidth > 0.0f && right > p_maxWidth && hasBreak)
+            {
+                for (size_t quad = breakQuad; quad < p_outQuads.size(); quad++)
+                {
+                    p_outQuads[quad].left -= breakPenX;
+                    p_outQuads[quad].right -= breakPenX;
+                    p_outQuads[quad].top += lineHeight;
+                    p_outQuads[quad].bottom += lineHeight;
+                }
+
+                penX -= breakPenX;
+                right -= breakPenX;
+                baseline += lineHeight;
+                lineCount++;
+                lineFirstQuad = breakQuad;
+                hasBreak = false;
+            }
+
+            if (glyph->atlasWidth > 0)
+            {
+                TextGlyphQuad quad;
+                quad.left = penX + glyph->planeLeft * p_size;
+                quad.right = right;
+                quad.top = baseline - glyph->planeTop * p_size;
+                quad.bottom = baseline - glyph->planeBottom * p_size;
+                quad.u0 = static_cast<float>(glyph->atlasX) / atlasWidth;
+                quad.v0 = static_cast<float>(glyph->atlasY + glyph->atlasHeight) / atlasHeight;
+                quad.u1 = static_cast<float>(glyph->atlasX + glyph->atlasWidth) / atlasWidth;
+                quad.v1 = static_cast<float>(glyph->atlasY) / atlasHeight;
+
+                p_outQuads.push_back(quad);
+            }
+
+            penX += glyph->advance * p_size;
+        }
+
+        p_outWidth = 0.0f;
+
+        for (const TextGlyphQuad& quad : p_outQuads)
+        {
+            p_outWidth = std::max(p_outWidth, quad.right);
+        }
+
+        p_outHeight = lineHeight * static_cast<float>(lineCount);
+    }
+}
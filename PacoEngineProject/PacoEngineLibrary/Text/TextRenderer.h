@@ -0,0 +1,356 @@
+#pragma once
+
+//std
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//vendor
+#include <SDL3/SDL_log.h>
+#include <glad/glad/gl.h>
+
+//engine
+#include "Core/Hash.h"
+#include "Core/Profiler.h"
+#include "Core/RadixSort.h"
+#include "Rendering/SpriteBatch.h"
+#include "Rendering/StreamingRenderComponent.h"
+#include "Text/FontAtlas.h"
+#include "Text/TextLayout.h"
+
+
+//range is the distance range of the atlas in screen pixels, what the fragment shader needs to antialias the median distance :
+//    alpha = clamp((median(sample.r, sample.g, sample.b) - 0.5) * range + 0.5, 0.0, 1.0)
+struct TextVertex
+{
+    float x, y;
+    float u, v, range;
+    uint8_t r, g, b, a;
+
+    static const std::array<VertexAttribute, 3> attributes;
+};
+
+constexpr std::array<VertexAttribute, 3> TextVertex::attributes =
+{{
+    { 0, 2, GL_FLOAT, GL_FALSE, offsetof(TextVertex, x) },
+    { 1, 3, GL_FLOAT, GL_FALSE, offsetof(TextVertex, u) },
+    { 2, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(TextVertex, r) },
+}};
+
+//Laid out text, kept across frames while it is drawn
+struct TextRun
+{
+    std::string text;
+    const FontAtlas* font = nullptr;
+    float size = 0.0f;
+    float maxWidth = 0.0f;
+    uint64_t fontRevision = 0;
+
+    std::vector<TextGlyphQuad> quads;
+    float width = 0.0f;
+    float height = 0.0f;
+
+    uint64_t lastUsedFrame = 0;
+};
+
+struct TextDraw
+{
+    uint32_t run;
+
+    //Quads of the run when it was submitted, what End writes and what drawQuadCount counted
+    uint32_t quadCount;
+    float x, y;
+    uint8_t r, g, b, a;
+    GLuint program;
+};
+
+struct TextRendererStats
+{
+    unsigned int drawCount = 0;
+    unsigned int quadCount = 0;
+    unsigned int flushCount = 0;
+    unsigned int droppedQuadCount = 0;
+
+    //Runs laid out this frame, the others were found in the cache
+    unsigned int layoutCount = 0;
+    unsigned int cachedRunCount = 0;
+    unsigned int evictedRunCount = 0;
+};
+
+//Draws text from MSDF font atlases. A string is laid out once per font, size and wrap width, the glyph quads are cached
+//and every later frame only offsets them into one stream buffer, so unchanged labels cost no layout at all.
+//A run laid out from an older font revision is laid out again, which keeps labels of a GlyphCache font current.
+//Draws are sorted by program and atlas, every run of identical state is one glDrawElements whatever the label count.
+//Runs not drawn for runLifetimeFrames frames are dropped, so changing strings such as damage numbers do not pile up.
+struct TextRenderer
+{
+    StreamingRenderComponent streamingComponent;
+    unsigned int quadCapacity = 0;
+    unsigned int runLifetimeFrames = 120;
+
+    std::vector<TextRun> runs;
+    std::vector<uint32_t> freeRuns;
+    std::unordered_map<uint64_t, uint32_t> runsByKey;
+
+    //Runs whose key collides with a run already drawn this frame, laid out for this frame only and freed by End
+    std::vector<uint32_t> uncachedRuns;
+
+    std::vector<TextDraw> draws;
+    unsigned int drawQuadCount = 0;
+    uint64_t frame = 0;
+
+    std::vector<uint64_t> sortKeys;
+    std::vector<uint32_t> sortIndices;
+    std::vector<uint64_t> sortScratchKeys;
+    std::vector<uint32_t> sortScratchIndices;
+
+    TextRendererStats frameStats;
+    TextRendererStats lastFrameStats;
+};
+
+namespace TextRendererFunctions
+{
+    //p_quadCapacity is the maximum number of glyphs drawn in a single frame
+    static bool Create(TextRenderer& p_textRenderer, unsigned int p_quadCapacity, unsigned int p_runLifetimeFrames = 120)
+    {
+        std::vector<uint16_t> quadIndices = SpriteBatchFunctions::CreateQuadIndices(p_quadCapacity);
+
+        if (!StreamingRenderComponentFunctions::CreateWithStaticIndices<TextVertex>(p_textRenderer.streamingComponent, p_quadCapacity * 4, quadIndices.data(), static_cast<unsigned int>(quadIndices.size())))
+        {
+            SDL_Log("Failed to create TextRenderer with a capacity of %u quads", p_quadCapacity);
+            return false;
+        }
+
+        RenderComponentFunctions::SetAttributeFormats<TextVertex>(p_textRenderer.streamingComponent.renderComponent);
+
+        p_textRenderer.quadCapacity = p_quadCapacity;
+        p_textRenderer.runLifetimeFrames = p_runLifetimeFrames;
+
+        return true;
+    }
+
+    static void Begin(TextRenderer& p_textRenderer)
+    {
+        p_textRenderer.draws.clear();
+        p_textRenderer.drawQuadCount = 0;
+        p_textRenderer.frame++;
+        p_textRenderer.frameStats = TextRendererStats{};
+    }
+
+    static uint64_t ComputeRunKey(const FontAtlas& p_font, std::string_view p_text, float p_size, float p_maxWidth)
+    {
+        uint64_t hash = HashFunctions::HashValue(HashFunctions::fnvOffsetBasis, reinterpret_cast<uintptr_t>(&p_font));
+        hash = HashFunctions::HashBytes(hash, p_text.data(), p_text.size());
+
+        uint32_t sizeBits = 0;
+        uint32_t maxWidthBits = 0;
+        std::memcpy(&sizeBits, &p_size, sizeof(sizeBits));
+        std::memcpy(&maxWidthBits, &p_maxWidth, sizeof(maxWidthBits));
+
+        hash = HashFunctions::HashValue(hash, sizeBits);
+
+        return HashFunctions::HashValue(hash, maxWidthBits);
+    }
+
+    //Returns the index in runs of the run of p_text, laid out now unless an earlier frame already did, its width and
+    //height are there to align the text. p_size is in pixels per em, a non zero p_maxWidth wraps lines narrower than it.
+    static uint32_t GetRun(TextRenderer& p_textRenderer, const FontAtlas& p_font, std::string_view p_text, float p_size, float p_maxWidth = 0.0f)
+    {
+        uint64_t key = ComputeRunKey(p_font, p_text, p_size, p_maxWidth);
+        auto found = p_textRenderer.runsByKey.find(key);
+
+        if (found != p_textRenderer.runsByKey.end())
+        {
+            TextRun& run = p_textRenderer.runs[found->second];
+
+            if (run.font == &p_font && run.fontRevision == p_font.revision && run.size == p_size && run.maxWidth == p_maxWidth && run.text == p_text)
+            {
+                run.lastUsedFrame = p_textRenderer.frame;
+                return found->second;
+            }
+        }
+
+        //A stale run or a key collision reuses the slot of the other run, unless a draw of this frame still uses it
+        const bool isSlotInUse = found != p_textRenderer.runsByKey.end() && p_textRenderer.runs[found->second].lastUsedFrame == p_textRenderer.frame;
+        uint32_t index = 0;
+
+        if (found != p_textRenderer.runsByKey.end() && !isSlotInUse)
+        {
+            index = found->second;
+        }
+        else if (!p_textRenderer.freeRuns.empty())
+        {
+            index = p_textRenderer.freeRuns.back();
+            p_textRenderer.freeRuns.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(p_textRenderer.runs.size());
+            p_textRenderer.runs.emplace_back();
+        }
+
+        if (isSlotInUse)
+        {
+            p_textRenderer.uncachedRuns.push_back(index);
+        }
+        else
+        {
+            p_textRenderer.runsByKey[key] = index;
+        }
+
+        //Keeps the capacity of the evicted run this slot held
+        TextRun& run = p_textRenderer.runs[index];
+        run.text.assign(p_text);
+        run.font = &p_font;
+        run.size = p_size;
+        run.maxWidth = p_maxWidth;
+        run.fontRevision = p_font.revision;
+        run.lastUsedFrame = p_textRenderer.frame;
+
+        TextLayoutFunctions::Layout(p_font, p_text, p_size, p_maxWidth, run.quads, run.width, run.height);
+        p_textRenderer.frameStats.layoutCount++;
+
+        return index;
+    }
+
+    //Draws p_text with its top left corner at p_x, p_y, in the pixel space of p_program's vertex shader with y pointing down
+    static void Submit(TextRenderer& p_textRenderer, GLuint p_program, const FontAtlas& p_font, std::string_view p_text, float p_x, float p_y, float p_size,
+        uint8_t p_r = 255, uint8_t p_g = 255, uint8_t p_b = 255, uint8_t p_a = 255, float p_maxWidth = 0.0f)
+    {
+        uint32_t run = GetRun(p_textRenderer, p_font, p_text, p_size, p_maxWidth);
+        uint32_t quadCount = static_cast<uint32_t>(p_textRenderer.runs[run].quads.size());
+
+        if (p_textRenderer.drawQuadCount + quadCount > p_textRenderer.quadCapacity)
+        {
+            p_textRenderer.frameStats.droppedQuadCount += quadCount;
+            return;
+        }
+
+        p_textRenderer.draws.push_back({ run, quadCount, p_x, p_y, p_r, p_g, p_b, p_a, p_program });
+        p_textRenderer.drawQuadCount += quadCount;
+    }
+
+    static void WriteRun(TextVertex* p_vertices, const TextRun& p_run, const TextDraw& p_draw)
+    {
+        //Screen pixels per atlas texel times the range in texels
+        const float range = p_run.font->settings.distanceRange * p_run.size / p_run.font->settings.glyphSize;
+
+        for (uint32_t quadIndex = 0; quadIndex < p_draw.quadCount; quadIndex++)
+        {
+            const TextGlyphQuad& quad = p_run.quads[quadIndex];
+            float left = p_draw.x + quad.left;
+            float top = p_draw.y + quad.top;
+            float right = p_draw.x + quad.right;
+            float bottom = p_draw.y + quad.bottom;
+
+            p_vertices[0] = { left,  top,    quad.u0, quad.v0, range, p_draw.r, p_draw.g, p_draw.b, p_draw.a };
+            p_vertices[1] = { right, top,    quad.u1, quad.v0, range, p_draw.r, p_draw.g, p_draw.b, p_draw.a };
+            p_vertices[2] = { right, bottom, quad.u1, quad.v1, range, p_draw.r, p_draw.g, p_draw.b, p_draw.a };
+            p_vertices[3] = { left,  bottom, quad.u0, quad.v1, range, p_draw.r, p_draw.g, p_draw.b, p_draw.a };
+            p_vertices += 4;
+        }
+    }
+
+    static void EvictUnusedRuns(TextRenderer& p_textRenderer)
+    {
+        for (auto entry = p_textRenderer.runsByKey.begin(); entry != p_textRenderer.runsByKey.end();)
+        {
+            TextRun& run = p_textRenderer.runs[entry->second];
+
+            if (p_textRenderer.frame - run.lastUsedFrame >= p_textRenderer.runLifetimeFrames)
+            {
+                p_textRenderer.freeRuns.push_back(entry->second);
+                p_textRenderer.frameStats.evictedRunCount++;
+                entry = p_textRenderer.runsByKey.erase(entry);
+            }
+            else
+            {
+                entry++;
+            }
+        }
+    }
+
+    //Writes the quads of every draw into the mapped stream region and issues one draw per program and atlas.
+    //Uniforms of the programs used (screen size for example) must be set before calling End.
+    static void End(TextRenderer& p_textRenderer, GLStateCache& p_stateCache)
+    {
+        PACO_PROFILE_SCOPE("TextRenderer::End");
+        PACO_PROFILE_GPU_SCOPE("TextRenderer::End");
+
+        std::vector<TextDraw>& draws = p_textRenderer.draws;
+        const unsigned int drawCount = static_cast<unsigned int>(draws.size());
+
+        p_textRenderer.frameStats.drawCount = drawCount;
+        p_textRenderer.frameStats.quadCount = p_textRenderer.drawQuadCount;
+
+        if (p_textRenderer.drawQuadCount > 0)
+        {
+            p_textRenderer.sortKeys.resize(drawCount);
+            p_textRenderer.sortIndices.resize(drawCount);
+
+            for (unsigned int draw = 0; draw < drawCount; draw++)
+            {
+                const TextRun& run = p_textRenderer.runs[draws[draw].run];
+                p_textRenderer.sortKeys[draw] = (static_cast<uint64_t>(draws[draw].program) << 32) | run.font->texture;
+                p_textRenderer.sortIndices[draw] = draw;
+            }
+
+            RadixSortFunctions::SortKeyValues(p_textRenderer.sortKeys, p_textRenderer.sortIndices, p_textRenderer.sortScratchKeys, p_textRenderer.sortScratchIndices);
+
+            StreamingRenderComponent& streamingComponent = p_textRenderer.streamingComponent;
+
+            StreamingRenderComponentFunctions::BeginFrame(streamingComponent);
+
+            GLint firstVertex = 0;
+            TextVertex* vertices = StreamingRenderComponentFunctions::AllocateVertices<TextVertex>(streamingComponent, p_textRenderer.drawQuadCount * 4, firstVertex);
+
+            RenderComponentFunctions::Bind(streamingComponent.renderComponent, p_stateCache);
+
+            unsigned int runFirstQuad = 0;
+            unsigned int quad = 0;
+
+            for (unsigned int draw = 0; draw < drawCount; draw++)
+            {
+                const TextDraw& textDraw = draws[p_textRenderer.sortIndices[draw]];
+                const TextRun& run = p_textRenderer.runs[textDraw.run];
+
+                WriteRun(vertices + static_cast<size_t>(quad) * 4, run, textDraw);
+                quad += textDraw.quadCount;
+
+                if (draw + 1 == drawCount || p_textRenderer.sortKeys[draw + 1] != p_textRenderer.sortKeys[draw])
+                {
+                    SpriteBatchFunctions::DrawQuads(p_stateCache, textDraw.program, run.font->texture, runFirstQuad, quad - runFirstQuad);
+                    p_textRenderer.frameStats.flushCount++;
+                    runFirstQuad = quad;
+                }
+            }
+
+            StreamingRenderComponentFunctions::EndFrame(streamingComponent);
+        }
+
+        EvictUnusedRuns(p_textRenderer);
+
+        p_textRenderer.freeRuns.insert(p_textRenderer.freeRuns.end(), p_textRenderer.uncachedRuns.begin(), p_textRenderer.uncachedRuns.end());
+        p_textRenderer.uncachedRuns.clear();
+
+        p_textRenderer.frameStats.cachedRunCount = static_cast<unsigned int>(p_textRenderer.runsByKey.size());
+        p_textRenderer.lastFrameStats = p_textRenderer.frameStats;
+    }
+
+    //Counters of the last finished frame
+    static const TextRendererStats& GetStats(const TextRenderer& p_textRenderer)
+    {
+        return p_textRenderer.lastFrameStats;
+    }
+
+    static void Delete(TextRenderer& p_textRenderer)
+    {
+        StreamingRenderComponentFunctions::Delete(p_textRenderer.streamingComponent);
+        p_textRenderer = TextRenderer{};
+    }
+}
@@ -1,4 +1,5 @@
 //std
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -7,120 +8,12 @@
 #include <SDL3/SDL_main.h>
 #include <glad/glad/gl.h>
 
+//engine
+#include "Core/GameLoop.h"
+#include "Core/Profiler.h"
+#include "Rendering/RenderComponent.h"
+#include "Rendering/RenderThread.h"
 
-//RenderBuffer Objects
-struct VertexAttribute {
-    GLuint index;          // The attribute location in the vertex shader (0, 1, 2, etc.)
-    GLint size;            // The number of components (1, 2, 3, 4, etc.)
-    GLenum type;           // The OpenGL data type (e.g., GL_FLOAT, GL_INT)
-    GLboolean normalized;  // Whether the attribute should be normalized (GL_TRUE/GL_FALSE)
-    GLuint offset;         // Offset of the attribute in the struct (in bytes)
-};
-
-
-struct RenderComponent
-{
-    GLuint vbo;
-    GLuint ebo;
-    GLuint vao;
-};
-
-namespace RenderComponentFunctions
-{
-    static void Create(RenderComponent& p_renderComponent)
-    {
-        glCreateBuffers(1, &p_renderComponent.vbo);
-        glCreateBuffers(1, &p_renderComponent.ebo);
-        glCreateVertexArrays(1, &p_renderComponent.vao);
-    }
-
-    static void Bind(RenderComponent& p_renderComponent)
-    {
-        glBindVertexArray(p_renderComponent.vao);
-    }
-
-    static void Unbind() 
-    {
-        glBindVertexArray(0);
-    }
-
-    template<typename TVertexType>
-    static void PreallocateBuffersMemory(RenderComponent& p_renderComponent, unsigned int p_vertexCount, unsigned int  p_indexCount, bool p_isStatic = false)
-    {
-        GLenum flags = GL_DYNAMIC_STORAGE_BIT;
-
-        if (p_isStatic)
-        {
-            flags = 0;
-        }
-
-        GLsizeiptr verticesSize = sizeof(TVertexType) * p_vertexCount;
-
-        GLsizeiptr indicesSize = sizeof(unsigned int) * p_indexCount;
-
-        glNamedBufferStorage(p_renderComponent.vbo, vertexSize, nullptr, flags);
-        glNamedBufferStorage(p_renderComponent.ebo, size, nullptr, flags);
-
-    }
-
-    template<typename TVertexType>
-    static void UpdateBuffersData(RenderComponent& p_renderComponent, const void* p_vertexData, const void* p_indexData, unsigned int p_vertexCount, unsigned int p_indexCount, GLintptr p_offset = 0) {
-
-        GLsizeiptr vertexSize = sizeof(TVertexType) * p_vertexCount;
-        GLsizeiptr indexSize = sizeof(unsigned int) * p_indexCount;
-
-        glNamedBufferSubData(p_renderComponent.vbo, p_offset, size, p_data);
-        glNamedBufferSubData(p_renderComponent.ebo, p_offset, size, p_data);
-    }
-
-    template<typename TVertexType>
-    static void UpdateVertexBufferData(RenderComponent& p_renderComponent, const void* p_data, unsigned int p_vertexCount, GLintptr p_offset = 0) {
-
-        GLsizeiptr size = sizeof(TVertexType) * p_vertexCount;
-
-        glNamedBufferSubData(p_renderComponent.vbo, p_offset, size, p_data);
-    }
-
-    static void UpdateIndexBufferData(RenderComponent& p_renderComponent, const void* p_data, unsigned int p_indexCount, GLintptr p_offset = 0) {
-
-        GLsizeiptr size = sizeof(unsigned int) * p_indexCount;
-
-        glNamedBufferSubData(p_renderComponent.ebo, p_offset, size, p_data);
-    }
-
-    static void SetAttributeFormats(RenderComponent& p_renderComponent, std::vector<VertexAttribute> p_attributes)
-    {
-        GLuint vao = p_renderComponent.vao;
-
-        for (const VertexAttribute& attribute : p_attributes) {
-
-            glEnableVertexArrayAttrib(vao, attribute.index);
-            glVertexArrayAttribBinding(vao, attribute.index, 0);
-            glVertexArrayAttribFormat(vao, attribute.index, attribute.size, attribute.type, GL_FALSE, attribute.offset);
-
-        }
-    }
-
-    template<typename TVertexType>
-    static void LinkBuffers(RenderComponent& p_renderComponent, unsigned int p_vertexCount)
-    {
-        GLuint vao = p_renderComponent.vao;
-
-        GLsizeiptr size = sizeof(TVertexType);
-
-        glVertexArrayVertexBuffer(vao, 0, p_renderComponent.vbo, 0, size);
-        glVertexArrayElementBuffer(vao, p_renderComponent.ebo);
-    }
-
-    static void Delete(RenderComponent& p_renderComponent)
-    {
-        glDeleteBuffers(1, &p_renderComponent.vbo);
-        glDeleteBuffers(1, &p_renderComponent.ebo);
-        glDeleteVertexArrays(1, &p_renderComponent.vao);
-
-    }
-
-}
 
 /*
 *     VBOFunctions::PreallocateBufferMemory(vbo, sizeof(BaseVertex) * 4 * numberOfCells );
@@ -193,13 +86,33 @@ int main(int argc, char** argv)
         return false;
     }
 
-    Uint64 lastStep = SDL_GetTicks();
+    //The render thread owns the GL context from here on, GL calls go through FramePacket::renderTasks
+    RenderThread renderThread;
+
+    if (!RenderThreadFunctions::Start(renderThread, window, sdlGlCtx, 1))
+    {
+        SDL_GL_DestroyContext(sdlGlCtx);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return -1;
+    }
+
+    PACO_PROFILE_THREAD_NAME("Main");
+
+    GameLoop gameLoop;
+    GameLoopFunctions::Create(gameLoop, 60, 240);
+
+    //Simulation state, kept for the last two steps so rendering can interpolate between them
+    float previousTime = 0.0f;
+    float currentTime = 0.0f;
    
     bool windowShouldClose = false;
     SDL_Event sdlEvent;
     
     while(!windowShouldClose)
     {
+        PACO_PROFILE_SCOPE("Frame");
+
         while(SDL_PollEvent(&sdlEvent))
         {
             switch (sdlEvent.window.type)
@@ -213,13 +126,35 @@ int main(int argc, char** argv)
             }
         }
 
-        glClearColor(0.0, 0.0, 0.4, 1.0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        unsigned int stepCount = GameLoopFunctions::BeginFrame(gameLoop);
+
+        for (unsigned int step = 0; step < stepCount; step++)
+        {
+            PACO_PROFILE_SCOPE("Simulation step");
+
+            previousTime = currentTime;
+            currentTime += GameLoopFunctions::GetStepSeconds(gameLoop);
+        }
+
+        float renderTime = GameLoopFunctions::Interpolate(previousTime, currentTime, GameLoopFunctions::GetInterpolationAlpha(gameLoop));
+
+        FramePacket& framePacket = RenderThreadFunctions::BeginFrame(renderThread);
 
-        SDL_GL_SwapWindow(window);
+        framePacket.clearColor[0] = 0.0f;
+        framePacket.clearColor[1] = 0.0f;
+        framePacket.clearColor[2] = 0.4f + 0.1f * std::sin(renderTime);
+        framePacket.clearColor[3] = 1.0f;
+
+        RenderThreadFunctions::EndFrame(renderThread);
+
+        GameLoopFunctions::EndFrame(gameLoop);
 
     }
 
+    RenderThreadFunctions::Stop(renderThread);
+
+    PACO_PROFILE_EXPORT("PacoEngineTrace.json");
+
 
     SDL_DestroyWindow(window);
     SDL_GL_DestroyContext(sdlGlCtx);
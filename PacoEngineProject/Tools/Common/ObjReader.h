@@ -0,0 +1,184 @@
+#pragma once
+
+//std
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
+
+//engine
+#include "Rendering/VertexPacking.h"
+
+
+//Indexed triangle mesh read from a Wavefront OBJ file, every distinct position/uv/normal triplet becomes one vertex
+struct ObjMesh
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+namespace ObjReaderFunctions
+{
+    //OBJ indices are 1 based, negative ones count back from the last element read. Returns -1 when absent.
+    static int64_t ResolveIndex(long p_index, size_t p_count)
+    {
+        if (p_index > 0)
+        {
+            return p_index - 1;
+        }
+
+        if (p_index < 0)
+        {
+            return static_cast<int64_t>(p_count) + p_index;
+        }
+
+        return -1;
+    }
+
+    //Parses "v", "v/vt", "v//vn" or "v/vt/vn", p_cursor is moved past the corner
+    static bool ParseCorner(const char*& p_cursor, long p_outIndices[3])
+    {
+        char* end = nullptr;
+
+        p_outIndices[0] = std::strtol(p_cursor, &end, 10);
+        p_outIndices[1] = 0;
+        p_outIndices[2] = 0;
+
+        if (end == p_cursor)
+        {
+            return false;
+        }
+
+        p_cursor = end;
+
+        for (unsigned int component = 1; component < 3 && *p_cursor == '/'; component++)
+        {
+            p_cursor++;
+            p_outIndices[component] = std::strtol(p_cursor, &end, 10);
+            p_cursor = end;
+        }
+
+        return true;
+    }
+
+    //Polygons are triangulated as fans, faces referencing missing elements are skipped
+    static bool Read(const char* p_path, ObjMesh& p_outMesh)
+    {
+        std::FILE* file = std::fopen(p_path, "rb");
+
+        if (file == nullptr)
+        {
+            std::fprintf(stderr, "Failed to open %s\n", p_path);
+            return false;
+        }
+
+        std::vector<float> positions;
+        std::vector<float> uvs;
+        std::vector<float> normals;
+        std::map<std::array<int64_t, 3>, uint32_t> cornerVertices;
+        std::vector<uint32_t> faceVertices;
+
+        p_outMesh = ObjMesh{};
+
+        char line[1024];
+
+        while (std::fgets(line, sizeof(line), file) != nullptr)
+        {
+            float x = 0.0f;
+            float y = 0.0f;
+            float z = 0.0f;
+
+            if (std::strncmp(line, "v ", 2) == 0 && std::sscanf(line + 2, "%f %f %f", &x, &y, &z) == 3)
+            {
+                positions.insert(positions.end(), { x, y, z });
+            }
+            else if (std::strncmp(line, "vt ", 3) == 0 && std::sscanf(line + 3, "%f %f", &x, &y) == 2)
+            {
+                uvs.insert(uvs.end(), { x, y });
+            }
+            else if (std::strncmp(line, "vn ", 3) == 0 && std::sscanf(line + 3, "%f %f %f", &x, &y, &z) == 3)
+            {
+                normals.insert(normals.end(), { x, y, z });
+            }
+            else if (std::strncmp(line, "f ", 2) == 0)
+            {
+                faceVertices.clear();
+
+                const char* cursor = line + 2;
+                bool isValid = true;
+
+                while (true)
+                {
+                    while (*cursor == ' ' || *cursor == '\t')
+                    {
+                        cursor++;
+                    }
+
+                    long corner[3];
+
+                    if (!ParseCorner(cursor, corner))
+                    {
+                        break;
+                    }
+
+                    int64_t position = ResolveIndex(corner[0], positions.size() / 3);
+                    int64_t uv = ResolveIndex(corner[1], uvs.size() / 2);
+                    int64_t normal = ResolveIndex(corner[2], normals.size() / 3);
+
+                    if (position < 0 || position >= static_cast<int64_t>(positions.size() / 3)
+                        || uv >= static_cast<int64_t>(uvs.size() / 2) || normal >= static_cast<int64_t>(normals.size() / 3))
+                    {
+                        isValid = false;
+                        break;
+                    }
+
+                    auto [existing, isNew] = cornerVertices.emplace(std::array<int64_t, 3>{ position, uv, normal }, static_cast<uint32_t>(p_outMesh.vertices.size()));
+
+                    if (isNew)
+                    {
+                        MeshVertex vertex = {};
+                        vertex.px = positions[position * 3];
+                        vertex.py = positions[position * 3 + 1];
+                        vertex.pz = positions[position * 3 + 2];
+
+                        if (uv >= 0)
+                        {
+                            vertex.u = uvs[uv * 2];
+                            vertex.v = uvs[uv * 2 + 1];
+                        }
+
+                        if (normal >= 0)
+                        {
+                            vertex.nx = normals[normal * 3];
+                            vertex.ny = normals[normal * 3 + 1];
+                            vertex.nz = normals[normal * 3 + 2];
+                        }
+
+                        vertex.r = vertex.g = vertex.b = vertex.a = 1.0f;
+
+                        p_outMesh.vertices.push_back(vertex);
+                    }
+
+                    faceVertices.push_back(existing->second);
+                }
+
+                if (!isValid || faceVertices.size() < 3)
+                {
+                    continue;
+                }
+
+                for (size_t corner = 2; corner < faceVertices.size(); corner++)
+                {
+                    p_outMesh.indices.insert(p_outMesh.indices.end(), { faceVertices[0], faceVertices[corner - 1], faceVertices[corner] });
+                }
+            }
+        }
+
+        std::fclose(file);
+
+        return !p_outMesh.indices.empty();
+    }
+}
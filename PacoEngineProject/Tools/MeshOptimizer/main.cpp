@@ -0,0 +1,166 @@
+//Optimizes OBJ meshes for the GPU : merges duplicate vertices, reorders triangles for the post-transform vertex cache,
+//optionally for overdraw, then renumbers vertices in order of first use. Prints ACMR and ATVR before and after,
+//and with --overdraw the cluster count.
+//Headless, builds on Linux with :
+//    g++ -std=c++20 -O2 -I../../PacoEngineLibrary -I../../PacoEngineLibrary/include -I.. main.cpp -o MeshOptimizer
+//Usage : MeshOptimizer [--overdraw] [--cache-size N] input.obj output.obj
+
+//std
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+//engine
+#include "Rendering/MeshOptimizer.h"
+
+//tools
+#include "Common/ObjReader.h"
+
+
+struct MeshOptimizerSettings
+{
+    const char* inputPath = nullptr;
+    const char* outputPath = nullptr;
+    bool optimizeOverdraw = false;
+    unsigned int cacheSize = PACO_MESH_OPTIMIZER_FIFO_CACHE_SIZE;
+};
+
+static bool ParseArguments(int argc, char** argv, MeshOptimizerSettings& p_outSettings)
+{
+    for (int argument = 1; argument < argc; argument++)
+    {
+        if (std::strcmp(argv[argument], "--overdraw") == 0)
+        {
+            p_outSettings.optimizeOverdraw = true;
+        }
+        else if (std::strcmp(argv[argument], "--cache-size") == 0 && argument + 1 < argc)
+        {
+            p_outSettings.cacheSize = static_cast<unsigned int>(std::strtoul(argv[++argument], nullptr, 10));
+        }
+        else if (p_outSettings.inputPath == nullptr)
+        {
+            p_outSettings.inputPath = argv[argument];
+        }
+        else if (p_outSettings.outputPath == nullptr)
+        {
+            p_outSettings.outputPath = argv[argument];
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return p_outSettings.inputPath != nullptr && p_outSettings.outputPath != nullptr && p_outSettings.cacheSize >= 3;
+}
+
+//Every vertex is written as its own position/uv/normal triplet so the vertex order survives a read back with ObjReader
+static bool WriteObj(const char* p_path, const ObjMesh& p_mesh)
+{
+    std::FILE* file = std::fopen(p_path, "wb");
+
+    if (file == nullptr)
+    {
+        std::fprintf(stderr, "Failed to create %s\n", p_path);
+        return false;
+    }
+
+    for (const MeshVertex& vertex : p_mesh.vertices)
+    {
+        std::fprintf(file, "v %.9g %.9g %.9g\n", vertex.px, vertex.py, vertex.pz);
+    }
+
+    for (const MeshVertex& vertex : p_mesh.vertices)
+    {
+        std::fprintf(file, "vt %.9g %.9g\n", vertex.u, vertex.v);
+    }
+
+    for (const MeshVertex& vertex : p_mesh.vertices)
+    {
+        std::fprintf(file, "vn %.9g %.9g %.9g\n", vertex.nx, vertex.ny, vertex.nz);
+    }
+
+    for (size_t index = 0; index + 2 < p_mesh.indices.size(); index += 3)
+    {
+        uint32_t a = p_mesh.indices[index] + 1;
+        uint32_t b = p_mesh.indices[index + 1] + 1;
+        uint32_t c = p_mesh.indices[index + 2] + 1;
+        std::fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c);
+    }
+
+    bool isWritten = std::ferror(file) == 0;
+    isWritten = std::fclose(file) == 0 && isWritten;
+
+    if (!isWritten)
+    {
+        std::fprintf(stderr, "Failed to write %s\n", p_path);
+    }
+
+    return isWritten;
+}
+
+static void PrintStats(const char* p_label, size_t p_vertexCount, const VertexCacheStats& p_stats)
+{
+    std::printf("%-10s %10zu %12u %8.3f %8.3f\n", p_label, p_vertexCount, p_stats.transformedCount, p_stats.acmr, p_stats.atvr);
+}
+
+int main(int argc, char** argv)
+{
+    using namespace MeshOptimizerFunctions;
+
+    MeshOptimizerSettings settings;
+
+    if (!ParseArguments(argc, argv, settings))
+    {
+        std::fprintf(stderr, "Usage : MeshOptimizer [--overdraw] [--cache-size N] input.obj output.obj\n");
+        return 1;
+    }
+
+    ObjMesh mesh;
+
+    if (!ObjReaderFunctions::Read(settings.inputPath, mesh))
+    {
+        std::fprintf(stderr, "No triangles read from %s\n", settings.inputPath);
+        return 1;
+    }
+
+    VertexCacheStats statsBefore = AnalyzeVertexCache(mesh.indices, mesh.vertices.size(), settings.cacheSize);
+    size_t vertexCountBefore = mesh.vertices.size();
+
+    DeduplicateVertices(mesh.vertices, mesh.indices);
+    OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+
+    size_t clusterCount = 0;
+    size_t movedTriangleCount = 0;
+
+    if (settings.optimizeOverdraw)
+    {
+        std::vector<uint32_t> cacheOrder = mesh.indices;
+        clusterCount = OptimizeOverdraw(mesh.indices, mesh.vertices.size(), [&mesh](uint32_t p_vertex) { return &mesh.vertices[p_vertex].px; }, settings.cacheSize);
+
+        for (size_t triangle = 0; triangle < cacheOrder.size() / 3; triangle++)
+        {
+            if (std::memcmp(&cacheOrder[triangle * 3], &mesh.indices[triangle * 3], sizeof(uint32_t) * 3) != 0)
+            {
+                movedTriangleCount++;
+            }
+        }
+    }
+
+    OptimizeVertexFetch(mesh.vertices, mesh.indices);
+
+    VertexCacheStats statsAfter = AnalyzeVertexCache(mesh.indices, mesh.vertices.size(), settings.cacheSize);
+
+    std::printf("%s : %zu triangles, FIFO cache of %u vertices\n", settings.inputPath, mesh.indices.size() / 3, settings.cacheSize);
+    std::printf("%-10s %10s %12s %8s %8s\n", "", "Vertices", "Transformed", "ACMR", "ATVR");
+    PrintStats("Before", vertexCountBefore, statsBefore);
+    PrintStats("After", mesh.vertices.size(), statsAfter);
+
+    if (settings.optimizeOverdraw)
+    {
+        std::printf("Overdraw : %zu clusters, %zu triangles moved from the vertex cache order\n", clusterCount, movedTriangleCount);
+    }
+
+    return WriteObj(settings.outputPath, mesh) ? 0 : 1;
+}
@@ -0,0 +1,356 @@
+//Cooks an image into a BC1 or BC3 texture with its whole mip chain, in the layout CompressedTextureFunctions::Load
+//maps and uploads without decoding. Mips are resized in linear space for sRGB images, blocks are compressed on every core.
+//Headless, builds on Linux with :
+//    g++ -std=c++20 -O2 -I../../PacoEngineLibrary -I../../PacoEngineLibrary/include -I../../../vendor/stb main.cpp -o TextureCooker -pthread
+//Usage : TextureCooker [--linear] [--bc1 | --bc3] [--threads N] input.png output.ptex
+
+//std
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//vendor
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include <stb_image_resize.h>
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+
+//engine
+#include "Rendering/CompressedTextureFormat.h"
+
+
+enum class TextureCookerBlockFormat
+{
+    //BC3 when any texel is not opaque, BC1 otherwise
+    Automatic,
+    BC1,
+    BC3,
+};
+
+struct TextureCookerSettings
+{
+    const char* inputPath = nullptr;
+    const char* outputPath = nullptr;
+
+    //Color textures are sRGB, --linear is for data such as normal maps or masks
+    bool isSrgb = true;
+    TextureCookerBlockFormat blockFormat = TextureCookerBlockFormat::Automatic;
+    unsigned int threadCount = 0;
+};
+
+//RGBA8 texels of one mip level
+struct TextureCookerImage
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> texels;
+};
+
+static bool ParseArguments(int argc, char** argv, TextureCookerSettings& p_outSettings)
+{
+    for (int argument = 1; argument < argc; argument++)
+    {
+        if (std::strcmp(argv[argument], "--linear") == 0)
+        {
+            p_outSettings.isSrgb = false;
+        }
+        else if (std::strcmp(argv[argument], "--bc1") == 0)
+        {
+            p_outSettings.blockFormat = TextureCookerBlockFormat::BC1;
+        }
+        else if (std::strcmp(argv[argument], "--bc3") == 0)
+        {
+            p_outSettings.blockFormat = TextureCookerBlockFormat::BC3;
+        }
+        else if (std::strcmp(argv[argument], "--threads") == 0 && argument + 1 < argc)
+        {
+            p_outSettings.threadCount = static_cast<unsigned int>(std::strtoul(argv[++argument], nullptr, 10));
+        }
+        else if (p_outSettings.inputPath == nullptr)
+        {
+            p_outSettings.inputPath = argv[argument];
+        }
+        else if (p_outSettings.outputPath == nullptr)
+        {
+            p_outSettings.outputPath = argv[argument];
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return p_outSettings.inputPath != nullptr && p_outSettings.outputPath != nullptr;
+}
+
+static bool HasTranslucentTexel(const TextureCookerImage& p_image)
+{
+    for (size_t texel = 3; texel < p_image.texels.size(); texel += 4)
+    {
+        if (p_image.texels[texel] != 255)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//Every level is resized from the full image rather than from the previous level, so errors do not accumulate down the chain.
+//Alpha weights the color filtering, transparent texels do not bleed their color into the lower levels.
+static bool BuildMipChain(const TextureCookerImage& p_image, bool p_isSrgb, std::vector<TextureCookerImage>& p_outLevels)
+{
+    p_outLevels.push_back(p_image);
+
+    while (p_outLevels.back().width > 1 || p_outLevels.back().height > 1)
+    {
+        const TextureCookerImage& previous = p_outLevels.back();
+
+        TextureCookerImage level;
+        level.width = previous.width > 1 ? previous.width / 2 : 1;
+        level.height = previous.height > 1 ? previous.height / 2 : 1;
+        level.texels.resize(static_cast<size_t>(level.width) * level.height * 4);
+
+        int isResized = p_isSrgb
+            ? stbir_resize_uint8_srgb(p_image.texels.data(), static_cast<int>(p_image.width), static_cast<int>(p_image.height), 0,
+                level.texels.data(), static_cast<int>(level.width), static_cast<int>(level.height), 0, 4, 3, 0)
+            : stbir_resize_uint8_generic(p_image.texels.data(), static_cast<int>(p_image.width), static_cast<int>(p_image.height), 0,
+                level.texels.data(), static_cast<int>(level.width), static_cast<int>(level.height), 0, 4, 3, 0,
+                STBIR_EDGE_CLAMP, STBIR_FILTER_DEFAULT, STBIR_COLORSPACE_LINEAR, nullptr);
+
+        if (isResized == 0)
+        {
+            return false;
+        }
+
+        p_outLevels.push_back(std::move(level));
+    }
+
+    return true;
+}
+
+//Reads the 4x4 block at p_blockX, p_blockY, texels past the edge of small levels repeat the last row and column
+static void ReadBlock(const TextureCookerImage& p_image, uint32_t p_blockX, uint32_t p_blockY, uint8_t* p_outBlock)
+{
+    for (uint32_t y = 0; y < 4; y++)
+    {
+        uint32_t sourceY = p_blockY * 4 + y < p_image.height ? p_blockY * 4 + y : p_image.height - 1;
+
+        for (uint32_t x = 0; x < 4; x++)
+        {
+            uint32_t sourceX = p_blockX * 4 + x < p_image.width ? p_blockX * 4 + x : p_image.width - 1;
+            std::memcpy(p_outBlock + (y * 4 + x) * 4, &p_image.texels[(static_cast<size_t>(sourceY) * p_image.width + sourceX) * 4], 4);
+        }
+    }
+}
+
+//Block rows of every level are shared between the threads, the small levels finish in the shadow of the large ones
+static void CompressLevels(const std::vector<TextureCookerImage>& p_levels, uint32_t p_format, unsigned int p_threadCount, std::vector<std::vector<uint8_t>>& p_outLevelData)
+{
+    struct BlockRow
+    {
+        uint32_t level;
+        uint32_t blockY;
+    };
+
+    std::vector<BlockRow> blockRows;
+    p_outLevelData.resize(p_levels.size());
+
+    for (uint32_t level = 0; level < p_levels.size(); level++)
+    {
+        p_outLevelData[level].resize(CompressedTextureFormatFunctions::GetLevelSize(p_format, p_levels[level].width, p_levels[level].height));
+
+        for (uint32_t blockY = 0; blockY < (p_levels[level].height + 3) / 4; blockY++)
+        {
+            blockRows.push_back({ level, blockY });
+        }
+    }
+
+    const uint32_t blockSize = CompressedTextureFormatFunctions::GetBlockSize(p_format);
+    const int hasAlpha = blockSize == 16 ? 1 : 0;
+    std::atomic<size_t> nextBlockRow = 0;
+
+    auto compress = [&]()
+    {
+        uint8_t block[64];
+
+        for (size_t row = nextBlockRow++; row < blockRows.size(); row = nextBlockRow++)
+        {
+            const TextureCookerImage& image = p_levels[blockRows[row].level];
+            const uint32_t blocksPerRow = (image.width + 3) / 4;
+            uint8_t* destination = p_outLevelData[blockRows[row].level].data() + static_cast<size_t>(blockRows[row].blockY) * blocksPerRow * blockSize;
+
+            for (uint32_t blockX = 0; blockX < blocksPerRow; blockX++)
+            {
+                ReadBlock(image, blockX, blockRows[row].blockY, block);
+                stb_compress_dxt_block(destination + static_cast<size_t>(blockX) * blockSize, block, hasAlpha, STB_DXT_HIGHQUAL);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (unsigned int thread = 1; thread < p_threadCount; thread++)
+    {
+        threads.emplace_back(compress);
+    }
+
+    compress();
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+static bool WriteTexture(const char* p_path, uint32_t p_format, const std::vector<TextureCookerImage>& p_levels, const std::vector<std::vector<uint8_t>>& p_levelData, uint64_t& p_outFileSize)
+{
+    using namespace CompressedTextureFormatFunctions;
+
+    CompressedTextureHeader header;
+    header.magic = magic;
+    header.version = version;
+    header.format = p_format;
+    header.width = p_levels[0].width;
+    header.height = p_levels[0].height;
+    header.levelCount = static_cast<uint32_t>(p_levels.size());
+
+    std::vector<CompressedTextureLevel> levels(p_levels.size());
+    uint64_t offset = sizeof(CompressedTextureHeader) + sizeof(CompressedTextureLevel) * levels.size();
+
+    for (size_t level = 0; level < levels.size(); level++)
+    {
+        offset = (offset + dataAlignment - 1) / dataAlignment * dataAlignment;
+        levels[level].offset = offset;
+        levels[level].size = p_levelData[level].size();
+        levels[level].width = p_levels[level].width;
+        levels[level].height = p_levels[level].height;
+        offset += levels[level].size;
+    }
+
+    std::FILE* file = std::fopen(p_path, "wb");
+
+    if (file == nullptr)
+    {
+        std::fprintf(stderr, "Failed to create %s\n", p_path);
+        return false;
+    }
+
+    const uint8_t padding[dataAlignment] = {};
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fwrite(levels.data(), sizeof(CompressedTextureLevel), levels.size(), file);
+
+    for (size_t level = 0; level < levels.size(); level++)
+    {
+        std::fwrite(padding, 1, static_cast<size_t>(levels[level].offset - std::ftell(file)), file);
+        std::fwrite(p_levelData[level].data(), 1, p_levelData[level].size(), file);
+    }
+
+    bool isWritten = std::ferror(file) == 0;
+    isWritten = std::fclose(file) == 0 && isWritten;
+
+    if (!isWritten)
+    {
+        std::fprintf(stderr, "Failed to write %s\n", p_path);
+    }
+
+    p_outFileSize = offset;
+
+    return isWritten;
+}
+
+static const char* GetFormatName(uint32_t p_format)
+{
+    switch (p_format)
+    {
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        return "BC1";
+    case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        return "BC1 sRGB";
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        return "BC3";
+    default:
+        return "BC3 sRGB";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    TextureCookerSettings settings;
+
+    if (!ParseArguments(argc, argv, settings))
+    {
+        std::fprintf(stderr, "Usage : TextureCooker [--linear] [--bc1 | --bc3] [--threads N] input.png output.ptex\n");
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    int width = 0;
+    int height = 0;
+    int channelCount = 0;
+    stbi_uc* pixels = stbi_load(settings.inputPath, &width, &height, &channelCount, 4);
+
+    if (pixels == nullptr)
+    {
+        std::fprintf(stderr, "Failed to read %s : %s\n", settings.inputPath, stbi_failure_reason());
+        return 1;
+    }
+
+    TextureCookerImage image;
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    image.texels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+
+    bool isBC3 = settings.blockFormat == TextureCookerBlockFormat::BC3
+        || (settings.blockFormat == TextureCookerBlockFormat::Automatic && HasTranslucentTexel(image));
+
+    uint32_t format = isBC3
+        ? (settings.isSrgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+        : (settings.isSrgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+
+    std::vector<TextureCookerImage> levels;
+
+    if (!BuildMipChain(image, settings.isSrgb, levels))
+    {
+        std::fprintf(stderr, "Failed to build the mip chain of %s\n", settings.inputPath);
+        return 1;
+    }
+
+    unsigned int threadCount = settings.threadCount > 0 ? settings.threadCount : std::thread::hardware_concurrency();
+    threadCount = threadCount > 0 ? threadCount : 1;
+
+    std::vector<std::vector<uint8_t>> levelData;
+    CompressLevels(levels, format, threadCount, levelData);
+
+    uint64_t fileSize = 0;
+
+    if (!WriteTexture(settings.outputPath, format, levels, levelData, fileSize))
+    {
+        return 1;
+    }
+
+    uint64_t uncompressedSize = 0;
+
+    for (const TextureCookerImage& level : levels)
+    {
+        uncompressedSize += level.texels.size();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%s : %ux%u, %zu levels, %s\n", settings.outputPath, image.width, image.height, levels.size(), GetFormatName(format));
+    std::printf("%llu bytes, %.2f%% of the %llu bytes of RGBA8 levels, cooked in %.3f s on %u threads\n",
+        static_cast<unsigned long long>(fileSize), 100.0 * static_cast<double>(fileSize) / static_cast<double>(uncompressedSize),
+        static_cast<unsigned long long>(uncompressedSize), seconds, threadCount);
+
+    return 0;
+}
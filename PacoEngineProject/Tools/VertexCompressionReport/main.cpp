@@ -0,0 +1,134 @@
+//Reports how much vertex memory PackedMeshVertex saves over MeshVertex for OBJ meshes, and the precision lost doing so.
+//Headless, builds on Linux with :
+//    g++ -std=c++20 -O2 -I../../PacoEngineLibrary -I../../PacoEngineLibrary/include -I.. main.cpp -o VertexCompressionReport
+//Usage : VertexCompressionReport mesh.obj [mesh.obj ...]
+
+//std
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+//engine
+#include "Rendering/VertexPacking.h"
+
+//tools
+#include "Common/ObjReader.h"
+
+
+struct CompressionReport
+{
+    size_t vertexCount = 0;
+    size_t floatBytes = 0;
+    size_t packedBytes = 0;
+
+    //Largest position error relative to the mesh extent
+    float maxPositionError = 0.0f;
+
+    float maxNormalErrorDegrees = 0.0f;
+    float maxUvError = 0.0f;
+
+    //UVs outside [0, 1] are clamped by the unorm16 encoding, the mesh needs its UVs remapped first
+    size_t clampedUvCount = 0;
+};
+
+static float Length(float p_x, float p_y, float p_z)
+{
+    return std::sqrt(p_x * p_x + p_y * p_y + p_z * p_z);
+}
+
+static CompressionReport BuildReport(const ObjMesh& p_mesh)
+{
+    using namespace VertexPackingFunctions;
+
+    CompressionReport report;
+    report.vertexCount = p_mesh.vertices.size();
+    report.floatBytes = sizeof(MeshVertex) * report.vertexCount;
+    report.packedBytes = sizeof(PackedMeshVertex) * report.vertexCount;
+
+    float extent = 0.0f;
+
+    for (const MeshVertex& vertex : p_mesh.vertices)
+    {
+        extent = std::fmax(extent, std::fmax(std::fabs(vertex.px), std::fmax(std::fabs(vertex.py), std::fabs(vertex.pz))));
+    }
+
+    for (const MeshVertex& vertex : p_mesh.vertices)
+    {
+        PackedMeshVertex packed = Pack(vertex);
+
+        float positionError = Length(HalfToFloat(packed.position[0]) - vertex.px, HalfToFloat(packed.position[1]) - vertex.py, HalfToFloat(packed.position[2]) - vertex.pz);
+        report.maxPositionError = std::fmax(report.maxPositionError, extent > 0.0f ? positionError / extent : positionError);
+
+        float normalLength = Length(vertex.nx, vertex.ny, vertex.nz);
+
+        if (normalLength > 0.0f)
+        {
+            float nx = UnpackSnorm2101010Rev(packed.normal, 0);
+            float ny = UnpackSnorm2101010Rev(packed.normal, 1);
+            float nz = UnpackSnorm2101010Rev(packed.normal, 2);
+            float packedLength = Length(nx, ny, nz);
+
+            if (packedLength > 0.0f)
+            {
+                float cosine = (nx * vertex.nx + ny * vertex.ny + nz * vertex.nz) / (packedLength * normalLength);
+                float degrees = std::acos(std::fmin(1.0f, std::fmax(-1.0f, cosine))) * 57.2957795f;
+                report.maxNormalErrorDegrees = std::fmax(report.maxNormalErrorDegrees, degrees);
+            }
+        }
+
+        if (vertex.u < 0.0f || vertex.u > 1.0f || vertex.v < 0.0f || vertex.v > 1.0f)
+        {
+            report.clampedUvCount++;
+            continue;
+        }
+
+        float uError = std::fabs(packed.uv[0] / 65535.0f - vertex.u);
+        float vError = std::fabs(packed.uv[1] / 65535.0f - vertex.v);
+        report.maxUvError = std::fmax(report.maxUvError, std::fmax(uError, vError));
+    }
+
+    return report;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage : VertexCompressionReport mesh.obj [mesh.obj ...]\n");
+        return 1;
+    }
+
+    std::printf("%-32s %10s %12s %12s %8s %12s %10s %10s %10s\n", "Mesh", "Vertices", "Float (B)", "Packed (B)", "Saved", "Pos err", "Nrm (deg)", "UV err", "UV clamp");
+
+    size_t totalFloatBytes = 0;
+    size_t totalPackedBytes = 0;
+    int failedCount = 0;
+
+    for (int argument = 1; argument < argc; argument++)
+    {
+        ObjMesh mesh;
+
+        if (!ObjReaderFunctions::Read(argv[argument], mesh))
+        {
+            std::fprintf(stderr, "Skipping %s : no triangles read\n", argv[argument]);
+            failedCount++;
+            continue;
+        }
+
+        CompressionReport report = BuildReport(mesh);
+        totalFloatBytes += report.floatBytes;
+        totalPackedBytes += report.packedBytes;
+
+        std::printf("%-32s %10zu %12zu %12zu %7.1f%% %12.2e %10.3f %10.2e %10zu\n", argv[argument], report.vertexCount, report.floatBytes, report.packedBytes,
+            100.0 * (1.0 - static_cast<double>(report.packedBytes) / static_cast<double>(report.floatBytes)),
+            report.maxPositionError, report.maxNormalErrorDegrees, report.maxUvError, report.clampedUvCount);
+    }
+
+    if (totalFloatBytes > 0)
+    {
+        std::printf("%-32s %10s %12zu %12zu %7.1f%%\n", "Total", "", totalFloatBytes, totalPackedBytes,
+            100.0 * (1.0 - static_cast<double>(totalPackedBytes) / static_cast<double>(totalFloatBytes)));
+    }
+
+    return failedCount == 0 ? 0 : 1;
+}